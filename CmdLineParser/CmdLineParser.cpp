@@ -140,6 +140,8 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
     printf("\n");
     printf("Available options:\n");
     printf("  -?                    display usage information\n");
+    printf("  -A<plugin>[,<params>] generate the offsets and read/write mix with an access pattern plugin DLL instead of\n");
+    printf("                          -r/-s/-w, passing it <params>. See AccessPatternPlugin.h for the interface\n");
     printf("  -ag                   group affinity - affinitize threads round-robin to cores in Processor Groups 0 - n.\n");
     printf("                          Group 0 is filled before Group 1, and so forth.\n");
     printf("                          [default; use -n to disable default affinity]\n");
@@ -151,6 +153,12 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
     printf("                                    -ag0,0,1,2,g1,0,1,2 specifies the first three cores in groups 0 and 1.\n");
     printf("                                    -ag0,0,1,2 -ag1,0,1,2 is equivalent.\n");
     printf("  -b<size>[K|M|G]       block size in bytes or KiB/MiB/GiB [default=64K]\n");
+    printf("  -bd[r|w]<size>:<weight>[,<size>:<weight>...]\n");
+    printf("                        weighted block size distribution; each IO picks a size with probability\n");
+    printf("                          weight / sum(weights). -bdr and -bdw set separate read and write distributions,\n");
+    printf("                          an IO type without a distribution uses -b. Buffers are sized to the largest block.\n");
+    printf("                          Latency percentiles are also reported per block size when -L is used.\n");
+    printf("                          Example: -bd4K:60,64K:30,1M:10\n");
     printf("  -B<offs>[K|M|G|b]     base target offset in bytes or KiB/MiB/GiB/blocks [default=0]\n");
     printf("                          (offset from the beginning of the file)\n");
     printf("  -BL#,#[,#,...]        List of fixed histogram bucket latencies\n");
@@ -174,11 +182,27 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
     printf("                          note that this can not be specified when using completion routines\n");
     printf("                          [default inactive]\n"); 
     printf("  -h                    deprecated, see -Sh\n");
+    printf("  -H                    split each thread into a submitter and a completion reaper pinned to another core;\n");
+    printf("                          the reaper accounts for completed I/Os and hands them back to the submitter through\n");
+    printf("                          a lock-free ring. uses I/O completion ports, also for a single outstanding I/O\n");
+    printf("  -Hp<count>            share one I/O completion port between all threads, drained by a pool of <count>\n");
+    printf("                          threads pinned to other cores. I/O is still accounted to the thread which issued it\n");
     printf("  -i<count>             number of IOs per burst; see -j [default: inactive]\n");
     printf("  -j<milliseconds>      interval in <milliseconds> between issuing IO bursts; see -i [default: inactive]\n");
     printf("  -I<priority>          Set IO priority to <priority>. Available values are: 1-very low, 2-low, 3-normal (default)\n");
+    printf("  -k<count>             lookahead: each thread pregenerates the offsets (random I/O only), I/O types and sizes\n");
+    printf("                          of the next <count> I/Os per target, and the targets picked with -O, in batches\n");
+    printf("  -kd<filepath>         append the pregenerated offsets, I/O types and sizes to <filepath> as CSV, for debugging\n");
     printf("  -l                    Use large pages for IO buffers\n");
     printf("  -L                    measure latency statistics\n");
+    printf("  -M                    metadata workload: the target is a directory, under which each thread builds a tree\n");
+    printf("                          of its own and runs a weighted mix of create, open/close, stat, rename and unlink\n");
+    printf("                          on its files instead of data I/O. operations are synchronous and timed per kind;\n");
+    printf("                          the tree is removed at the end of the run. all targets of a time span must use -M\n");
+    printf("  -Mf<count>            with -M, subdirectories of each directory above the bottom of the tree [default=4]\n");
+    printf("  -Md<count>            with -M, levels of subdirectories [default=2]\n");
+    printf("  -Mn<count>            with -M, files in each directory at the bottom of the tree [default=64]\n");
+    printf("  -Mw<c>:<o>:<s>:<r>:<u> with -M, weights of create, open/close, stat, rename and unlink [default=1:1:1:1:1]\n");
     printf("  -n                    disable default affinity (-a)\n");
     printf("  -N<vni>               specify the flush mode for memory mapped I/O\n");
     printf("                          v : uses the FlushViewOfFile API\n");
@@ -194,7 +218,30 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
     printf("                          (ignored if -r is specified, makes sense only with -o2 or greater)\n");
     printf("  -P<count>             enable printing a progress dot after each <count> [default=65536]\n");
     printf("                          completed I/O operations, counted separately by each thread \n");
+    printf("  -q<count>             batch asynchronous I/O: hand all ready I/Os to the system together (I/O rings)\n");
+    printf("                          and reap up to <count> completions per call [default=1]. the average batch sizes\n");
+    printf("                          achieved are reported per thread\n");
+    printf("  -Q                    poll for I/O completions instead of waiting for them; each thread spins on its\n");
+    printf("                          outstanding I/O (or its I/O ring with -xr), trading CPU for completion latency.\n");
+    printf("                          also applies to a single outstanding I/O. requires unbuffered I/O (-Su or -Sh)\n");
     printf("  -r<align>[K|M|G|b]    random I/O aligned to <align> in bytes/KiB/MiB/GiB/blocks (overrides -s)\n");
+    printf("  -rs<pct>[:<run>[-<max run>]] mixed random/sequential I/O: <pct>%% of the I/O is random (implies -r), the rest\n");
+    printf("                          continues sequentially from the preceding I/O. sequential runs are <run> to <max run>\n");
+    printf("                          I/Os long [default=1, giving geometric run lengths]. Example: -rs20:8-64\n");
+    printf("  -rp                   random I/O without replacement, used with -r: each aligned offset is visited once per pass\n");
+    printf("                          in a pseudo-random order reproducible with -z; threads sharing a target split each pass\n");
+    printf("  -rd<distribution>     skewed distribution of random I/O offsets, used with -r [default=uniform]\n");
+    printf("                          -rdpct<io%%>/<target%%>[:<io%%>/<target%%>...] hot/cold ranges from the start of the target;\n");
+    printf("                            IO not covered by the ranges goes to the rest of the target\n");
+    printf("                            Example: -rdpct90/10 sends 90%% of the I/O to the first 10%% of the target\n");
+    printf("                          -rdabs<io%%>/<size>[K|M|G|b][:...] as -rdpct, with the ranges sized in bytes/KiB/MiB/GiB/blocks\n");
+    printf("                            Example: -rdabs90/10G:10/100G\n");
+    printf("                          -rdzipf<theta>       Zipf distribution over the blocks, 0 < theta < 1 (e.g. -rdzipf0.99)\n");
+    printf("                          -rdpareto<target%%>   (100-target%%) of the I/O to the first target%% (e.g. -rdpareto20)\n");
+    printf("                          -rdnormal<center%%>/<stddev%%> normal distribution around a point in the target,\n");
+    printf("                            truncated to the target (e.g. -rdnormal50/10)\n");
+    printf("  -rdmove<size>[K|M|G|b] move the -rd distribution forward by <size> per second, wrapping around the end of the\n");
+    printf("                          target, so its hot ranges drift across the target over time (e.g. -rdpct90/5 -rdmove64M)\n");
     printf("  -R<text|xml>          output format. Default is text.\n");
     printf("  -RF<filepath>         output file path.  Default is StdOut.\n");
     printf("  -s[i]<size>[K|M|G|b]  sequential stride size, offset between subsequent I/O operations\n");
@@ -204,6 +251,10 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
     printf("                          manipulate a shared offset with InterlockedIncrement, which may reduce throughput,\n");
     printf("                          but promotes a more sequential pattern.\n");
     printf("                          (ignored if -r specified, -si conflicts with -T and -p)\n");
+    printf("  -sn<count>            <count> interleaved sequential streams per thread, spread evenly over the target\n");
+    printf("  -sr                   reverse sequential I/O, scanning backward from the end of the target\n");
+    printf("  -sk<read>/<skip>      read <read> strides, then skip <skip> strides. Example: -sk4/12\n");
+    printf("                          (-sn, -sr and -sk may be combined; they conflict with -r, -si and -p)\n");
     printf("  -S[bhmruw]            control caching behavior [default: caching is enabled, no writethrough]\n");
     printf("                          non-conflicting flags may be combined in any order; ex: -Sbw, -Suw, -Swu\n");
     printf("  -S                    equivalent to -Su\n");
@@ -222,9 +273,46 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
     printf("  -w<percentage>        percentage of write requests (-w and -w0 are equivalent and result in a read-only workload).\n");
     printf("                        absence of this switch indicates 100%% reads\n");
     printf("                          IMPORTANT: a write test will destroy existing data without a warning\n");
+    printf("  -wt<percentage>       percentage of trim operations, which discard the block: file-level trim on files,\n");
+    printf("                          DSM trim on disks and partitions. trims and write-zeroes are taken from the reads;\n");
+    printf("                          -w, -wt and -wz must add up to at most 100. their sizes follow the write block sizes\n");
+    printf("  -wz<percentage>       percentage of write-zeroes operations, which zero the block without transferring\n");
+    printf("                          data (FSCTL_SET_ZERO_DATA; files only)\n");
+    printf("  -wd<percentage>       percentage of the writes issued as durable, through a second handle to the target\n");
+    printf("                          opened for write through (FILE_FLAG_WRITE_THROUGH)\n");
+    printf("  -wf<count>            each thread flushes the target (FlushFileBuffers) after every <count> of its I/Os to it\n");
+    printf("  -wft<milliseconds>    each thread flushes the target every <milliseconds>, ahead of its next I/O to it\n");
+    printf("  -wfp<percentage>      each thread flushes the target ahead of <percentage> of its I/Os to it\n");
+    printf("                          flushes are synchronous and timed on their own; -wf, -wft and -wfp are exclusive\n");
+    printf("  -wfd                  flush only the data and the metadata needed to read it back (files only)\n");
+    printf("  -wa                   append: write at the tail of the target, which is emptied at the start of the run\n");
+    printf("                          and grows with the writes; requires -w100 and sequential access (files only)\n");
+    printf("  -wap<size>[K|M|G|b]   with -wa, allocate space ahead of the tail in chunks of <size>\n");
+    printf("  -was<size>[K|M|G|b]   with -wa, roll over to a new segment file once the current one reaches <size>;\n");
+    printf("                          segments after the first are named <target>.1, <target>.2, ...\n");
+    printf("  -wg<count>            group commit: each thread writes a log for <count> committers, which queue records;\n");
+    printf("                          the queued records go out as one write, which is flushed before the committers\n");
+    printf("                          are released. requires -w100; commit latency is reported apart from the I/O\n");
+    printf("  -wgr<size>[K|M|G|b]   with -wg, size of a commit record [default=4K]; a group holds up to a block of them.\n");
+    printf("                          with -Su or -Sh, must be a multiple of the sector size\n");
+    printf("  -wgt<microseconds>    with -wg, time a committer waits after its release before queueing its next record.\n");
+    printf("                          with no I/O in flight, a thread waits in whole milliseconds, rounded up, unless\n");
+    printf("                          it polls (-Yp), in which case it spins out the think time\n");
     printf("  -W<seconds>           warm up time - duration of the test before measurements start [default=5s]\n");
     printf("  -x                    use completion routines instead of I/O Completion Ports\n");
+    printf("  -xe                   use per-I/O events instead of I/O Completion Ports; also applies to a single\n");
+    printf("                          outstanding I/O. at most 64 outstanding I/Os per thread\n");
+    printf("  -xr                   use I/O rings (IoRing API) instead of I/O Completion Ports; also applies to\n");
+    printf("                          a single outstanding I/O. requires a version of Windows supporting IoRing writes\n");
+    printf("  -xrp                  use I/O rings with a submission poller: each thread hands its I/O to a dedicated\n");
+    printf("                          thread which spins submitting it to the ring. pollers are affinitized after the\n");
+    printf("                          worker threads in the same order (-a or round robin); their CPU use is reported\n");
     printf("  -X<filepath>          use an XML file for configuring the workload. Cannot be used with other parameters.\n");
+    printf("  -Y<b|p|s>[us]         how threads wait for I/O completions [default: block with a 1ms timeout]\n");
+    printf("                          -Yb: block in the kernel until the next completion\n");
+    printf("                          -Yp: busy-poll for completions; never blocks, and also spins out throughput (-g) delays\n");
+    printf("                          -Ys[us]: spin for up to [us] microseconds, then block [default=50]\n");
+    printf("                          the CPU used by each thread is reported alongside latency\n");
     printf("  -z[seed]              set random seed [with no -z, seed=0; with plain -z, seed is based on system run time]\n");
     printf("\n");
     printf("Write buffers:\n");
@@ -528,6 +616,300 @@ bool CmdLineParser::_ParseHistogramBucketList(const char* arg, Profile* pProfile
     return fOk;
 }
 
+// Parses -bd[r|w]<size>:<weight>[,<size>:<weight>...]; without r/w the distribution applies to reads and writes
+bool CmdLineParser::_ParseBlockSizeDistribution(const char *arg, vector<Target>& vTargets)
+{
+    bool fOk = true;
+    bool fRead = true;
+    bool fWrite = true;
+
+    if (*arg == 'r')
+    {
+        fWrite = false;
+        arg++;
+    }
+    else if (*arg == 'w')
+    {
+        fRead = false;
+        arg++;
+    }
+
+    vector<BlockSizeWeight> vBlockSizes;
+    string sArg(arg);
+    size_t iStart = 0;
+
+    while (fOk && iStart <= sArg.length())
+    {
+        size_t iComma = sArg.find(',', iStart);
+        if (iComma == sArg.npos)
+        {
+            iComma = sArg.length();
+        }
+
+        string sEntry = sArg.substr(iStart, iComma - iStart);
+        size_t iColon = sEntry.find(':');
+        UINT64 cb = 0;
+
+        if (iColon == sEntry.npos ||
+            iColon + 1 == sEntry.length() ||
+            sEntry.find_first_not_of("0123456789", iColon + 1) != sEntry.npos ||
+            !_GetSizeInBytes(sEntry.substr(0, iColon).c_str(), cb) ||
+            cb == 0 || cb > MAXDWORD)
+        {
+            fprintf(stderr, "ERROR: invalid block size distribution entry '%s' passed to -bd\n", sEntry.c_str());
+            fOk = false;
+        }
+        else
+        {
+            vBlockSizes.emplace_back((DWORD)cb, (UINT32)strtoul(sEntry.c_str() + iColon + 1, nullptr, 10));
+        }
+
+        iStart = iComma + 1;
+    }
+
+    if (fOk)
+    {
+        for (auto& target : vTargets)
+        {
+            for (const auto& blockSize : vBlockSizes)
+            {
+                if (fRead)
+                {
+                    target.AddBlockSizeWeight(IOOperation::ReadIO, blockSize.dwBlockSize, blockSize.ulWeight);
+                }
+                if (fWrite)
+                {
+                    target.AddBlockSizeWeight(IOOperation::WriteIO, blockSize.dwBlockSize, blockSize.ulWeight);
+                }
+            }
+        }
+    }
+
+    return fOk;
+}
+
+// Parses the random offset distributions:
+//   -rdpct<io%>/<target%>[:<io%>/<target%>...]
+//   -rdabs<io%>/<size>[K|M|G|b][:<io%>/<size>[K|M|G|b]...]
+//   -rdmove<size>[K|M|G|b], per second; applies to the distribution given separately
+//   -rdzipf<theta>
+//   -rdpareto<hot target%>
+//   -rdnormal<center%>/<stddev%>
+bool CmdLineParser::_ParseRandomDistribution(const char *arg, vector<Target>& vTargets)
+{
+    bool fOk = true;
+    char *pszEnd = nullptr;
+    DistributionType distributionType = DistributionType::Uniform;
+    vector<DistributionRange> vRanges;
+    double lfZipfTheta = 0;
+    UINT32 ulParetoHotPercent = 0;
+    double lfNormalCenter = 0;
+    double lfNormalStdDev = 0;
+
+    if (strncmp(arg, "pct", 3) == 0)
+    {
+        distributionType = DistributionType::Percent;
+        const char *psz = arg + 3;
+        while (fOk)
+        {
+            UINT32 ulIoPercent = strtoul(psz, &pszEnd, 10);
+            fOk = (pszEnd != psz) && (*pszEnd == '/');
+            if (fOk)
+            {
+                psz = pszEnd + 1;
+                UINT32 ulTargetPercent = strtoul(psz, &pszEnd, 10);
+                fOk = (pszEnd != psz) && (*pszEnd == ':' || *pszEnd == '\0');
+                if (fOk)
+                {
+                    vRanges.emplace_back(ulIoPercent, ulTargetPercent);
+                    if (*pszEnd == '\0')
+                    {
+                        break;
+                    }
+                    psz = pszEnd + 1;
+                }
+            }
+        }
+    }
+    else if (strncmp(arg, "abs", 3) == 0)
+    {
+        distributionType = DistributionType::Absolute;
+        const char *psz = arg + 3;
+        while (fOk)
+        {
+            UINT32 ulIoPercent = strtoul(psz, &pszEnd, 10);
+            fOk = (pszEnd != psz) && (*pszEnd == '/');
+            if (fOk)
+            {
+                psz = pszEnd + 1;
+                const char *pszColon = strchr(psz, ':');
+                string sSize = (pszColon != nullptr) ? string(psz, pszColon - psz) : string(psz);
+                UINT64 ullTargetBytes;
+                fOk = _GetSizeInBytes(sSize.c_str(), ullTargetBytes) && !sSize.empty();
+                if (fOk)
+                {
+                    vRanges.emplace_back(ulIoPercent, 0, ullTargetBytes);
+                    if (pszColon == nullptr)
+                    {
+                        break;
+                    }
+                    psz = pszColon + 1;
+                }
+            }
+        }
+    }
+    else if (strncmp(arg, "move", 4) == 0)
+    {
+        // moves whichever distribution is given, so it does not change the distribution type
+        UINT64 ullDrift;
+        fOk = (*(arg + 4) != '\0') && _GetSizeInBytes(arg + 4, ullDrift);
+        if (fOk)
+        {
+            for (auto& target : vTargets)
+            {
+                target.SetDistributionDrift(ullDrift);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: invalid rate passed to -rdmove\n");
+        }
+        return fOk;
+    }
+    else if (strncmp(arg, "zipf", 4) == 0)
+    {
+        distributionType = DistributionType::Zipf;
+        lfZipfTheta = strtod(arg + 4, &pszEnd);
+        fOk = (pszEnd != arg + 4) && (*pszEnd == '\0');
+    }
+    else if (strncmp(arg, "pareto", 6) == 0)
+    {
+        distributionType = DistributionType::Pareto;
+        ulParetoHotPercent = strtoul(arg + 6, &pszEnd, 10);
+        fOk = (pszEnd != arg + 6) && (*pszEnd == '\0');
+    }
+    else if (strncmp(arg, "normal", 6) == 0)
+    {
+        distributionType = DistributionType::Normal;
+        lfNormalCenter = strtod(arg + 6, &pszEnd);
+        fOk = (pszEnd != arg + 6) && (*pszEnd == '/');
+        if (fOk)
+        {
+            const char *psz = pszEnd + 1;
+            lfNormalStdDev = strtod(psz, &pszEnd);
+            fOk = (pszEnd != psz) && (*pszEnd == '\0');
+        }
+    }
+    else
+    {
+        fOk = false;
+    }
+
+    if (fOk)
+    {
+        for (auto& target : vTargets)
+        {
+            target.SetRandomDistribution(distributionType);
+            for (const auto& range : vRanges)
+            {
+                if (distributionType == DistributionType::Absolute)
+                {
+                    target.AddDistributionRangeInBytes(range.ulIoPercent, range.ullTargetBytes);
+                }
+                else
+                {
+                    target.AddDistributionRange(range.ulIoPercent, range.ulTargetPercent);
+                }
+            }
+            target.SetZipfTheta(lfZipfTheta);
+            target.SetParetoHotPercent(ulParetoHotPercent);
+            target.SetNormalCenterPercent(lfNormalCenter);
+            target.SetNormalStdDevPercent(lfNormalStdDev);
+        }
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: invalid random distribution passed to -rd\n");
+    }
+
+    return fOk;
+}
+
+// Parses the mixed random/sequential ratio, implying random access at the current alignment:
+//   -rs<random%>[:<run>[-<max run>]]
+bool CmdLineParser::_ParseRandomRatio(const char *arg, vector<Target>& vTargets)
+{
+    char *pszEnd = nullptr;
+    UINT32 ulRandomRatio = strtoul(arg, &pszEnd, 10);
+    UINT32 ulMinRun = 1;
+    UINT32 ulMaxRun = 1;
+    bool fOk = (pszEnd != arg) && (*pszEnd == ':' || *pszEnd == '\0');
+
+    if (fOk && *pszEnd == ':')
+    {
+        const char *psz = pszEnd + 1;
+        ulMinRun = strtoul(psz, &pszEnd, 10);
+        ulMaxRun = ulMinRun;
+        fOk = (pszEnd != psz) && (*pszEnd == '-' || *pszEnd == '\0');
+
+        if (fOk && *pszEnd == '-')
+        {
+            psz = pszEnd + 1;
+            ulMaxRun = strtoul(psz, &pszEnd, 10);
+            fOk = (pszEnd != psz) && (*pszEnd == '\0');
+        }
+    }
+
+    if (fOk)
+    {
+        for (auto& target : vTargets)
+        {
+            target.SetUseRandomAccessPattern(true);
+            target.SetRandomRatio(ulRandomRatio);
+            target.SetSequentialRunLength(ulMinRun, ulMaxRun);
+        }
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: invalid random percentage passed to -rs\n");
+    }
+
+    return fOk;
+}
+
+bool CmdLineParser::_ParseMetadataWeights(const char *arg, vector<Target>& vTargets)
+{
+    vector<UINT32> vulWeights;
+    const char *psz = arg;
+    bool fOk = true;
+
+    // <create>:<open>:<stat>:<rename>:<unlink>
+    while (fOk && vulWeights.size() < METADATA_OPERATION_COUNT)
+    {
+        char *pszEnd = nullptr;
+        vulWeights.push_back(strtoul(psz, &pszEnd, 10));
+        fOk = (pszEnd != psz) && (*pszEnd == (vulWeights.size() < METADATA_OPERATION_COUNT ? ':' : '\0'));
+        psz = pszEnd + 1;
+    }
+
+    if (fOk)
+    {
+        for (auto& target : vTargets)
+        {
+            for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+            {
+                target.SetMetadataWeight(static_cast<MetadataOperation>(i), vulWeights[i]);
+            }
+        }
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: invalid weights passed to -Mw; expected <create>:<open>:<stat>:<rename>:<unlink>\n");
+    }
+
+    return fOk;
+}
+
 bool CmdLineParser::_ParseFlushParameter(const char *arg, MemoryMappedIoFlushMode *FlushMode)
 {
     assert(nullptr != arg);
@@ -586,7 +968,7 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
     // find block size (other parameters may be stated in terms of blocks)
     for (int x = 1; x < argc; ++x)
     {
-        if ((nullptr != argv[x]) && (('-' == argv[x][0]) || ('/' == argv[x][0])) && ('b' == argv[x][1]) && ('\0' != argv[x][2]))
+        if ((nullptr != argv[x]) && (('-' == argv[x][0]) || ('/' == argv[x][0])) && ('b' == argv[x][1]) && ('\0' != argv[x][2]) && ('d' != argv[x][2]))
         {
             _dwBlockSize = 0;
             UINT64 ullBlockSize;
@@ -644,6 +1026,30 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             _DisplayUsageInfo(argv[0]);
             exit(0);
 
+        case 'A':    //access pattern plugin
+            //-A<plugin>[,<parameters>]; the parameters are everything after the first comma
+            if (*(arg + 1) != '\0' && *(arg + 1) != ',')
+            {
+                string sPlugin(arg + 1);
+                string sParameters;
+                size_t iComma = sPlugin.find(',');
+                if (iComma != string::npos)
+                {
+                    sParameters = sPlugin.substr(iComma + 1);
+                    sPlugin.resize(iComma);
+                }
+
+                for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                {
+                    i->SetAccessPatternPlugin(sPlugin, sParameters);
+                }
+            }
+            else
+            {
+                fError = true;
+            }
+            break;
+
         case 'a':    //affinity
             //-a1,2,3,4 (assign threads to cpus 1,2,3,4 (round robin))
             if (!_ParseAffinity(arg, &timeSpan))
@@ -654,6 +1060,14 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
 
         case 'b':    //block size
             // nop - block size has been taken care of before the loop
+            // except for block size distributions, which may be stated in blocks
+            if (*(arg + 1) == 'd')
+            {
+                if (!_ParseBlockSizeDistribution(arg + 2, vTargets))
+                {
+                    fError = true;
+                }
+            }
             break;
 
         case 'B':    //base file offset (offset from the beginning of the file) or HistogramBucketList
@@ -860,6 +1274,29 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'H':    //reap completions on a separate thread, or on a shared pool of threads
+            if (*(arg + 1) == '\0')
+            {
+                timeSpan.SetSeparateReaper(true);
+            }
+            else if (*(arg + 1) == 'p')
+            {
+                int c = atoi(arg + 2);
+                if (c > 0)
+                {
+                    timeSpan.SetCompletionPoolThreadCount(c);
+                }
+                else
+                {
+                    fError = true;
+                }
+            }
+            else
+            {
+                fError = true;
+            }
+            break;
+
         case 'i':    //number of IOs to issue before think time
             {
                 int c = atoi(arg + 1);
@@ -929,6 +1366,55 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             timeSpan.SetDisableAffinity(true);
             break;
 
+        case 'M':    //metadata workload
+            if (*(arg + 1) == '\0')
+            {
+                for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                {
+                    i->SetUseMetadata(true);
+                }
+            }
+            else if (*(arg + 1) == 'w')
+            {
+                if (!_ParseMetadataWeights(arg + 2, vTargets))
+                {
+                    fError = true;
+                }
+            }
+            else if (*(arg + 1) == 'f' || *(arg + 1) == 'd' || *(arg + 1) == 'n')
+            {
+                char *pszEnd = nullptr;
+                UINT32 ulValue = strtoul(arg + 2, &pszEnd, 10);
+                if (pszEnd == arg + 2 || *pszEnd != '\0')
+                {
+                    fprintf(stderr, "Invalid value passed to -M%c\n", *(arg + 1));
+                    fError = true;
+                }
+                else
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        if (*(arg + 1) == 'f')
+                        {
+                            i->SetMetadataFanout(ulValue);
+                        }
+                        else if (*(arg + 1) == 'd')
+                        {
+                            i->SetMetadataDepth(ulValue);
+                        }
+                        else
+                        {
+                            i->SetMetadataFilesPerDirectory(ulValue);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                fError = true;
+            }
+            break;
+
         case 'N':
             if (!_ParseFlushParameter(arg, &f))
             {
@@ -986,7 +1472,88 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'k':    //lookahead
+            if (*(arg + 1) == 'd')
+            {
+                if (*(arg + 2) != '\0')
+                {
+                    timeSpan.SetLookaheadDumpPath(arg + 2);
+                }
+                else
+                {
+                    fError = true;
+                }
+            }
+            else
+            {
+                int c = atoi(arg + 1);
+                if (c > 0)
+                {
+                    timeSpan.SetLookaheadDepth(c);
+                }
+                else
+                {
+                    fError = true;
+                }
+            }
+            break;
+
+        case 'q':    //batch size for submitting and reaping I/O
+            {
+                int c = atoi(arg + 1);
+                if (c > 0)
+                {
+                    timeSpan.SetBatchSize(c);
+                }
+                else
+                {
+                    fError = true;
+                }
+            }
+            break;
+
+        case 'Q':    //poll for completions
+            if (*(arg + 1) == '\0')
+            {
+                timeSpan.SetPollCompletions(true);
+            }
+            else
+            {
+                fError = true;
+            }
+            break;
+
         case 'r':    //random access
+            if (*(arg + 1) == 'd')
+            {
+                if (!_ParseRandomDistribution(arg + 2, vTargets))
+                {
+                    fError = true;
+                }
+            }
+            else if (*(arg + 1) == 's')
+            {
+                if (!_ParseRandomRatio(arg + 2, vTargets))
+                {
+                    fError = true;
+                }
+            }
+            else if (*(arg + 1) == 'p')
+            {
+                if (*(arg + 2) != '\0')
+                {
+                    fprintf(stderr, "Unrecognized option provided to -rp\n");
+                    fError = true;
+                }
+                else
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        i->SetUseRandomPermutation(true);
+                    }
+                }
+            }
+            else
             {
                 UINT64 cb = _dwBlockSize;
                 if (*(arg + 1) != '\0')
@@ -1042,6 +1609,59 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             break;
 
         case 's':    //stride size
+            if ('n' == *(arg + 1))
+            {
+                // interleaved sequential streams per thread
+                int c = atoi(arg + 2);
+                if (c > 0)
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        i->SetSequentialStreamCount(c);
+                    }
+                }
+                else
+                {
+                    fprintf(stderr, "Invalid stream count passed to -sn\n");
+                    fError = true;
+                }
+            }
+            else if ('r' == *(arg + 1) && '\0' == *(arg + 2))
+            {
+                // backward scan
+                for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                {
+                    i->SetUseReverseSequential(true);
+                }
+            }
+            else if ('k' == *(arg + 1))
+            {
+                // read <count> strides, skip <count> strides
+                char *pszEnd = nullptr;
+                UINT32 ulReadRun = strtoul(arg + 2, &pszEnd, 10);
+                UINT32 ulSkipRun = 0;
+                bool fOk = (pszEnd != arg + 2) && (*pszEnd == '/') && (ulReadRun > 0);
+                if (fOk)
+                {
+                    const char *psz = pszEnd + 1;
+                    ulSkipRun = strtoul(psz, &pszEnd, 10);
+                    fOk = (pszEnd != psz) && (*pszEnd == '\0');
+                }
+
+                if (fOk)
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        i->SetSequentialSkip(ulReadRun, ulSkipRun);
+                    }
+                }
+                else
+                {
+                    fprintf(stderr, "Invalid read/skip pattern passed to -sk\n");
+                    fError = true;
+                }
+            }
+            else
             {
                 int idx = 1;
 
@@ -1223,6 +1843,151 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             break;
 
         case 'w':    //write test [default=read]
+            if (*(arg + 1) == 't' || *(arg + 1) == 'z' || *(arg + 1) == 'd')    //trim, write-zeroes or durable write percentage
+            {
+                int c = atoi(arg + 2);
+                if (*(arg + 2) == '\0' || c < 0 || c > 100)
+                {
+                    fprintf(stderr, "Invalid percentage passed to -w%c\n", *(arg + 1));
+                    fError = true;
+                }
+                else
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        if (*(arg + 1) == 't')
+                        {
+                            i->SetTrimRatio(c);
+                        }
+                        else if (*(arg + 1) == 'z')
+                        {
+                            i->SetWriteZeroesRatio(c);
+                        }
+                        else
+                        {
+                            i->SetDurableWriteRatio(c);
+                        }
+                    }
+                }
+            }
+            else if (*(arg + 1) == 'f')    //flush schedule
+            {
+                char chMode = *(arg + 2);
+                if (chMode == 'd' && *(arg + 3) == '\0')
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        i->SetFlushDataOnly(true);
+                    }
+                }
+                else
+                {
+                    const char *pszValue = (chMode == 't' || chMode == 'p') ? arg + 3 : arg + 2;
+                    int c = atoi(pszValue);
+                    if (*pszValue == '\0' || c <= 0 || (chMode == 'p' && c > 100))
+                    {
+                        fprintf(stderr, "Invalid value passed to -wf\n");
+                        fError = true;
+                    }
+                    else
+                    {
+                        for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                        {
+                            if (chMode == 't')
+                            {
+                                i->SetFlushTimeIntervalInMilliseconds(c);
+                            }
+                            else if (chMode == 'p')
+                            {
+                                i->SetFlushRatio(c);
+                            }
+                            else
+                            {
+                                i->SetFlushIoInterval(c);
+                            }
+                        }
+                    }
+                }
+            }
+            else if (*(arg + 1) == 'a')    //append
+            {
+                char chMode = *(arg + 2);
+                if (chMode == '\0')
+                {
+                    for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                    {
+                        i->SetUseAppend(true);
+                    }
+                }
+                else
+                {
+                    UINT64 cb;
+                    if ((chMode == 'p' || chMode == 's') && _GetSizeInBytes(arg + 3, cb) && (cb > 0))
+                    {
+                        for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                        {
+                            if (chMode == 'p')
+                            {
+                                i->SetAppendPreallocationSizeInBytes(cb);
+                            }
+                            else
+                            {
+                                i->SetAppendSegmentSizeInBytes(cb);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        fprintf(stderr, "Invalid value passed to -wa\n");
+                        fError = true;
+                    }
+                }
+            }
+            else if (*(arg + 1) == 'g')    //group commit
+            {
+                char chMode = *(arg + 2);
+                if (chMode == 'r')
+                {
+                    UINT64 cb;
+                    if (_GetSizeInBytes(arg + 3, cb) && (cb > 0) && (cb <= MAXDWORD))
+                    {
+                        for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                        {
+                            i->SetCommitRecordSizeInBytes(static_cast<DWORD>(cb));
+                        }
+                    }
+                    else
+                    {
+                        fprintf(stderr, "Invalid record size passed to -wgr\n");
+                        fError = true;
+                    }
+                }
+                else
+                {
+                    const char *pszValue = (chMode == 't') ? arg + 3 : arg + 2;
+                    int c = atoi(pszValue);
+                    if (*pszValue == '\0' || c < 0 || (chMode != 't' && c == 0))
+                    {
+                        fprintf(stderr, "Invalid value passed to -wg%s\n", (chMode == 't') ? "t" : "");
+                        fError = true;
+                    }
+                    else
+                    {
+                        for (auto i = vTargets.begin(); i != vTargets.end(); i++)
+                        {
+                            if (chMode == 't')
+                            {
+                                i->SetCommitThinkTimeInMicroseconds(c);
+                            }
+                            else
+                            {
+                                i->SetCommitterCount(c);
+                            }
+                        }
+                    }
+                }
+            }
+            else
             {
                 int c = -1;
                 if (*(arg + 1) == '\0')
@@ -1262,8 +2027,59 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
-        case 'x':    //completion routines
-            timeSpan.SetCompletionRoutines(true);
+        case 'x':    //completion routines, events or I/O rings
+            if (*(arg + 1) == '\0')
+            {
+                timeSpan.SetCompletionRoutines(true);
+            }
+            else if (*(arg + 1) == 'e' && *(arg + 2) == '\0')
+            {
+                timeSpan.SetEventCompletions(true);
+            }
+            else if (*(arg + 1) == 'r' && *(arg + 2) == '\0')
+            {
+                timeSpan.SetIoRing(true);
+            }
+            else if (*(arg + 1) == 'r' && *(arg + 2) == 'p' && *(arg + 3) == '\0')
+            {
+                timeSpan.SetIoRing(true);
+                timeSpan.SetIoRingSubmissionPoller(true);
+            }
+            else
+            {
+                fError = true;
+            }
+            break;
+
+        case 'Y':    //completion wait strategy
+            if (*(arg + 1) == 'b' && *(arg + 2) == '\0')
+            {
+                timeSpan.SetWaitStrategy(WaitStrategy::Block);
+            }
+            else if (*(arg + 1) == 'p' && *(arg + 2) == '\0')
+            {
+                timeSpan.SetWaitStrategy(WaitStrategy::Poll);
+            }
+            else if (*(arg + 1) == 's')
+            {
+                timeSpan.SetWaitStrategy(WaitStrategy::SpinThenBlock);
+                if (*(arg + 2) != '\0')
+                {
+                    int c = atoi(arg + 2);
+                    if (c > 0)
+                    {
+                        timeSpan.SetSpinBudgetInMicroseconds(c);
+                    }
+                    else
+                    {
+                        fError = true;
+                    }
+                }
+            }
+            else
+            {
+                fError = true;
+            }
             break;
 
         case 'y':    //external synchronization
@@ -0,0 +1,100 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+//
+// Access pattern plugins
+//
+// A plugin replaces DiskSpd's own choice of the offset and read/write type of each I/O to a target
+// (-A<plugin>[,<parameters>] or the target's <AccessPattern> element). It is a DLL which exports
+// DiskSpdGetAccessPattern, a PDISKSPD_GET_ACCESS_PATTERN; DiskSpd calls it once with the interface
+// version it was built with and the plugin fills in the function table, or returns FALSE if it
+// does not support that version. This header is all a plugin needs; it only depends on windows.h.
+//
+// Each worker thread creates its own state for each target using the plugin, from the context below,
+// and asks the plugin for decisions in batches as it consumes them (see -k for the batch size). All
+// calls for a state come from the thread which created it, so plugins need no synchronization of
+// their own. A plugin which wants reproducible runs should derive its randomness from Seed.
+//
+// Transfer sizes still come from the target's block size (-b, -bd); the geometry describes the
+// offsets at which an I/O of any of those sizes fits. Offsets returned beyond LastOffset are wrapped
+// in whole blocks of Alignment, landing on an aligned offset.
+//
+
+#define DISKSPD_ACCESS_PATTERN_VERSION 1
+
+#define DISKSPD_GET_ACCESS_PATTERN_EXPORT "DiskSpdGetAccessPattern"
+
+typedef struct _DISKSPD_TARGET_GEOMETRY
+{
+    UINT64 FileSize;
+    UINT64 BaseFileOffset;      // -B; all offsets exchanged with the plugin are relative to it
+    UINT64 LastOffset;          // highest offset at which an I/O of MaxBlockSize fits
+    UINT64 Alignment;           // -r/-s alignment; DiskSpd's own patterns only issue aligned offsets
+    UINT64 BlockCount;          // number of aligned offsets in [0, LastOffset]
+    UINT32 BlockSize;
+    UINT32 MaxBlockSize;
+} DISKSPD_TARGET_GEOMETRY;
+
+typedef struct _DISKSPD_ACCESS_PATTERN_CONTEXT
+{
+    const char *Parameters;     // text following the plugin path, empty if none
+    const char *TargetPath;
+    UINT32 ThreadNo;            // thread number within the timespan
+    UINT32 RelativeThreadNo;    // thread number among the threads of the target
+    UINT32 ThreadsPerTarget;    // number of threads sharing the target
+    UINT32 WriteRatio;          // -w; plugins are free to ignore it
+    UINT64 Seed;                // distinct per thread, derived from -z
+    DISKSPD_TARGET_GEOMETRY Geometry;
+} DISKSPD_ACCESS_PATTERN_CONTEXT;
+
+typedef struct _DISKSPD_IO_DECISION
+{
+    UINT64 Offset;              // relative to BaseFileOffset
+    BOOLEAN Write;
+} DISKSPD_IO_DECISION;
+
+// returns the per-thread state passed to the other functions, or NULL on failure, which fails the run
+typedef void *(WINAPI *PDISKSPD_CREATE_STATE)(const DISKSPD_ACCESS_PATTERN_CONTEXT *pContext);
+
+// fills in the next cDecisions decisions, in the order the I/O will be issued
+typedef void (WINAPI *PDISKSPD_GENERATE)(void *pState, DISKSPD_IO_DECISION *pDecisions, UINT32 cDecisions);
+
+typedef void (WINAPI *PDISKSPD_DESTROY_STATE)(void *pState);
+
+typedef struct _DISKSPD_ACCESS_PATTERN
+{
+    PDISKSPD_CREATE_STATE CreateState;
+    PDISKSPD_GENERATE Generate;
+    PDISKSPD_DESTROY_STATE DestroyState;
+} DISKSPD_ACCESS_PATTERN;
+
+typedef BOOL (WINAPI *PDISKSPD_GET_ACCESS_PATTERN)(UINT32 Version, DISKSPD_ACCESS_PATTERN *pAccessPattern);
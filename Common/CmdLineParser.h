@@ -49,6 +49,10 @@ private:
     bool _ParseFlushParameter(const char *arg, MemoryMappedIoFlushMode *FlushMode );
     bool _ParseAffinity(const char *arg, TimeSpan *pTimeSpan);
     bool _ParseHistogramBucketList(const char* arg, Profile* pProfile);
+    bool _ParseBlockSizeDistribution(const char *arg, vector<Target>& vTargets);
+    bool _ParseRandomDistribution(const char *arg, vector<Target>& vTargets);
+    bool _ParseRandomRatio(const char *arg, vector<Target>& vTargets);
+    bool _ParseMetadataWeights(const char *arg, vector<Target>& vTargets);
 
     void _DisplayUsageInfo(const char *pszFilename) const;
     bool _GetSizeInBytes(const char *pszSize, UINT64& ullSize) const;
@@ -272,6 +272,22 @@ string ThreadTarget::GetXml() const
     return sXml;
 }
 
+string BlockSizeWeight::GetXml() const
+{
+    char buffer[4096];
+    string sXml("<BlockSizeWeight>\n");
+
+    sprintf_s(buffer, _countof(buffer), "<BlockSize>%u</BlockSize>\n", dwBlockSize);
+    sXml += buffer;
+
+    sprintf_s(buffer, _countof(buffer), "<Weight>%u</Weight>\n", ulWeight);
+    sXml += buffer;
+
+    sXml += "</BlockSizeWeight>\n";
+
+    return sXml;
+}
+
 string Target::GetXml() const
 {
     char buffer[4096];
@@ -378,6 +394,27 @@ string Target::GetXml() const
     {
         sprintf_s(buffer, _countof(buffer), "<Random>%I64u</Random>\n", GetBlockAlignmentInBytes());
         sXml += buffer;
+
+        if (_fUseRandomPermutation)
+        {
+            sXml += "<RandomPermutation>true</RandomPermutation>\n";
+        }
+
+        if (_ulRandomRatio != 100)
+        {
+            sprintf_s(buffer, _countof(buffer), "<RandomRatio>%u</RandomRatio>\n", _ulRandomRatio);
+            sXml += buffer;
+        }
+
+        if (_ulMinSequentialRun != 1 || _ulMaxSequentialRun != 1)
+        {
+            sXml += "<SequentialRunLength>\n";
+            sprintf_s(buffer, _countof(buffer), "<Min>%u</Min>\n", _ulMinSequentialRun);
+            sXml += buffer;
+            sprintf_s(buffer, _countof(buffer), "<Max>%u</Max>\n", _ulMaxSequentialRun);
+            sXml += buffer;
+            sXml += "</SequentialRunLength>\n";
+        }
     }
     else
     {
@@ -387,6 +424,94 @@ string Target::GetXml() const
         sXml += _fInterlockedSequential ?
             "<InterlockedSequential>true</InterlockedSequential>\n" :
             "<InterlockedSequential>false</InterlockedSequential>\n";
+
+        if (_ulSequentialStreams != 1)
+        {
+            sprintf_s(buffer, _countof(buffer), "<SequentialStreams>%u</SequentialStreams>\n", _ulSequentialStreams);
+            sXml += buffer;
+        }
+
+        if (_fReverseSequential)
+        {
+            sXml += "<ReverseSequential>true</ReverseSequential>\n";
+        }
+
+        if (_ulSequentialReadRun != 0)
+        {
+            sXml += "<SequentialSkip>\n";
+            sprintf_s(buffer, _countof(buffer), "<Read>%u</Read>\n", _ulSequentialReadRun);
+            sXml += buffer;
+            sprintf_s(buffer, _countof(buffer), "<Skip>%u</Skip>\n", _ulSequentialSkipRun);
+            sXml += buffer;
+            sXml += "</SequentialSkip>\n";
+        }
+    }
+
+    if (_distributionType != DistributionType::Uniform)
+    {
+        sXml += "<Distribution>\n";
+        switch (_distributionType)
+        {
+        case DistributionType::Percent:
+            sXml += "<Percent>\n";
+            for (const auto& range : _vDistributionRanges)
+            {
+                sprintf_s(buffer, _countof(buffer), "<Range IO=\"%u\">%u</Range>\n", range.ulIoPercent, range.ulTargetPercent);
+                sXml += buffer;
+            }
+            sXml += "</Percent>\n";
+            break;
+
+        case DistributionType::Absolute:
+            sXml += "<Absolute>\n";
+            for (const auto& range : _vDistributionRanges)
+            {
+                sprintf_s(buffer, _countof(buffer), "<Range IO=\"%u\">%I64u</Range>\n", range.ulIoPercent, range.ullTargetBytes);
+                sXml += buffer;
+            }
+            sXml += "</Absolute>\n";
+            break;
+
+        case DistributionType::Zipf:
+            sprintf_s(buffer, _countof(buffer), "<Zipf>%g</Zipf>\n", _lfZipfTheta);
+            sXml += buffer;
+            break;
+
+        case DistributionType::Pareto:
+            sprintf_s(buffer, _countof(buffer), "<Pareto>%u</Pareto>\n", _ulParetoHotPercent);
+            sXml += buffer;
+            break;
+
+        case DistributionType::Normal:
+            sXml += "<Normal>\n";
+            sprintf_s(buffer, _countof(buffer), "<Center>%g</Center>\n", _lfNormalCenterPercent);
+            sXml += buffer;
+            sprintf_s(buffer, _countof(buffer), "<StdDev>%g</StdDev>\n", _lfNormalStdDevPercent);
+            sXml += buffer;
+            sXml += "</Normal>\n";
+            break;
+
+        default:
+            break;
+        }
+
+        if (_ullDistributionDrift != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<Drift>%I64u</Drift>\n", _ullDistributionDrift);
+            sXml += buffer;
+        }
+        sXml += "</Distribution>\n";
+    }
+
+    if (!_sAccessPatternPlugin.empty())
+    {
+        sXml += "<AccessPattern>\n";
+        sXml += "<Plugin>" + _sAccessPatternPlugin + "</Plugin>\n";
+        if (!_sAccessPatternParameters.empty())
+        {
+            sXml += "<Parameters>" + _sAccessPatternParameters + "</Parameters>\n";
+        }
+        sXml += "</AccessPattern>\n";
     }
 
     sprintf_s(buffer, _countof(buffer), "<ThreadStride>%I64u</ThreadStride>\n", _ullThreadStride);
@@ -401,6 +526,100 @@ string Target::GetXml() const
     sprintf_s(buffer, _countof(buffer), "<WriteRatio>%u</WriteRatio>\n", _ulWriteRatio);
     sXml += buffer;
 
+    if (_ulTrimRatio != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<TrimRatio>%u</TrimRatio>\n", _ulTrimRatio);
+        sXml += buffer;
+    }
+
+    if (_ulWriteZeroesRatio != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<WriteZeroesRatio>%u</WriteZeroesRatio>\n", _ulWriteZeroesRatio);
+        sXml += buffer;
+    }
+
+    if (_ulDurableWriteRatio != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<DurableWriteRatio>%u</DurableWriteRatio>\n", _ulDurableWriteRatio);
+        sXml += buffer;
+    }
+
+    if (GetUseFlush() || _fFlushDataOnly)
+    {
+        sXml += "<Flush>\n";
+        if (_ulFlushIoInterval != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<IoInterval>%u</IoInterval>\n", _ulFlushIoInterval);
+            sXml += buffer;
+        }
+        if (_ulFlushTimeInterval != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<TimeInterval>%u</TimeInterval>\n", _ulFlushTimeInterval);
+            sXml += buffer;
+        }
+        if (_ulFlushRatio != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<Ratio>%u</Ratio>\n", _ulFlushRatio);
+            sXml += buffer;
+        }
+        if (_fFlushDataOnly)
+        {
+            sXml += "<DataOnly>true</DataOnly>\n";
+        }
+        sXml += "</Flush>\n";
+    }
+
+    if (_fAppend)
+    {
+        sXml += "<Append>true</Append>\n";
+    }
+
+    if (_ullAppendPreallocationSize != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<AppendPreallocationSize>%I64u</AppendPreallocationSize>\n", _ullAppendPreallocationSize);
+        sXml += buffer;
+    }
+
+    if (_ullAppendSegmentSize != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<AppendSegmentSize>%I64u</AppendSegmentSize>\n", _ullAppendSegmentSize);
+        sXml += buffer;
+    }
+
+    if (GetUseGroupCommit() || _ulCommitThinkTime != 0)
+    {
+        sXml += "<GroupCommit>\n";
+        sprintf_s(buffer, _countof(buffer), "<Committers>%u</Committers>\n", _ulCommitterCount);
+        sXml += buffer;
+        sprintf_s(buffer, _countof(buffer), "<RecordSize>%u</RecordSize>\n", _dwCommitRecordSize);
+        sXml += buffer;
+        if (_ulCommitThinkTime != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<ThinkTime>%u</ThinkTime>\n", _ulCommitThinkTime);
+            sXml += buffer;
+        }
+        sXml += "</GroupCommit>\n";
+    }
+
+    if (_fMetadata)
+    {
+        sXml += "<Metadata>true</Metadata>\n";
+        sprintf_s(buffer, _countof(buffer), "<MetadataFanout>%u</MetadataFanout>\n", _ulMetadataFanout);
+        sXml += buffer;
+        sprintf_s(buffer, _countof(buffer), "<MetadataDepth>%u</MetadataDepth>\n", _ulMetadataDepth);
+        sXml += buffer;
+        sprintf_s(buffer, _countof(buffer), "<MetadataFilesPerDirectory>%u</MetadataFilesPerDirectory>\n", _ulMetadataFilesPerDirectory);
+        sXml += buffer;
+        sXml += "<MetadataWeights>\n";
+        for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+        {
+            const char *pszName = MetadataTree::GetOperationName(static_cast<MetadataOperation>(i));
+            sprintf_s(buffer, _countof(buffer), "<%s>%u</%s>\n", pszName, _vulMetadataWeights[i], pszName);
+            sXml += buffer;
+        }
+        sXml += "</MetadataWeights>\n";
+    }
+
     sprintf_s(buffer, _countof(buffer), "<Throughput>%u</Throughput>\n", _dwThroughputBytesPerMillisecond);
     sXml += buffer;
 
@@ -439,6 +658,30 @@ string Target::GetXml() const
         sXml += "</ThreadTargets>\n";
     }
 
+    if (_vReadBlockSizes.size() > 0)
+    {
+        sXml += "<ReadBlockSizes>\n";
+
+        for (const auto& blockSize : _vReadBlockSizes)
+        {
+            sXml += blockSize.GetXml();
+        }
+
+        sXml += "</ReadBlockSizes>\n";
+    }
+
+    if (_vWriteBlockSizes.size() > 0)
+    {
+        sXml += "<WriteBlockSizes>\n";
+
+        for (const auto& blockSize : _vWriteBlockSizes)
+        {
+            sXml += blockSize.GetXml();
+        }
+
+        sXml += "</WriteBlockSizes>\n";
+    }
+
     sXml += "</Target>\n";
 
     return sXml;
@@ -527,10 +770,73 @@ void Target::FreeRandomDataWriteBuffer()
     }
 }
 
+DWORD Target::GetMaxBlockSizeInBytes() const
+{
+    DWORD dwMaxBlockSize = 0;
+
+    // the fixed block size still applies to an IO type without a distribution
+    if (_vReadBlockSizes.empty() || _vWriteBlockSizes.empty())
+    {
+        dwMaxBlockSize = _dwBlockSize;
+    }
+
+    for (const auto& blockSize : _vReadBlockSizes)
+    {
+        dwMaxBlockSize = std::max(dwMaxBlockSize, blockSize.dwBlockSize);
+    }
+
+    for (const auto& blockSize : _vWriteBlockSizes)
+    {
+        dwMaxBlockSize = std::max(dwMaxBlockSize, blockSize.dwBlockSize);
+    }
+
+    return dwMaxBlockSize;
+}
+
+UINT32 Target::GetMetadataFileCount() const
+{
+    UINT64 ullCount = _ulMetadataFilesPerDirectory;
+
+    for (UINT32 i = 0; i < _ulMetadataDepth && ullCount <= MAXUINT32; i++)
+    {
+        ullCount *= _ulMetadataFanout;
+    }
+
+    return ullCount <= MAXUINT32 ? static_cast<UINT32>(ullCount) : 0;
+}
+
+vector<DWORD> Target::GetBlockSizeClasses() const
+{
+    vector<DWORD> vBlockSizes;
+
+    if (GetUseBlockSizeDistribution())
+    {
+        if (_vReadBlockSizes.empty() || _vWriteBlockSizes.empty())
+        {
+            vBlockSizes.push_back(_dwBlockSize);
+        }
+
+        for (const auto& blockSize : _vReadBlockSizes)
+        {
+            vBlockSizes.push_back(blockSize.dwBlockSize);
+        }
+
+        for (const auto& blockSize : _vWriteBlockSizes)
+        {
+            vBlockSizes.push_back(blockSize.dwBlockSize);
+        }
+
+        std::sort(vBlockSizes.begin(), vBlockSizes.end());
+        vBlockSizes.erase(std::unique(vBlockSizes.begin(), vBlockSizes.end()), vBlockSizes.end());
+    }
+
+    return vBlockSizes;
+}
+
 BYTE* Target::GetRandomDataWriteBuffer(Random *pRand)
 {
     size_t cbBuffer = static_cast<size_t>(GetRandomDataWriteBufferSize());
-    size_t cbBlock = GetBlockSizeInBytes();
+    size_t cbBlock = GetMaxBlockSizeInBytes();
 
     // leave enough bytes in the buffer for one block
     size_t randomOffset = pRand->Rand32() % (cbBuffer - (cbBlock - 1));
@@ -548,94 +854,976 @@ BYTE* Target::GetRandomDataWriteBuffer(Random *pRand)
     // unbuffered IO needs aligned addresses
     assert(!fUnbufferedIO || (reinterpret_cast<ULONG_PTR>(pBuffer) % 512 == 0));
     assert(pBuffer >= _pRandomDataWriteBuffer);
-    assert(pBuffer <= _pRandomDataWriteBuffer + GetRandomDataWriteBufferSize() - GetBlockSizeInBytes());
+    assert(pBuffer <= _pRandomDataWriteBuffer + GetRandomDataWriteBufferSize() - GetMaxBlockSizeInBytes());
 
     return pBuffer;
 }
 
-string TimeSpan::GetXml() const
+void OffsetDistribution::Initialize(const Target& target, UINT64 ullBlockCount)
 {
-    string sXml("<TimeSpan>\n");
-    char buffer[4096];
+    assert(ullBlockCount > 0);
 
-    sXml += _fCompletionRoutines ? "<CompletionRoutines>true</CompletionRoutines>\n" : "<CompletionRoutines>false</CompletionRoutines>\n";
-    sXml += _fMeasureLatency ? "<MeasureLatency>true</MeasureLatency>\n" : "<MeasureLatency>false</MeasureLatency>\n";
-    sXml += _fCalculateIopsStdDev ? "<CalculateIopsStdDev>true</CalculateIopsStdDev>\n" : "<CalculateIopsStdDev>false</CalculateIopsStdDev>\n";
-    sXml += _fDisableAffinity ? "<DisableAffinity>true</DisableAffinity>\n" : "<DisableAffinity>false</DisableAffinity>\n";
+    _distributionType = target.GetRandomDistribution();
+    _ullBlockCount = ullBlockCount;
+    _ullBlockCountReciprocal = ~0ULL / ullBlockCount;
 
-    sprintf_s(buffer, _countof(buffer), "<Duration>%u</Duration>\n", _ulDuration);
-    sXml += buffer;
+    _lfDriftBlocksPerTick = static_cast<double>(target.GetDistributionDrift()) / target.GetBlockAlignmentInBytes() / PerfTimer::SecondsToPerfTime(1.0);
 
-    sprintf_s(buffer, _countof(buffer), "<Warmup>%u</Warmup>\n", _ulWarmUp);
-    sXml += buffer;
+    switch (_distributionType)
+    {
+    case DistributionType::Percent:
+    case DistributionType::Absolute:
+        {
+            UINT64 ullFirstBlock = 0;
+            UINT32 ulIoPercent = 0;
 
-    sprintf_s(buffer, _countof(buffer), "<Cooldown>%u</Cooldown>\n", _ulCoolDown);
-    sXml += buffer;
+            _vRanges.clear();
+            _vbPercentToRange.clear();
 
-    sprintf_s(buffer, _countof(buffer), "<ThreadCount>%u</ThreadCount>\n", _dwThreadCount);
-    sXml += buffer;
+            for (const auto& range : target.GetDistributionRanges())
+            {
+                UINT64 ullBlocks;
+                if (_distributionType == DistributionType::Absolute)
+                {
+                    ullBlocks = range.ullTargetBytes / target.GetBlockAlignmentInBytes();
+                }
+                else
+                {
+                    // split to avoid overflowing on very large targets
+                    ullBlocks = (ullBlockCount / 100) * range.ulTargetPercent + ((ullBlockCount % 100) * range.ulTargetPercent) / 100;
+                }
 
-    sprintf_s(buffer, _countof(buffer), "<RequestCount>%u</RequestCount>\n", _dwRequestCount);
-    sXml += buffer;
+                // small targets may round a range down to nothing; keep at least one block in each
+                if (ullFirstBlock >= ullBlockCount)
+                {
+                    ullFirstBlock = ullBlockCount - 1;
+                }
+                ullBlocks = std::max(ullBlocks, 1ULL);
+                ullBlocks = std::min(ullBlocks, ullBlockCount - ullFirstBlock);
 
-    sprintf_s(buffer, _countof(buffer), "<IoBucketDuration>%u</IoBucketDuration>\n", _ulIoBucketDurationInMilliseconds);
-    sXml += buffer;
+                _vRanges.push_back({ ullFirstBlock, ullBlocks });
+                _vbPercentToRange.insert(_vbPercentToRange.end(), range.ulIoPercent, static_cast<BYTE>(_vRanges.size() - 1));
 
-    sprintf_s(buffer, _countof(buffer), "<RandSeed>%u</RandSeed>\n", _ulRandSeed);
-    sXml += buffer;
+                ullFirstBlock += ullBlocks;
+                ulIoPercent += range.ulIoPercent;
+            }
 
-    if (_vAffinity.size() > 0)
-    {
-        sXml += "<Affinity>\n";
-        for (const auto& a : _vAffinity)
+            // the remaining IO goes to the remainder of the target
+            if (ulIoPercent < 100)
+            {
+                if (ullFirstBlock >= ullBlockCount)
+                {
+                    ullFirstBlock = ullBlockCount - 1;
+                }
+
+                _vRanges.push_back({ ullFirstBlock, ullBlockCount - ullFirstBlock });
+                _vbPercentToRange.insert(_vbPercentToRange.end(), 100 - ulIoPercent, static_cast<BYTE>(_vRanges.size() - 1));
+            }
+
+            assert(_vbPercentToRange.size() == 100);
+        }
+        break;
+
+    case DistributionType::Zipf:
         {
-            sprintf_s(buffer, _countof(buffer), "<AffinityGroupAssignment Group=\"%u\" Processor=\"%u\"/>\n", a.wGroup, a.bProc);
-            sXml += buffer;
+            double theta = target.GetZipfTheta();
+            double lfZeta2 = 1.0 + pow(0.5, theta);
+
+            _lfZetaN = _Zeta(ullBlockCount, theta);
+            _lfHalfPowTheta = pow(0.5, theta);
+            _lfAlpha = 1.0 / (1.0 - theta);
+            _lfEta = (1.0 - pow(2.0 / ullBlockCount, 1.0 - theta)) / (1.0 - lfZeta2 / _lfZetaN);
         }
-        sXml += "</Affinity>\n";
-    }
+        break;
 
-    sXml += "<Targets>\n";
-    for (const auto& target : _vTargets)
-    {
-        sXml += target.GetXml();
+    case DistributionType::Pareto:
+        {
+            // P(block < h * count) = 1 - h
+            double h = target.GetParetoHotPercent() / 100.0;
+            _lfParetoExponent = log(h) / log(1.0 - h);
+        }
+        break;
+
+    case DistributionType::Normal:
+        _lfCenter = ullBlockCount * target.GetNormalCenterPercent() / 100.0;
+        _lfStdDev = ullBlockCount * target.GetNormalStdDevPercent() / 100.0;
+
+        // the distribution is truncated to [0, block count); Phi(x) = erfc(-x / sqrt(2)) / 2
+        _lfNormalCdfLow = erfc(_lfCenter / _lfStdDev / sqrt(2.0)) / 2.0;
+        _lfNormalCdfSpan = erfc((_lfCenter - ullBlockCount) / _lfStdDev / sqrt(2.0)) / 2.0 - _lfNormalCdfLow;
+        break;
+
+    default:
+        break;
     }
-    sXml += "</Targets>\n";
-    sXml += "</TimeSpan>\n";
-    return sXml;
 }
 
-void TimeSpan::MarkFilesAsPrecreated(const vector<string> vFiles)
+// Inverse of the standard normal CDF, after Acklam: rational approximations for the central region and
+// the tails, with a relative error below 1.15e-9, which is well within a block. p = 0 gives -infinity.
+double OffsetDistribution::_InverseNormalCdf(double p)
 {
-    for (auto sFile : vFiles)
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                 6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00 };
+    const double lfLow = 0.02425;
+
+    if (p < lfLow)
     {
-        for (auto pTarget = _vTargets.begin(); pTarget != _vTargets.end(); pTarget++)
-        {
-            if (sFile == pTarget->GetPath())
-            {
-                pTarget->SetPrecreated(true);
-            }
-        }
+        double q = sqrt(-2.0 * log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
     }
-}
 
-void Profile::SetHistogramBucketList(ConstHistogramBucketListPtr vHistogramBucketList)
-{
-    _vHistogramBucketList = vHistogramBucketList;
-}
+    if (p > 1.0 - lfLow)
+    {
+        double q = sqrt(-2.0 * log(1.0 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
 
-ConstHistogramBucketListPtr Profile::GetHistogramBucketList() const
-{
-    return _vHistogramBucketList;
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
 }
 
-string Profile::GetXml() const
+// Riemann zeta partial sum, sum(k = 1..n) of k^-theta. The first terms are summed directly and the tail is
+// approximated with Euler-Maclaurin, which keeps initialization cheap on targets with billions of blocks.
+double OffsetDistribution::_Zeta(UINT64 n, double theta)
 {
-    string sXml("<Profile>\n");
-    char buffer[4096];
+    const UINT64 cExactTerms = 1024;
+    UINT64 m = std::min(n, cExactTerms);
+    double lfSum = 0;
 
-    sprintf_s(buffer, _countof(buffer), "<Progress>%u</Progress>\n", _dwProgress);
-    sXml += buffer;
+    for (UINT64 k = 1; k <= m; k++)
+    {
+        lfSum += pow(static_cast<double>(k), -theta);
+    }
+
+    if (n > m)
+    {
+        double a = static_cast<double>(m);
+        double b = static_cast<double>(n);
+
+        lfSum += (pow(b, 1.0 - theta) - pow(a, 1.0 - theta)) / (1.0 - theta);
+        lfSum += (pow(b, -theta) - pow(a, -theta)) / 2.0;
+        lfSum += theta * (pow(a, -theta - 1.0) - pow(b, -theta - 1.0)) / 12.0;
+    }
+
+    return lfSum;
+}
+
+void TargetSelector::Initialize()
+{
+    // Vose's construction over integer weights. Each column holds total/n of the weight: columns are
+    // scaled by n so that column weights compare exactly against the total.
+    size_t cTargets = _vTargets.size();
+    UINT64 ullTotalWeight = 0;
+    for (auto ulWeight : _vulWeights)
+    {
+        ullTotalWeight += ulWeight;
+    }
+
+    _vullThreshold.assign(cTargets, 1ULL << 32);
+    _vAlias.resize(cTargets);
+
+    if (cTargets == 0 || ullTotalWeight == 0)
+    {
+        return;
+    }
+
+    vector<UINT64> vullScaled(cTargets);
+    vector<UINT32> vSmall;
+    vector<UINT32> vLarge;
+    for (UINT32 i = 0; i < cTargets; i++)
+    {
+        vullScaled[i] = static_cast<UINT64>(_vulWeights[i]) * cTargets;
+        _vAlias[i] = i;
+        if (vullScaled[i] < ullTotalWeight)
+        {
+            vSmall.push_back(i);
+        }
+        else
+        {
+            vLarge.push_back(i);
+        }
+    }
+
+    while (!vSmall.empty() && !vLarge.empty())
+    {
+        UINT32 iSmall = vSmall.back();
+        vSmall.pop_back();
+        UINT32 iLarge = vLarge.back();
+
+        _vullThreshold[iSmall] = static_cast<UINT64>(static_cast<double>(vullScaled[iSmall]) / ullTotalWeight * (1ULL << 32));
+        _vAlias[iSmall] = iLarge;
+
+        // the large column donates what the small one lacks
+        vullScaled[iLarge] -= ullTotalWeight - vullScaled[iSmall];
+        if (vullScaled[iLarge] < ullTotalWeight)
+        {
+            vLarge.pop_back();
+            vSmall.push_back(iLarge);
+        }
+    }
+
+    // whatever is left is full, up to rounding
+    for (auto i : vSmall)
+    {
+        _vullThreshold[i] = 1ULL << 32;
+    }
+    for (auto i : vLarge)
+    {
+        _vullThreshold[i] = 1ULL << 32;
+    }
+}
+
+void SequentialStreams::Initialize(const Target& target, UINT64 ullThreadOffset, UINT64 ullLastOffset)
+{
+    UINT32 cStreams = target.GetSequentialStreamCount();
+    assert(cStreams > 0);
+
+    _ullStride = target.GetBlockAlignmentInBytes();
+    _ullLastOffset = ullLastOffset;
+    _ullWrapOffset = ullThreadOffset % _ullStride;
+    _ulReadRun = target.GetSequentialReadRun();
+    _ullSkip = static_cast<UINT64>(target.GetSequentialSkipRun()) * _ullStride;
+    _fReverse = target.GetUseReverseSequential();
+
+    // stream n starts n/cStreams of the way into the target, counted in strides from the thread's offset
+    UINT64 ullSpacing = (((ullLastOffset / _ullStride) + 1) / cStreams) * _ullStride;
+
+    _vStreams.resize(cStreams);
+    for (UINT32 iStream = 0; iStream < cStreams; iStream++)
+    {
+        UINT64 ullOffset = ullThreadOffset + iStream * ullSpacing;
+        _vStreams[iStream].ullOffset = (ullOffset > ullLastOffset) ? _ullWrapOffset : ullOffset;
+        _vStreams[iStream].ulRunCount = 0;
+    }
+    _iNextStream = 0;
+}
+
+bool AccessPatternPlugin::Load(const string& sPath)
+{
+    Unload();
+
+    _hModule = LoadLibraryExA(sPath.c_str(), nullptr, 0);
+    if (nullptr == _hModule)
+    {
+        return false;
+    }
+
+    auto pfnGetAccessPattern = reinterpret_cast<PDISKSPD_GET_ACCESS_PATTERN>(GetProcAddress(_hModule, DISKSPD_GET_ACCESS_PATTERN_EXPORT));
+    if (nullptr == pfnGetAccessPattern)
+    {
+        DWORD dwError = GetLastError();
+        Unload();
+        SetLastError(dwError);
+        return false;
+    }
+
+    // the plugin refuses interface versions it does not know
+    if (!pfnGetAccessPattern(DISKSPD_ACCESS_PATTERN_VERSION, &_accessPattern) ||
+        nullptr == _accessPattern.CreateState ||
+        nullptr == _accessPattern.Generate ||
+        nullptr == _accessPattern.DestroyState)
+    {
+        Unload();
+        SetLastError(ERROR_NOT_SUPPORTED);
+        return false;
+    }
+
+    return true;
+}
+
+void AccessPatternPlugin::Unload()
+{
+    if (nullptr != _hModule)
+    {
+        FreeLibrary(_hModule);
+        _hModule = nullptr;
+    }
+    memset(&_accessPattern, 0, sizeof(_accessPattern));
+}
+
+UINT64 GroupCommit::GetWaitTime(UINT64 ullTime) const
+{
+    UINT64 ullWaitTime = MAXUINT64;
+
+    for (const auto& committer : _vCommitters)
+    {
+        if (committer.iRequest != NOT_IN_GROUP)
+        {
+            continue;
+        }
+
+        if (committer.ullQueueTime <= ullTime)
+        {
+            return 0;
+        }
+
+        if (committer.ullQueueTime - ullTime < ullWaitTime)
+        {
+            ullWaitTime = committer.ullQueueTime - ullTime;
+        }
+    }
+
+    // MAXUINT64 if every committer waits for a group in flight
+    return ullWaitTime;
+}
+
+DWORD GroupCommit::TakeGroup(UINT32 iRequest, UINT64 ullTime)
+{
+    size_t cCommitters = _vCommitters.size();
+    DWORD cRecords = 0;
+
+    for (size_t i = 0; i < cCommitters && cRecords < _cMaxRecords; i++)
+    {
+        Committer& committer = _vCommitters[(_iNextCommitter + i) % cCommitters];
+        if (committer.iRequest == NOT_IN_GROUP && committer.ullQueueTime <= ullTime)
+        {
+            committer.iRequest = iRequest;
+            cRecords++;
+        }
+    }
+
+    _iNextCommitter = (_iNextCommitter + 1) % cCommitters;
+
+    return cRecords * _cbRecord;
+}
+
+UINT32 GroupCommit::Release(UINT32 iRequest, UINT64 ullTime, TargetResults *pTargetResults, bool fMeasureLatency)
+{
+    UINT32 cRecords = 0;
+
+    for (auto& committer : _vCommitters)
+    {
+        if (committer.iRequest != iRequest)
+        {
+            continue;
+        }
+
+        if (pTargetResults != nullptr)
+        {
+            pTargetResults->AddCommit(committer.ullQueueTime, ullTime, fMeasureLatency);
+        }
+
+        committer.iRequest = NOT_IN_GROUP;
+        committer.ullQueueTime = ullTime + _ullThinkTime;
+        cRecords++;
+    }
+
+    if (pTargetResults != nullptr && cRecords != 0)
+    {
+        pTargetResults->ullCommitGroupCount++;
+    }
+
+    return cRecords;
+}
+
+bool AppendLog::Initialize(const Target& target)
+{
+    _sPath = target.GetPath();
+    _ullSegmentSize = target.GetAppendSegmentSizeInBytes();
+    _ullPreallocationSize = target.GetAppendPreallocationSizeInBytes();
+    _ulSegment = 0;
+    _ullTotalBytes = 0;
+
+    return _CreateSegment();
+}
+
+void AppendLog::Close()
+{
+    if (INVALID_HANDLE_VALUE != _hSegment)
+    {
+        CloseHandle(_hSegment);
+        _hSegment = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool AppendLog::Append(DWORD cbTransfer, UINT32 *pulSegment, UINT64 *pullOffset)
+{
+    bool fOk = true;
+
+    AcquireSRWLockExclusive(&_srwLock);
+
+    // writes do not straddle segments: one which does not fit in the current segment starts the next
+    if (_ullSegmentSize != 0 && _ullTail != 0 && _ullTail + cbTransfer > _ullSegmentSize)
+    {
+        _ulSegment++;
+        fOk = _CreateSegment();
+    }
+
+    if (fOk && _ullPreallocationSize != 0 && _ullTail + cbTransfer > _ullAllocated)
+    {
+        UINT64 ullSize = Util::QuotientCeiling<UINT64>(_ullTail + cbTransfer, _ullPreallocationSize) * _ullPreallocationSize;
+        if (_ullSegmentSize != 0 && ullSize > _ullSegmentSize)
+        {
+            ullSize = _ullSegmentSize;
+        }
+        fOk = _Preallocate(ullSize);
+    }
+
+    if (fOk)
+    {
+        *pulSegment = _ulSegment;
+        *pullOffset = _ullTail;
+        _ullTail += cbTransfer;
+        _ullTotalBytes += cbTransfer;
+    }
+
+    ReleaseSRWLockExclusive(&_srwLock);
+    return fOk;
+}
+
+string AppendLog::GetSegmentPath(const string& sPath, UINT32 ulSegment)
+{
+    return (ulSegment == 0) ? sPath : sPath + "." + to_string(ulSegment);
+}
+
+bool AppendLog::_CreateSegment()
+{
+    Close();
+
+    string sSegmentPath = GetSegmentPath(_sPath, _ulSegment);
+    _hSegment = CreateFileA(sSegmentPath.c_str(),
+                            GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE,
+                            nullptr,
+                            CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+
+    _ullTail = 0;
+    _ullAllocated = 0;
+    return INVALID_HANDLE_VALUE != _hSegment;
+}
+
+bool AppendLog::_Preallocate(UINT64 ullSize)
+{
+    // allocation only reserves clusters; the file size still grows with the writes
+    FILE_ALLOCATION_INFO allocationInfo;
+    allocationInfo.AllocationSize.QuadPart = ullSize;
+    if (!SetFileInformationByHandle(_hSegment, FileAllocationInfo, &allocationInfo, sizeof(allocationInfo)))
+    {
+        return false;
+    }
+
+    _ullAllocated = ullSize;
+    return true;
+}
+
+void MetadataTree::Initialize(const Target& target, UINT32 ulThreadNo)
+{
+    string sPath = target.GetPath();
+    if (!sPath.empty() && sPath.back() == '\\')
+    {
+        sPath.pop_back();
+    }
+
+    _sRoot = sPath + "\\thread" + to_string(ulThreadNo);
+    _ulFanout = target.GetMetadataFanout();
+    _ulDepth = target.GetMetadataDepth();
+    _ulFilesPerDirectory = target.GetMetadataFilesPerDirectory();
+
+    _vulWeights.clear();
+    _ulTotalWeight = 0;
+    for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+    {
+        _vulWeights.push_back(target.GetMetadataWeight(static_cast<MetadataOperation>(i)));
+        _ulTotalWeight += _vulWeights[i];
+    }
+}
+
+bool MetadataTree::Build()
+{
+    // the target directory itself may already be there
+    string sTargetPath = _sRoot.substr(0, _sRoot.rfind('\\'));
+    if (!CreateDirectoryA(sTargetPath.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        return false;
+    }
+
+    _vsDirectories.clear();
+    if (!_BuildDirectory(_sRoot, 0))
+    {
+        return false;
+    }
+
+    UINT32 cSlots = static_cast<UINT32>(_vsDirectories.size()) * _ulFilesPerDirectory;
+    _vSlots.resize(cSlots);
+    _vulPositions.resize(cSlots);
+    _vfRenamed.assign(cSlots, false);
+    _cPresent = 0;
+
+    for (UINT32 iSlot = 0; iSlot < cSlots; iSlot++)
+    {
+        _vSlots[iSlot] = iSlot;
+        _vulPositions[iSlot] = iSlot;
+
+        // a file left under its second name by an earlier run would be a second copy
+        DeleteFileA(_GetFilePath(iSlot, true).c_str());
+
+        HANDLE hFile = CreateFileA(_GetFilePath(iSlot, false).c_str(),
+                                   GENERIC_WRITE,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   nullptr,
+                                   CREATE_ALWAYS,
+                                   FILE_ATTRIBUTE_NORMAL,
+                                   nullptr);
+        if (INVALID_HANDLE_VALUE == hFile)
+        {
+            return false;
+        }
+        CloseHandle(hFile);
+        _cPresent++;
+    }
+
+    return true;
+}
+
+bool MetadataTree::Remove()
+{
+    bool fOk = true;
+
+    if (_sRoot.empty())
+    {
+        return true;
+    }
+
+    // the slots do not say which files a failed build got to, so try both names of every file
+    UINT32 cSlots = static_cast<UINT32>(_vsDirectories.size()) * _ulFilesPerDirectory;
+    for (UINT32 iSlot = 0; iSlot < cSlots; iSlot++)
+    {
+        for (bool fRenamed : { false, true })
+        {
+            if (!DeleteFileA(_GetFilePath(iSlot, fRenamed).c_str()) &&
+                GetLastError() != ERROR_FILE_NOT_FOUND && GetLastError() != ERROR_PATH_NOT_FOUND)
+            {
+                fOk = false;
+            }
+        }
+    }
+
+    fOk = _RemoveDirectory(_sRoot, 0) && fOk;
+
+    _vsDirectories.clear();
+    _vSlots.clear();
+    _vulPositions.clear();
+    _vfRenamed.clear();
+    _cPresent = 0;
+
+    return fOk;
+}
+
+MetadataOperation MetadataTree::Next(Random *pRand, UINT32 *piSlot) const
+{
+    // scale to [0, n) by multiply and shift rather than modulo
+    UINT32 ulPick = static_cast<UINT32>((static_cast<UINT64>(pRand->Rand32()) * _ulTotalWeight) >> 32);
+    size_t iOperation = 0;
+    while (ulPick >= _vulWeights[iOperation])
+    {
+        ulPick -= _vulWeights[iOperation];
+        iOperation++;
+    }
+
+    MetadataOperation op = static_cast<MetadataOperation>(iOperation);
+    UINT32 cSlots = static_cast<UINT32>(_vSlots.size());
+
+    if (op == MetadataOperation::Create && _cPresent == cSlots)
+    {
+        op = MetadataOperation::Unlink;
+    }
+    else if (op != MetadataOperation::Create && _cPresent == 0)
+    {
+        op = MetadataOperation::Create;
+    }
+
+    if (op == MetadataOperation::Create)
+    {
+        *piSlot = _vSlots[_cPresent + static_cast<UINT32>((static_cast<UINT64>(pRand->Rand32()) * (cSlots - _cPresent)) >> 32)];
+    }
+    else
+    {
+        *piSlot = _vSlots[static_cast<UINT32>((static_cast<UINT64>(pRand->Rand32()) * _cPresent) >> 32)];
+    }
+
+    return op;
+}
+
+bool MetadataTree::Perform(MetadataOperation op, UINT32 iSlot)
+{
+    string sPath = _GetFilePath(iSlot, _vfRenamed[iSlot]);
+    HANDLE hFile;
+
+    switch (op)
+    {
+    case MetadataOperation::Create:
+        hFile = CreateFileA(_GetFilePath(iSlot, false).c_str(),
+                            GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            nullptr,
+                            CREATE_NEW,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+        if (INVALID_HANDLE_VALUE == hFile)
+        {
+            return false;
+        }
+        CloseHandle(hFile);
+        _vfRenamed[iSlot] = false;
+        _MarkPresent(iSlot, true);
+        break;
+
+    case MetadataOperation::Open:
+        hFile = CreateFileA(sPath.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+        if (INVALID_HANDLE_VALUE == hFile)
+        {
+            return false;
+        }
+        CloseHandle(hFile);
+        break;
+
+    case MetadataOperation::Stat:
+        {
+            WIN32_FILE_ATTRIBUTE_DATA attributeData;
+            if (!GetFileAttributesExA(sPath.c_str(), GetFileExInfoStandard, &attributeData))
+            {
+                return false;
+            }
+        }
+        break;
+
+    case MetadataOperation::Rename:
+        if (!MoveFileExA(sPath.c_str(), _GetFilePath(iSlot, !_vfRenamed[iSlot]).c_str(), 0))
+        {
+            return false;
+        }
+        _vfRenamed[iSlot] = !_vfRenamed[iSlot];
+        break;
+
+    case MetadataOperation::Unlink:
+        if (!DeleteFileA(sPath.c_str()))
+        {
+            return false;
+        }
+        _MarkPresent(iSlot, false);
+        break;
+    }
+
+    return true;
+}
+
+const char *MetadataTree::GetOperationName(MetadataOperation op)
+{
+    switch (op)
+    {
+    case MetadataOperation::Create:
+        return "Create";
+    case MetadataOperation::Open:
+        return "Open";
+    case MetadataOperation::Stat:
+        return "Stat";
+    case MetadataOperation::Rename:
+        return "Rename";
+    default:
+        return "Unlink";
+    }
+}
+
+bool MetadataTree::_BuildDirectory(const string& sPath, UINT32 ulLevel)
+{
+    if (!CreateDirectoryA(sPath.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        return false;
+    }
+
+    if (ulLevel == _ulDepth)
+    {
+        _vsDirectories.push_back(sPath);
+        return true;
+    }
+
+    for (UINT32 i = 0; i < _ulFanout; i++)
+    {
+        if (!_BuildDirectory(sPath + "\\d" + to_string(i), ulLevel + 1))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MetadataTree::_RemoveDirectory(const string& sPath, UINT32 ulLevel)
+{
+    bool fOk = true;
+
+    if (ulLevel < _ulDepth)
+    {
+        for (UINT32 i = 0; i < _ulFanout; i++)
+        {
+            fOk = _RemoveDirectory(sPath + "\\d" + to_string(i), ulLevel + 1) && fOk;
+        }
+    }
+
+    // a build which failed part of the way did not get to every directory
+    if (!RemoveDirectoryA(sPath.c_str()) &&
+        GetLastError() != ERROR_FILE_NOT_FOUND && GetLastError() != ERROR_PATH_NOT_FOUND)
+    {
+        fOk = false;
+    }
+
+    return fOk;
+}
+
+string MetadataTree::_GetFilePath(UINT32 iSlot, bool fRenamed) const
+{
+    string sPath = _vsDirectories[iSlot / _ulFilesPerDirectory] + "\\f" + to_string(iSlot % _ulFilesPerDirectory);
+    return fRenamed ? sPath + ".r" : sPath;
+}
+
+void MetadataTree::_MarkPresent(UINT32 iSlot, bool fPresent)
+{
+    // swap the slot with the one at the edge of its part, and move the edge over it
+    UINT32 iPosition = _vulPositions[iSlot];
+    UINT32 iEdge = fPresent ? _cPresent : _cPresent - 1;
+    UINT32 iOtherSlot = _vSlots[iEdge];
+
+    _vSlots[iEdge] = iSlot;
+    _vulPositions[iSlot] = iEdge;
+    _vSlots[iPosition] = iOtherSlot;
+    _vulPositions[iOtherSlot] = iPosition;
+
+    if (fPresent)
+    {
+        _cPresent++;
+    }
+    else
+    {
+        _cPresent--;
+    }
+}
+
+void TargetGeometry::Initialize(const Target& target, UINT64 ullFileSize)
+{
+    ullBaseFileOffset = target.GetBaseFileOffsetInBytes();
+    ullAlignment = target.GetBlockAlignmentInBytes();
+    assert(ullAlignment > 0);
+
+    fPowerOfTwoAlignment = ((ullAlignment & (ullAlignment - 1)) == 0);
+    ulAlignmentShift = 0;
+    if (fPowerOfTwoAlignment)
+    {
+        while ((1ULL << ulAlignmentShift) < ullAlignment)
+        {
+            ulAlignmentShift++;
+        }
+    }
+
+    // bound offsets by the largest block size so that any size drawn from a distribution fits
+    ullMaxBlockSize = target.GetMaxBlockSizeInBytes();
+    assert(ullFileSize >= ullBaseFileOffset + ullMaxBlockSize);
+
+    ullLastOffset = ullFileSize - ullBaseFileOffset - ullMaxBlockSize;
+    ullBlockCount = (ullLastOffset / ullAlignment) + 1;
+    ullOpenSize = ullBlockCount * ullAlignment;
+    ullOpenSizeReciprocal = ~0ULL / ullOpenSize;
+
+    ullRunStride = Util::QuotientCeiling<UINT64>(target.GetBlockSizeInBytes(), ullAlignment) * ullAlignment;
+}
+
+void BlockPermutation::Initialize(UINT64 ullBlockCount, UINT64 ullSeed, UINT32 ulThread, UINT32 cThreads)
+{
+    assert(ullBlockCount > 0);
+    assert(cThreads > 0 && ulThread < cThreads);
+
+    _ullBlockCount = ullBlockCount;
+
+    // smallest domain of 2 * half bits covering the blocks; cycle walking costs at most 4 rounds on average
+    _ulHalfBits = 1;
+    while (_ulHalfBits < 32 && (1ULL << (2 * _ulHalfBits)) < ullBlockCount)
+    {
+        _ulHalfBits++;
+    }
+    _ullHalfMask = (1ULL << _ulHalfBits) - 1;
+
+    _ullSeed = ullSeed;
+    _ullPass = 0;
+    _ullStride = cThreads;
+
+    // thread n starts at position n of the first pass; with more threads than blocks it lands in a later pass
+    _ullPosition = ulThread;
+    while (_ullPosition >= _ullBlockCount)
+    {
+        _ullPosition -= _ullBlockCount;
+        _ullPass++;
+    }
+    _SetRoundKeys();
+}
+
+void BlockPermutation::_SetRoundKeys()
+{
+    UINT64 ullPassKey = _Mix(_ullSeed ^ _Mix(_ullPass + 0x9e3779b97f4a7c15ULL));
+    for (UINT32 iRound = 0; iRound < _cRounds; iRound++)
+    {
+        ullPassKey = _Mix(ullPassKey + 0x9e3779b97f4a7c15ULL);
+        _ullRoundKeys[iRound] = ullPassKey;
+    }
+}
+
+string TimeSpan::GetXml() const
+{
+    string sXml("<TimeSpan>\n");
+    char buffer[4096];
+
+    sXml += _fCompletionRoutines ? "<CompletionRoutines>true</CompletionRoutines>\n" : "<CompletionRoutines>false</CompletionRoutines>\n";
+    if (_fIoRing)
+    {
+        sXml += "<IoRing>true</IoRing>\n";
+    }
+    if (_fIoRingSubmissionPoller)
+    {
+        sXml += "<IoRingSubmissionPoller>true</IoRingSubmissionPoller>\n";
+    }
+    if (_fEventCompletions)
+    {
+        sXml += "<EventCompletions>true</EventCompletions>\n";
+    }
+    if (_fPollCompletions)
+    {
+        sXml += "<PollCompletions>true</PollCompletions>\n";
+    }
+    if (_fSeparateReaper)
+    {
+        sXml += "<SeparateReaper>true</SeparateReaper>\n";
+    }
+    if (_dwCompletionPoolThreadCount > 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<CompletionPoolThreads>%u</CompletionPoolThreads>\n", _dwCompletionPoolThreadCount);
+        sXml += buffer;
+    }
+    sXml += _fMeasureLatency ? "<MeasureLatency>true</MeasureLatency>\n" : "<MeasureLatency>false</MeasureLatency>\n";
+    sXml += _fCalculateIopsStdDev ? "<CalculateIopsStdDev>true</CalculateIopsStdDev>\n" : "<CalculateIopsStdDev>false</CalculateIopsStdDev>\n";
+    sXml += _fDisableAffinity ? "<DisableAffinity>true</DisableAffinity>\n" : "<DisableAffinity>false</DisableAffinity>\n";
+
+    sprintf_s(buffer, _countof(buffer), "<Duration>%u</Duration>\n", _ulDuration);
+    sXml += buffer;
+
+    sprintf_s(buffer, _countof(buffer), "<Warmup>%u</Warmup>\n", _ulWarmUp);
+    sXml += buffer;
+
+    sprintf_s(buffer, _countof(buffer), "<Cooldown>%u</Cooldown>\n", _ulCoolDown);
+    sXml += buffer;
+
+    sprintf_s(buffer, _countof(buffer), "<ThreadCount>%u</ThreadCount>\n", _dwThreadCount);
+    sXml += buffer;
+
+    sprintf_s(buffer, _countof(buffer), "<RequestCount>%u</RequestCount>\n", _dwRequestCount);
+    sXml += buffer;
+
+    if (_dwBatchSize != 1)
+    {
+        sprintf_s(buffer, _countof(buffer), "<BatchSize>%u</BatchSize>\n", _dwBatchSize);
+        sXml += buffer;
+    }
+
+    if (_dwLookaheadDepth != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<LookaheadDepth>%u</LookaheadDepth>\n", _dwLookaheadDepth);
+        sXml += buffer;
+    }
+
+    if (!_sLookaheadDumpPath.empty())
+    {
+        sXml += "<LookaheadDumpPath>" + _sLookaheadDumpPath + "</LookaheadDumpPath>\n";
+    }
+
+    // WaitStrategy::Undefined is implied default
+    switch (_waitStrategy)
+    {
+    case WaitStrategy::Block:
+        sXml += "<WaitStrategy>Block</WaitStrategy>\n";
+        break;
+    case WaitStrategy::Poll:
+        sXml += "<WaitStrategy>Poll</WaitStrategy>\n";
+        break;
+    case WaitStrategy::SpinThenBlock:
+        sXml += "<WaitStrategy>SpinThenBlock</WaitStrategy>\n";
+        sprintf_s(buffer, _countof(buffer), "<SpinBudget>%u</SpinBudget>\n", _dwSpinBudgetInMicroseconds);
+        sXml += buffer;
+        break;
+    }
+
+    sprintf_s(buffer, _countof(buffer), "<IoBucketDuration>%u</IoBucketDuration>\n", _ulIoBucketDurationInMilliseconds);
+    sXml += buffer;
+
+    sprintf_s(buffer, _countof(buffer), "<RandSeed>%u</RandSeed>\n", _ulRandSeed);
+    sXml += buffer;
+
+    if (_vAffinity.size() > 0)
+    {
+        sXml += "<Affinity>\n";
+        for (const auto& a : _vAffinity)
+        {
+            sprintf_s(buffer, _countof(buffer), "<AffinityGroupAssignment Group=\"%u\" Processor=\"%u\"/>\n", a.wGroup, a.bProc);
+            sXml += buffer;
+        }
+        sXml += "</Affinity>\n";
+    }
+
+    sXml += "<Targets>\n";
+    for (const auto& target : _vTargets)
+    {
+        sXml += target.GetXml();
+    }
+    sXml += "</Targets>\n";
+    sXml += "</TimeSpan>\n";
+    return sXml;
+}
+
+void TimeSpan::MarkFilesAsPrecreated(const vector<string> vFiles)
+{
+    for (auto sFile : vFiles)
+    {
+        for (auto pTarget = _vTargets.begin(); pTarget != _vTargets.end(); pTarget++)
+        {
+            if (sFile == pTarget->GetPath())
+            {
+                pTarget->SetPrecreated(true);
+            }
+        }
+    }
+}
+
+void Profile::SetHistogramBucketList(ConstHistogramBucketListPtr vHistogramBucketList)
+{
+    _vHistogramBucketList = vHistogramBucketList;
+}
+
+ConstHistogramBucketListPtr Profile::GetHistogramBucketList() const
+{
+    return _vHistogramBucketList;
+}
+
+string Profile::GetXml() const
+{
+    string sXml("<Profile>\n");
+    char buffer[4096];
+
+    sprintf_s(buffer, _countof(buffer), "<Progress>%u</Progress>\n", _dwProgress);
+    sXml += buffer;
 
     if (_resultsFormat == ResultsFormat::Text)
     {
@@ -765,17 +1953,100 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                             Affinity.bProc,
                             pSystem->processorTopology._vProcessorGroupInformation[Affinity.wGroup]._activeProcessorMask);
 
-                        fOk = false;
-                    }
-                }
+                        fOk = false;
+                    }
+                }
+            }
+
+            if (timeSpan.GetDisableAffinity() && timeSpan.GetAffinityAssignments().size() > 0)
+            {
+                fprintf(stderr, "ERROR: -n and -a parameters cannot be used together\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetIoRing() && timeSpan.GetCompletionRoutines())
+            {
+                fprintf(stderr, "ERROR: I/O rings (-xr) cannot be used with -x completion routines\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetIoRingSubmissionPoller() && !timeSpan.GetIoRing())
+            {
+                fprintf(stderr, "ERROR: a submission poller (-xrp) can only be used with I/O rings\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetBatchSize() == 0)
+            {
+                fprintf(stderr, "ERROR: batch size (-q) must be at least 1\n");
+                fOk = false;
+            }
+
+            if (!timeSpan.GetLookaheadDumpPath().empty() && timeSpan.GetLookaheadDepth() == 0)
+            {
+                fprintf(stderr, "ERROR: dumping the lookahead (-kd) requires a lookahead depth (-k)\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetEventCompletions() && (timeSpan.GetCompletionRoutines() || timeSpan.GetIoRing()))
+            {
+                fprintf(stderr, "ERROR: event completions (-xe) cannot be used with -x completion routines or -xr I/O rings\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetEventCompletions() && timeSpan.GetRequestCount() > MAXIMUM_WAIT_OBJECTS)
+            {
+                fprintf(stderr, "ERROR: event completions (-xe) support at most %u outstanding I/Os per thread\n", MAXIMUM_WAIT_OBJECTS);
+                fOk = false;
+            }
+
+            if (timeSpan.GetPollCompletions() &&
+                (timeSpan.GetWaitStrategy() == WaitStrategy::Block || timeSpan.GetWaitStrategy() == WaitStrategy::SpinThenBlock))
+            {
+                fprintf(stderr, "ERROR: polled completions (-Q) never wait, and can only be used with the -Yp wait strategy\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetPollCompletions() && timeSpan.GetCompletionRoutines())
+            {
+                fprintf(stderr, "ERROR: polled completions (-Q) cannot be used with -x completion routines\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetSeparateReaper() &&
+                (timeSpan.GetCompletionRoutines() || timeSpan.GetIoRing() || timeSpan.GetEventCompletions() || timeSpan.GetPollCompletions()))
+            {
+                fprintf(stderr, "ERROR: separate completion reapers (-H) can only be used with I/O completion ports, not with -x, -xe, -xr or -Q\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetCompletionPoolThreadCount() > 0 &&
+                (timeSpan.GetCompletionRoutines() || timeSpan.GetIoRing() || timeSpan.GetEventCompletions() || timeSpan.GetPollCompletions()))
+            {
+                fprintf(stderr, "ERROR: a shared completion pool (-Hp) can only be used with I/O completion ports, not with -x, -xe, -xr or -Q\n");
+                fOk = false;
             }
 
-            if (timeSpan.GetDisableAffinity() && timeSpan.GetAffinityAssignments().size() > 0)
+            if (timeSpan.GetCompletionPoolThreadCount() > 0 && timeSpan.GetSeparateReaper())
             {
-                fprintf(stderr, "ERROR: -n and -a parameters cannot be used together\n");
+                fprintf(stderr, "ERROR: a shared completion pool (-Hp) cannot be used with per-thread completion reapers (-H)\n");
                 fOk = false;
             }
 
+            // a thread runs either a metadata workload or data I/O
+            {
+                size_t cMetadataTargets = 0;
+                for (const auto& target : timeSpan.GetTargets())
+                {
+                    cMetadataTargets += target.GetUseMetadata() ? 1 : 0;
+                }
+                if (cMetadataTargets != 0 && cMetadataTargets != timeSpan.GetTargets().size())
+                {
+                    fprintf(stderr, "ERROR: metadata targets (-M) can't be mixed with data targets in a time span\n");
+                    fOk = false;
+                }
+            }
+
             for (const auto& target : timeSpan.GetTargets())
             {
                 const bool targetHasMultipleThreads = (timeSpan.GetThreadCount() > 1) || (target.GetThreadsPerFile() > 1);
@@ -869,6 +2140,12 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                         fprintf(stderr, "ERROR: -p conflicts with -r\n");
                         fOk = false;
                     }
+
+                    if (target.GetUseSequentialStreams())
+                    {
+                        fprintf(stderr, "ERROR: sequential stream options (-sn, -sr, -sk) conflict with -r\n");
+                        fOk = false;
+                    }
                 }
                 else
                 {
@@ -883,6 +2160,27 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                         // although ulRandSeed==0 is a valid value, it's interpreted as "not provided" for this warning
                     }
 
+                    if (target.GetUseSequentialStreams())
+                    {
+                        if (target.GetSequentialStreamCount() == 0)
+                        {
+                            fprintf(stderr, "ERROR: -sn requires at least one stream\n");
+                            fOk = false;
+                        }
+
+                        if (target.GetUseInterlockedSequential())
+                        {
+                            fprintf(stderr, "ERROR: sequential stream options (-sn, -sr, -sk) conflict with -si\n");
+                            fOk = false;
+                        }
+
+                        if (target.GetUseParallelAsyncIO())
+                        {
+                            fprintf(stderr, "ERROR: sequential stream options (-sn, -sr, -sk) conflict with -p\n");
+                            fOk = false;
+                        }
+                    }
+
                     if (target.GetUseInterlockedSequential())
                     {
                         if (target.GetThreadStrideInBytes() > 0)
@@ -919,15 +2217,401 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
 
                 if (target.GetRandomDataWriteBufferSize() > 0)
                 {
-                    if (target.GetRandomDataWriteBufferSize() < target.GetBlockSizeInBytes())
+                    if (target.GetRandomDataWriteBufferSize() < target.GetMaxBlockSizeInBytes())
                     {
                         fprintf(stderr, "ERROR: custom write buffer (-Z) is smaller than the block size. Write buffer size: %I64u block size: %u\n",
                             target.GetRandomDataWriteBufferSize(),
-                            target.GetBlockSizeInBytes());
+                            target.GetMaxBlockSizeInBytes());
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetRandomRatio() != 100 ||
+                    target.GetMinSequentialRun() != 1 ||
+                    target.GetMaxSequentialRun() != 1)
+                {
+                    if (!target.GetUseRandomAccessPattern())
+                    {
+                        fprintf(stderr, "ERROR: mixed random/sequential I/O (-rs) requires random access\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetRandomRatio() == 0 || target.GetRandomRatio() > 100)
+                    {
+                        fprintf(stderr, "ERROR: random percentage (-rs) must be between 1 and 100\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetMinSequentialRun() == 0 || target.GetMaxSequentialRun() < target.GetMinSequentialRun())
+                    {
+                        fprintf(stderr, "ERROR: sequential run length (-rs) must be at least 1 I/O, with max >= min\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetUseRandomPermutation())
+                {
+                    if (!target.GetUseRandomAccessPattern())
+                    {
+                        fprintf(stderr, "ERROR: random without replacement (-rp) requires random access (-r)\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetRandomDistribution() != DistributionType::Uniform)
+                    {
+                        fprintf(stderr, "ERROR: random without replacement (-rp) cannot be combined with a random distribution (-rd)\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetUseAccessPatternPlugin() &&
+                    (target.GetUseRandomAccessPattern() ||
+                     target.GetUseInterlockedSequential() ||
+                     target.GetUseParallelAsyncIO() ||
+                     target.GetUseSequentialStreams()))
+                {
+                    fprintf(stderr, "ERROR: an access pattern plugin (-A) conflicts with -r, -si, -p, -sn, -sr and -sk\n");
+                    fOk = false;
+                }
+
+                if (target.GetModifyRatio() > 100)
+                {
+                    fprintf(stderr, "ERROR: write (-w), trim (-wt) and write-zeroes (-wz) percentages must add up to at most 100\n");
+                    fOk = false;
+                }
+
+                if (target.GetTrimRatio() != 0 || target.GetWriteZeroesRatio() != 0)
+                {
+                    if (timeSpan.GetCompletionRoutines() || timeSpan.GetIoRing())
+                    {
+                        fprintf(stderr, "ERROR: trim (-wt) and write-zeroes (-wz) cannot be used with -x completion routines or -xr I/O rings\n");
+                        fOk = false;
+                    }
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: trim (-wt) and write-zeroes (-wz) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (target.GetUseAccessPatternPlugin())
+                    {
+                        fprintf(stderr, "ERROR: trim (-wt) and write-zeroes (-wz) cannot be used with an access pattern plugin (-A)\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetDurableWriteRatio() != 0)
+                {
+                    if (target.GetDurableWriteRatio() > 100)
+                    {
+                        fprintf(stderr, "ERROR: durable write (-wd) percentage must be at most 100\n");
+                        fOk = false;
+                    }
+                    if (target.GetWriteRatio() == 0)
+                    {
+                        fprintf(stderr, "ERROR: durable writes (-wd) require writes (-w)\n");
+                        fOk = false;
+                    }
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: durable writes (-wd) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                }
+
+                if (((target.GetFlushIoInterval() != 0) + (target.GetFlushTimeIntervalInMilliseconds() != 0) + (target.GetFlushRatio() != 0)) > 1)
+                {
+                    fprintf(stderr, "ERROR: flushes can be scheduled by I/O count (-wf), time (-wft) or percentage (-wfp), but only one of them\n");
+                    fOk = false;
+                }
+
+                if (target.GetFlushRatio() > 100)
+                {
+                    fprintf(stderr, "ERROR: flush (-wfp) percentage must be at most 100\n");
+                    fOk = false;
+                }
+
+                if (target.GetFlushDataOnly() && !target.GetUseFlush() && !target.GetUseGroupCommit())
+                {
+                    fprintf(stderr, "ERROR: data-only flushes (-wfd) require a flush schedule (-wf, -wft or -wfp) or group commit (-wg)\n");
+                    fOk = false;
+                }
+
+                if (target.GetUseFlush())
+                {
+                    if (target.GetModifyRatio() == 0)
+                    {
+                        fprintf(stderr, "ERROR: flushes (-wf, -wft, -wfp) require writes (-w, -wt or -wz)\n");
+                        fOk = false;
+                    }
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: flushes (-wf, -wft, -wfp) can't be used with memory mapped IO (-Sm); use -N to flush the view\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetUseAppend())
+                {
+                    if (target.GetWriteRatio() != 100)
+                    {
+                        fprintf(stderr, "ERROR: append (-wa) requires a write-only target (-w100)\n");
+                        fOk = false;
+                    }
+                    if (target.GetUseRandomAccessPattern() ||
+                        target.GetUseInterlockedSequential() ||
+                        target.GetUseSequentialStreams() ||
+                        target.GetUseParallelAsyncIO() ||
+                        target.GetThreadStrideInBytes() > 0 ||
+                        target.GetUseAccessPatternPlugin())
+                    {
+                        fprintf(stderr, "ERROR: append (-wa) writes at the tail of the target, so it conflicts with -r, -si, -sn, -sr, -sk, -p, -T and -A\n");
+                        fOk = false;
+                    }
+                    if (target.GetFileSize() > 0 || target.GetBaseFileOffsetInBytes() > 0 || target.GetMaxFileSize() > 0)
+                    {
+                        fprintf(stderr, "ERROR: append (-wa) starts the target empty, so it conflicts with -c, -B and -f\n");
+                        fOk = false;
+                    }
+                    if (target.GetDurableWriteRatio() != 0)
+                    {
+                        fprintf(stderr, "ERROR: append (-wa) can't be used with durable writes (-wd); consider -Su or -Sw\n");
+                        fOk = false;
+                    }
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: append (-wa) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (target.GetAppendSegmentSizeInBytes() != 0 && target.GetAppendSegmentSizeInBytes() < target.GetMaxBlockSizeInBytes())
+                    {
+                        fprintf(stderr, "ERROR: append segment size (-was) must be at least the block size. Segment size: %I64u block size: %u\n",
+                            target.GetAppendSegmentSizeInBytes(),
+                            target.GetMaxBlockSizeInBytes());
+                        fOk = false;
+                    }
+                }
+                else if (target.GetAppendPreallocationSizeInBytes() != 0 || target.GetAppendSegmentSizeInBytes() != 0)
+                {
+                    fprintf(stderr, "ERROR: append preallocation (-wap) and segment size (-was) require append (-wa)\n");
+                    fOk = false;
+                }
+
+                if (target.GetUseGroupCommit())
+                {
+                    if (target.GetWriteRatio() != 100)
+                    {
+                        fprintf(stderr, "ERROR: group commit (-wg) requires a write-only target (-w100)\n");
+                        fOk = false;
+                    }
+                    if (target.GetCommitRecordSizeInBytes() == 0 || target.GetCommitRecordSizeInBytes() > target.GetMaxBlockSizeInBytes())
+                    {
+                        fprintf(stderr, "ERROR: commit record size (-wgr) must be non-zero and at most the block size. Record size: %u block size: %u\n",
+                            target.GetCommitRecordSizeInBytes(),
+                            target.GetMaxBlockSizeInBytes());
+                        fOk = false;
+                    }
+                    // a group is written as whole records, so unbuffered writes need whole sectors of them; the
+                    // target's own sector size, which may be larger, is checked when it is opened
+                    if (target.GetCacheMode() == TargetCacheMode::DisableOSCache && (target.GetCommitRecordSizeInBytes() % 512) != 0)
+                    {
+                        fprintf(stderr, "ERROR: with unbuffered IO (-Su or -Sh), commit record size (-wgr) must be a multiple of the 512 byte sector size. Record size: %u\n",
+                            target.GetCommitRecordSizeInBytes());
+                        fOk = false;
+                    }
+                    if (target.GetUseFlush())
+                    {
+                        fprintf(stderr, "ERROR: group commit (-wg) flushes each group, so it can't be used with -wf, -wft or -wfp\n");
+                        fOk = false;
+                    }
+                    if (target.GetDurableWriteRatio() != 0)
+                    {
+                        fprintf(stderr, "ERROR: group commit (-wg) can't be used with durable writes (-wd)\n");
+                        fOk = false;
+                    }
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: group commit (-wg) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (timeSpan.GetSeparateReaper() || timeSpan.GetCompletionPoolThreadCount() > 0)
+                    {
+                        fprintf(stderr, "ERROR: group commit (-wg) releases its committers on the issuing thread, so it can't be used with -H or -Hp\n");
+                        fOk = false;
+                    }
+                }
+                else if (target.GetCommitThinkTimeInMicroseconds() != 0)
+                {
+                    fprintf(stderr, "ERROR: commit think time (-wgt) requires group commit (-wg)\n");
+                    fOk = false;
+                }
+
+                if (target.GetUseMetadata())
+                {
+                    if (target.GetModifyRatio() != 0 ||
+                        target.GetUseRandomAccessPattern() ||
+                        target.GetFileSize() > 0 ||
+                        target.GetUseAppend() ||
+                        target.GetUseFlush() ||
+                        target.GetUseGroupCommit() ||
+                        target.GetUseAccessPatternPlugin() ||
+                        target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: metadata workloads (-M) issue no data I/O, so they conflict with -w, -r, -c, -wa, -wf, -wg, -A and -Sm\n");
+                        fOk = false;
+                    }
+                    if (target.GetMetadataFanout() == 0 || target.GetMetadataFilesPerDirectory() == 0)
+                    {
+                        fprintf(stderr, "ERROR: the directory tree of a metadata workload needs a fanout (-Mf) and files per directory (-Mn) of at least 1\n");
+                        fOk = false;
+                    }
+                    else if (target.GetMetadataFileCount() == 0 || target.GetMetadataFileCount() > MAX_METADATA_FILE_COUNT)
+                    {
+                        fprintf(stderr, "ERROR: the directory tree of a metadata workload (-Mf, -Md, -Mn) can have at most %u files per thread\n", MAX_METADATA_FILE_COUNT);
+                        fOk = false;
+                    }
+
+                    UINT64 ullTotalWeight = 0;
+                    for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+                    {
+                        ullTotalWeight += target.GetMetadataWeight(static_cast<MetadataOperation>(i));
+                    }
+                    if (ullTotalWeight == 0 || ullTotalWeight > MAXUINT32)
+                    {
+                        fprintf(stderr, "ERROR: the weights of the metadata operations (-Mw) must add up to at least 1 and at most %u\n", MAXUINT32);
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetDistributionDrift() != 0 && target.GetRandomDistribution() == DistributionType::Uniform)
+                {
+                    fprintf(stderr, "ERROR: moving the random distribution (-rdmove) requires a non-uniform distribution (-rd)\n");
+                    fOk = false;
+                }
+
+                if (target.GetRandomDistribution() != DistributionType::Uniform)
+                {
+                    if (!target.GetUseRandomAccessPattern())
+                    {
+                        fprintf(stderr, "ERROR: random distributions (-rd) require random access (-r)\n");
+                        fOk = false;
+                    }
+
+                    switch (target.GetRandomDistribution())
+                    {
+                    case DistributionType::Percent:
+                        {
+                            UINT32 ulIoPercent = 0;
+                            UINT32 ulTargetPercent = 0;
+
+                            for (const auto& range : target.GetDistributionRanges())
+                            {
+                                if (range.ulIoPercent == 0 || range.ulTargetPercent == 0)
+                                {
+                                    fprintf(stderr, "ERROR: -rdpct ranges must specify non-zero IO and target percentages\n");
+                                    fOk = false;
+                                }
+                                ulIoPercent += range.ulIoPercent;
+                                ulTargetPercent += range.ulTargetPercent;
+                            }
+
+                            if (target.GetDistributionRanges().size() == 0 || ulIoPercent > 100 || ulTargetPercent > 100)
+                            {
+                                fprintf(stderr, "ERROR: -rdpct IO and target percentages must each add up to at most 100\n");
+                                fOk = false;
+                            }
+                            else if (ulTargetPercent == 100 && ulIoPercent < 100)
+                            {
+                                fprintf(stderr, "ERROR: -rdpct covers the whole target but only %u%% of the IO\n", ulIoPercent);
+                                fOk = false;
+                            }
+                        }
+                        break;
+
+                    case DistributionType::Absolute:
+                        {
+                            UINT32 ulIoPercent = 0;
+
+                            for (const auto& range : target.GetDistributionRanges())
+                            {
+                                if (range.ulIoPercent == 0 || range.ullTargetBytes == 0)
+                                {
+                                    fprintf(stderr, "ERROR: -rdabs ranges must specify a non-zero IO percentage and size\n");
+                                    fOk = false;
+                                }
+                                ulIoPercent += range.ulIoPercent;
+                            }
+
+                            if (target.GetDistributionRanges().size() == 0 || ulIoPercent > 100)
+                            {
+                                fprintf(stderr, "ERROR: -rdabs IO percentages must add up to at most 100\n");
+                                fOk = false;
+                            }
+                        }
+                        break;
+
+                    case DistributionType::Zipf:
+                        if (!(target.GetZipfTheta() > 0 && target.GetZipfTheta() < 1))
+                        {
+                            fprintf(stderr, "ERROR: -rdzipf theta must be greater than 0 and less than 1\n");
+                            fOk = false;
+                        }
+                        break;
+
+                    case DistributionType::Pareto:
+                        if (target.GetParetoHotPercent() == 0 || target.GetParetoHotPercent() >= 50)
+                        {
+                            fprintf(stderr, "ERROR: -rdpareto hot percentage must be between 1 and 49\n");
+                            fOk = false;
+                        }
+                        break;
+
+                    case DistributionType::Normal:
+                        if (target.GetNormalCenterPercent() < 0 || target.GetNormalCenterPercent() > 100 || !(target.GetNormalStdDevPercent() > 0))
+                        {
+                            fprintf(stderr, "ERROR: -rdnormal needs a center between 0 and 100%% and a non-zero standard deviation\n");
+                            fOk = false;
+                        }
+                        break;
+
+                    default:
+                        break;
+                    }
+                }
+
+                for (auto ioType : { IOOperation::ReadIO, IOOperation::WriteIO })
+                {
+                    const auto& vBlockSizes = target.GetBlockSizeWeights(ioType);
+                    UINT64 ullTotalWeight = 0;
+
+                    for (const auto& blockSize : vBlockSizes)
+                    {
+                        if (blockSize.dwBlockSize == 0)
+                        {
+                            fprintf(stderr, "ERROR: block size distribution (-bd) contains a zero block size\n");
+                            fOk = false;
+                        }
+                        ullTotalWeight += blockSize.ulWeight;
+                    }
+
+                    if (vBlockSizes.size() > 0 && ullTotalWeight == 0)
+                    {
+                        fprintf(stderr, "ERROR: block size distribution (-bd) needs at least one non-zero weight\n");
                         fOk = false;
                     }
                 }
 
+                if (timeSpan.GetEventCompletions() && target.GetRequestCount() > MAXIMUM_WAIT_OBJECTS)
+                {
+                    fprintf(stderr, "ERROR: event completions (-xe) support at most %u outstanding I/Os per thread\n", MAXIMUM_WAIT_OBJECTS);
+                    fOk = false;
+                }
+
+                if (timeSpan.GetPollCompletions() && target.GetCacheMode() != TargetCacheMode::DisableOSCache)
+                {
+                    fprintf(stderr, "ERROR: polled completions (-Q) require unbuffered IO (-Su or -Sh)\n");
+                    fOk = false;
+                }
+
                 if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
                 {
                     if (timeSpan.GetCompletionRoutines())
@@ -935,6 +2619,26 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                         fprintf(stderr, "ERROR: completion routines (-x) can't be used with memory mapped IO (-Sm)\n");
                         fOk = false;
                     }
+                    if (timeSpan.GetIoRing())
+                    {
+                        fprintf(stderr, "ERROR: I/O rings (-xr) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (timeSpan.GetEventCompletions())
+                    {
+                        fprintf(stderr, "ERROR: event completions (-xe) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (timeSpan.GetSeparateReaper())
+                    {
+                        fprintf(stderr, "ERROR: separate completion reapers (-H) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (timeSpan.GetCompletionPoolThreadCount() > 0)
+                    {
+                        fprintf(stderr, "ERROR: a shared completion pool (-Hp) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
                     if (target.GetCacheMode() == TargetCacheMode::DisableOSCache)
                     {
                         fprintf(stderr, "ERROR: unbuffered IO (-Su or -Sh) can't be used with memory mapped IO (-Sm)\n");
@@ -985,7 +2689,8 @@ bool ThreadParameters::AllocateAndFillBufferForTarget(const Target& target)
             IO_REQUEST_BUFFERS ioRequestBuffers = { 0, nullptr, nullptr };
 
             // Create separate read & write buffers so the write content doesn't get overriden by reads
-            ioRequestBuffers.ulSize = (size_t)target.GetBlockSizeInBytes();
+            // Size the buffers for the largest IO a block size distribution can produce
+            ioRequestBuffers.ulSize = (size_t)target.GetMaxBlockSizeInBytes();
             if (target.GetUseLargePages())
             {
                 size_t cbMinLargePage = GetLargePageMinimum();
@@ -1055,7 +2760,7 @@ BYTE* ThreadParameters::GetReadBuffer(size_t iTarget, size_t iRequest)
     return vPerTargetIORequestBuffers[iTarget].vIORequestBuffers[iRequest].vpReadDataBuffer;
 }
 
-BYTE* ThreadParameters::GetWriteBuffer(size_t iTarget, size_t iRequest)
+BYTE* ThreadParameters::GetWriteBuffer(size_t iTarget, size_t iRequest, DWORD cbTransfer)
 {
     BYTE *pBuffer = nullptr;
     
@@ -1077,7 +2782,7 @@ BYTE* ThreadParameters::GetWriteBuffer(size_t iTarget, size_t iRequest)
         if (pTimeSpan->GetRandomWriteData() &&
             !target.GetZeroWriteBuffers())
         {
-            pRand->RandBuffer(pBuffer, vTargets[iTarget].GetBlockSizeInBytes(), true);
+            pRand->RandBuffer(pBuffer, cbTransfer, true);
         }
     }
     else
@@ -1166,6 +2871,14 @@ void EtwResultParser::ParseResults(vector<Results> vResults)
                     {
                         _WriteResults(IOOperation::WriteIO, targetResults, ullThread);
                     }
+                    if (targetResults.ullTrimIOCount)
+                    {
+                        _WriteResults(IOOperation::TrimIO, targetResults, ullThread);
+                    }
+                    if (targetResults.ullWriteZeroesIOCount)
+                    {
+                        _WriteResults(IOOperation::WriteZeroesIO, targetResults, ullThread);
+                    }
                 }
             }
         }
@@ -1174,13 +2887,33 @@ void EtwResultParser::ParseResults(vector<Results> vResults)
 
 void EtwResultParser::_WriteResults(IOOperation type, const TargetResults& targetResults, size_t ullThread)
 {
-    UINT64 ullIOCount = (type == IOOperation::ReadIO) ? targetResults.ullReadIOCount : targetResults.ullWriteIOCount;
-    UINT64 ullBytesCount = (type == IOOperation::ReadIO) ? targetResults.ullReadBytesCount : targetResults.ullWriteBytesCount;
+    UINT64 ullIOCount = targetResults.ullReadIOCount;
+    UINT64 ullBytesCount = targetResults.ullReadBytesCount;
+    const char *pszType = "Read";
+
+    if (type == IOOperation::WriteIO)
+    {
+        ullIOCount = targetResults.ullWriteIOCount;
+        ullBytesCount = targetResults.ullWriteBytesCount;
+        pszType = "Write";
+    }
+    else if (type == IOOperation::TrimIO)
+    {
+        ullIOCount = targetResults.ullTrimIOCount;
+        ullBytesCount = targetResults.ullTrimBytesCount;
+        pszType = "Trim";
+    }
+    else if (type == IOOperation::WriteZeroesIO)
+    {
+        ullIOCount = targetResults.ullWriteZeroesIOCount;
+        ullBytesCount = targetResults.ullWriteZeroesBytesCount;
+        pszType = "WriteZeroes";
+    }
 
     TraceLoggingWrite(g_hEtwProvider,
                       "Statistics",
                       TraceLoggingLevel((TRACE_LEVEL_NONE)),
-                      TraceLoggingString((type == IOOperation::ReadIO) ? "Read" : "Write", "IO Type"),
+                      TraceLoggingString(pszType, "IO Type"),
                       TraceLoggingUInt64(ullThread, "Thread"),
                       TraceLoggingUInt64(ullBytesCount, "Bytes"),
                       TraceLoggingUInt64(ullIOCount, "IO Count"),
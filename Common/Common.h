@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include "MinWindows.h"
 
+#include "AccessPatternPlugin.h"
 #include "Histogram.h"
 #include "IoBucketizer.h"
 #include "ThroughputMeter.h"
@@ -38,7 +39,9 @@ SOFTWARE.
 #include <TraceLoggingProvider.h>
 #include <TraceLoggingActivity.h>
 #include <assert.h>
+#include <intrin.h>
 
+#include <cmath>
 #include <ctime>
 #include <vector>
 
@@ -241,15 +244,44 @@ public:
     {
         return (dividend + divisor - 1) / divisor;
     }
+
+    // high 64 bits of the 128 bit product; MultiplyHigh64(x, n) maps a uniform x onto [0, n) without a division
+    static UINT64 MultiplyHigh64(UINT64 a, UINT64 b)
+    {
+#if defined(_M_X64) || defined(_M_ARM64)
+        return __umulh(a, b);
+#else
+        UINT64 ullLoLo = (a & 0xffffffff) * (b & 0xffffffff);
+        UINT64 ullHiLo = (a >> 32) * (b & 0xffffffff);
+        UINT64 ullLoHi = (a & 0xffffffff) * (b >> 32);
+        UINT64 ullCross = (ullLoLo >> 32) + (ullHiLo & 0xffffffff) + ullLoHi;
+        return (a >> 32) * (b >> 32) + (ullHiLo >> 32) + (ullCross >> 32);
+#endif
+    }
 };
 
 // To keep track of which type of IO was issued
 enum class IOOperation
 {
     ReadIO = 1,
-    WriteIO
+    WriteIO,
+    TrimIO,             // discard the range: file-level trim on files, DSM trim on disks and partitions
+    WriteZeroesIO       // zero the range without transferring data (FSCTL_SET_ZERO_DATA)
 };
 
+// To keep track of which operation a metadata workload (-M) performed; also indexes its per-operation results
+enum class MetadataOperation
+{
+    Create = 0,
+    Open,               // open and close an existing file
+    Stat,               // query the attributes of a file by its name
+    Rename,
+    Unlink
+};
+
+#define METADATA_OPERATION_COUNT 5
+#define MAX_METADATA_FILE_COUNT (16 * 1024 * 1024)     // per thread and target
+
 class TargetResults
 {
 public:
@@ -261,7 +293,18 @@ public:
         ullReadBytesCount(0),
         ullReadIOCount(0),
         ullWriteBytesCount(0),
-        ullWriteIOCount(0)
+        ullWriteIOCount(0),
+        ullTrimBytesCount(0),
+        ullTrimIOCount(0),
+        ullWriteZeroesBytesCount(0),
+        ullWriteZeroesIOCount(0),
+        ullDurableWriteBytesCount(0),
+        ullDurableWriteIOCount(0),
+        ullFlushCount(0),
+        ullCommitCount(0),
+        ullCommitGroupCount(0),
+        vullMetadataOperationCounts(METADATA_OPERATION_COUNT, 0),
+        vMetadataLatencyHistograms(METADATA_OPERATION_COUNT)
     {
 
     }
@@ -276,10 +319,32 @@ public:
         ullReadIOCount(rhs.ullReadIOCount),
         ullWriteBytesCount(rhs.ullWriteBytesCount),
         ullWriteIOCount(rhs.ullWriteIOCount),
+        ullTrimBytesCount(rhs.ullTrimBytesCount),
+        ullTrimIOCount(rhs.ullTrimIOCount),
+        ullWriteZeroesBytesCount(rhs.ullWriteZeroesBytesCount),
+        ullWriteZeroesIOCount(rhs.ullWriteZeroesIOCount),
+        ullDurableWriteBytesCount(rhs.ullDurableWriteBytesCount),
+        ullDurableWriteIOCount(rhs.ullDurableWriteIOCount),
+        ullFlushCount(rhs.ullFlushCount),
+        ullCommitCount(rhs.ullCommitCount),
+        ullCommitGroupCount(rhs.ullCommitGroupCount),
         readLatencyHistogram(rhs.readLatencyHistogram),
         writeLatencyHistogram(rhs.writeLatencyHistogram),
+        trimLatencyHistogram(rhs.trimLatencyHistogram),
+        writeZeroesLatencyHistogram(rhs.writeZeroesLatencyHistogram),
+        durableWriteLatencyHistogram(rhs.durableWriteLatencyHistogram),
+        flushLatencyHistogram(rhs.flushLatencyHistogram),
+        commitLatencyHistogram(rhs.commitLatencyHistogram),
         readBucketizer(rhs.readBucketizer),
-        writeBucketizer(rhs.writeBucketizer)
+        writeBucketizer(rhs.writeBucketizer),
+        trimBucketizer(rhs.trimBucketizer),
+        writeZeroesBucketizer(rhs.writeZeroesBucketizer),
+        durableWriteBucketizer(rhs.durableWriteBucketizer),
+        vBlockSizes(rhs.vBlockSizes),
+        vReadBlockSizeLatencyHistograms(rhs.vReadBlockSizeLatencyHistograms),
+        vWriteBlockSizeLatencyHistograms(rhs.vWriteBlockSizeLatencyHistograms),
+        vullMetadataOperationCounts(rhs.vullMetadataOperationCounts),
+        vMetadataLatencyHistograms(rhs.vMetadataLatencyHistograms)
     {
     }
 
@@ -306,16 +371,63 @@ public:
         ullReadIOCount += targetResults.ullReadIOCount;
         ullWriteBytesCount += targetResults.ullWriteBytesCount;
         ullWriteIOCount += targetResults.ullWriteIOCount;
+        ullTrimBytesCount += targetResults.ullTrimBytesCount;
+        ullTrimIOCount += targetResults.ullTrimIOCount;
+        ullWriteZeroesBytesCount += targetResults.ullWriteZeroesBytesCount;
+        ullWriteZeroesIOCount += targetResults.ullWriteZeroesIOCount;
+        ullDurableWriteBytesCount += targetResults.ullDurableWriteBytesCount;
+        ullDurableWriteIOCount += targetResults.ullDurableWriteIOCount;
+        ullFlushCount += targetResults.ullFlushCount;
+        ullCommitCount += targetResults.ullCommitCount;
+        ullCommitGroupCount += targetResults.ullCommitGroupCount;
 
         readLatencyHistogram.Merge(targetResults.readLatencyHistogram);
         writeLatencyHistogram.Merge(targetResults.writeLatencyHistogram);
+        trimLatencyHistogram.Merge(targetResults.trimLatencyHistogram);
+        writeZeroesLatencyHistogram.Merge(targetResults.writeZeroesLatencyHistogram);
+        durableWriteLatencyHistogram.Merge(targetResults.durableWriteLatencyHistogram);
+        flushLatencyHistogram.Merge(targetResults.flushLatencyHistogram);
+        commitLatencyHistogram.Merge(targetResults.commitLatencyHistogram);
 
         readBucketizer.Merge(targetResults.readBucketizer);
         writeBucketizer.Merge(targetResults.writeBucketizer);
+        trimBucketizer.Merge(targetResults.trimBucketizer);
+        writeZeroesBucketizer.Merge(targetResults.writeZeroesBucketizer);
+        durableWriteBucketizer.Merge(targetResults.durableWriteBucketizer);
+
+        if (vBlockSizes != targetResults.vBlockSizes)
+        {
+            throw std::runtime_error("Invalid vBlockSizes added to TargetResultsGroup");
+        }
+
+        for (size_t i = 0; i < vBlockSizes.size(); i++)
+        {
+            vReadBlockSizeLatencyHistograms[i].Merge(targetResults.vReadBlockSizeLatencyHistograms[i]);
+            vWriteBlockSizeLatencyHistograms[i].Merge(targetResults.vWriteBlockSizeLatencyHistograms[i]);
+        }
+
+        for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+        {
+            vullMetadataOperationCounts[i] += targetResults.vullMetadataOperationCounts[i];
+            vMetadataLatencyHistograms[i].Merge(targetResults.vMetadataLatencyHistograms[i]);
+        }
+    }
+
+    // size classes of the target's block size distribution, in ascending order; each gets its own
+    // latency histograms so small IOs queued behind large ones can be told apart
+    void SetBlockSizeClasses(const vector<DWORD>& vdwBlockSizes)
+    {
+        vBlockSizes = vdwBlockSizes;
+        vReadBlockSizeLatencyHistograms.clear();
+        vReadBlockSizeLatencyHistograms.resize(vBlockSizes.size());
+        vWriteBlockSizeLatencyHistograms.clear();
+        vWriteBlockSizeLatencyHistograms.resize(vBlockSizes.size());
     }
 
     void Add(DWORD dwBytesTransferred,
+             DWORD dwBlockSize,
              IOOperation type,
+             bool fDurable,
              UINT64 ullIoStartTime,
              UINT64 ullSpanStartTime,
              bool fMeasureLatency,
@@ -340,9 +452,38 @@ public:
             {
                 readLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
             }
-            else
+            else if (type == IOOperation::WriteIO)
             {
                 writeLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                if (fDurable)
+                {
+                    durableWriteLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                }
+            }
+            else if (type == IOOperation::TrimIO)
+            {
+                trimLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+            }
+            else
+            {
+                writeZeroesLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+            }
+
+            // size classes only cover the data transfers
+            for (size_t i = 0; i < vBlockSizes.size(); i++)
+            {
+                if (vBlockSizes[i] == dwBlockSize)
+                {
+                    if (type == IOOperation::ReadIO)
+                    {
+                        vReadBlockSizeLatencyHistograms[i].Add(static_cast<float>(lfDurationUsec));
+                    }
+                    else if (type == IOOperation::WriteIO)
+                    {
+                        vWriteBlockSizeLatencyHistograms[i].Add(static_cast<float>(lfDurationUsec));
+                    }
+                    break;
+                }
             }
         }
 
@@ -355,9 +496,21 @@ public:
             {
                 readBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
             }
-            else
+            else if (type == IOOperation::WriteIO)
             {
                 writeBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+                if (fDurable)
+                {
+                    durableWriteBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+                }
+            }
+            else if (type == IOOperation::TrimIO)
+            {
+                trimBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+            }
+            else
+            {
+                writeZeroesBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
             }
         }
 
@@ -366,16 +519,81 @@ public:
             ullReadBytesCount += dwBytesTransferred;    // update read bytes counter
             ullReadIOCount++;                           // update completed read I/O operations counter
         }
-        else
+        else if (type == IOOperation::WriteIO)
         {
             ullWriteBytesCount += dwBytesTransferred;   // update write bytes counter
             ullWriteIOCount++;                          // update completed write I/O operations counter
+            if (fDurable)
+            {
+                ullDurableWriteBytesCount += dwBytesTransferred;    // durable writes are counted among the writes as well
+                ullDurableWriteIOCount++;
+            }
+        }
+        else if (type == IOOperation::TrimIO)
+        {
+            ullTrimBytesCount += dwBytesTransferred;    // update trimmed bytes counter
+            ullTrimIOCount++;                           // update completed trim operations counter
+        }
+        else
+        {
+            ullWriteZeroesBytesCount += dwBytesTransferred; // update zeroed bytes counter
+            ullWriteZeroesIOCount++;                        // update completed write-zeroes operations counter
         }
 
         ullBytesCount += dwBytesTransferred;            // update bytes counter
         ullIOCount++;                                   // update completed I/O operations counter
     }
 
+    // flushes are not I/O operations of their own: they are counted apart from the I/O and
+    // transfer counters, and their latency goes to its own histogram
+    void AddFlush(UINT64 ullFlushStartTime, bool fMeasureLatency)
+    {
+        if (fMeasureLatency)
+        {
+            double lfDurationUsec = PerfTimer::PerfTimeToMicroseconds(PerfTimer::GetTime() - ullFlushStartTime);
+            flushLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+        }
+
+        ullFlushCount++;
+    }
+
+    // a commit is a record of a group commit (-wg); its latency is what the committer sees,
+    // from queueing the record until the flush of its group completed
+    void AddCommit(UINT64 ullQueueTime, UINT64 ullReleaseTime, bool fMeasureLatency)
+    {
+        if (fMeasureLatency)
+        {
+            double lfDurationUsec = PerfTimer::PerfTimeToMicroseconds(ullReleaseTime - ullQueueTime);
+            commitLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+        }
+
+        ullCommitCount++;
+    }
+
+    // metadata operations (-M) move no data either; each kind has its own counter and histogram
+    void AddMetadataOperation(MetadataOperation op, UINT64 ullStartTime, bool fMeasureLatency)
+    {
+        size_t iOperation = static_cast<size_t>(op);
+
+        if (fMeasureLatency)
+        {
+            double lfDurationUsec = PerfTimer::PerfTimeToMicroseconds(PerfTimer::GetTime() - ullStartTime);
+            vMetadataLatencyHistograms[iOperation].Add(static_cast<float>(lfDurationUsec));
+        }
+
+        vullMetadataOperationCounts[iOperation]++;
+    }
+
+    UINT64 GetMetadataOperationCount() const
+    {
+        UINT64 ullCount = 0;
+        for (auto ullOperationCount : vullMetadataOperationCounts)
+        {
+            ullCount += ullOperationCount;
+        }
+        return ullCount;
+    }
+
     int iTargetID;
     string sPath;
     UINT64 ullFileSize;         //size of the file
@@ -385,12 +603,36 @@ public:
     UINT64 ullReadIOCount;      //number of performed Read I/O operations
     UINT64 ullWriteBytesCount;  //number of bytes written
     UINT64 ullWriteIOCount;     //number of performed Write I/O operations
+    UINT64 ullTrimBytesCount;           //number of bytes trimmed
+    UINT64 ullTrimIOCount;              //number of performed Trim operations
+    UINT64 ullWriteZeroesBytesCount;    //number of bytes zeroed
+    UINT64 ullWriteZeroesIOCount;       //number of performed Write Zeroes operations
+    UINT64 ullDurableWriteBytesCount;   //number of bytes written by durable writes (-wd); included in ullWriteBytesCount
+    UINT64 ullDurableWriteIOCount;      //number of performed durable Write I/O operations; included in ullWriteIOCount
+    UINT64 ullFlushCount;               //number of performed flushes (-wf, -wft, -wfp, -wg)
+    UINT64 ullCommitCount;              //number of released commit records (-wg)
+    UINT64 ullCommitGroupCount;         //number of committed groups (-wg); each is one write and one flush
 
     Histogram<float> readLatencyHistogram;
     Histogram<float> writeLatencyHistogram;
+    Histogram<float> trimLatencyHistogram;
+    Histogram<float> writeZeroesLatencyHistogram;
+    Histogram<float> durableWriteLatencyHistogram;  //subset of writeLatencyHistogram
+    Histogram<float> flushLatencyHistogram;
+    Histogram<float> commitLatencyHistogram;        //queue wait, group write and flush of each commit record
 
     IoBucketizer readBucketizer;
     IoBucketizer writeBucketizer;
+    IoBucketizer trimBucketizer;
+    IoBucketizer writeZeroesBucketizer;
+    IoBucketizer durableWriteBucketizer;    //subset of writeBucketizer
+
+    vector<DWORD> vBlockSizes;                                  //size classes of the block size distribution (empty if none)
+    vector<Histogram<float>> vReadBlockSizeLatencyHistograms;   //per size class, parallel to vBlockSizes
+    vector<Histogram<float>> vWriteBlockSizeLatencyHistograms;
+
+    vector<UINT64> vullMetadataOperationCounts;                 //per MetadataOperation (-M)
+    vector<Histogram<float>> vMetadataLatencyHistograms;        //per MetadataOperation
 };
 
 class TargetIDGroup
@@ -426,7 +668,35 @@ private:
 class ThreadResults
 {
 public:
+    ThreadResults() :
+        ullKernelTime(0),
+        ullUserTime(0),
+        ullSubmitCalls(0),
+        ullSubmittedIOs(0),
+        ullReapCalls(0),
+        ullReapedIOs(0),
+        ullHelperKernelTime(0),
+        ullHelperUserTime(0)
+    {
+    }
+
     vector<TargetResults> vTargetResults;
+
+    // CPU time of the worker thread itself during the measured interval (100ns units)
+    UINT64 ullKernelTime;
+    UINT64 ullUserTime;
+
+    // asynchronous I/Os handed to the system and completions reaped during the measured interval,
+    // and the number of calls each took
+    UINT64 ullSubmitCalls;
+    UINT64 ullSubmittedIOs;
+    UINT64 ullReapCalls;
+    UINT64 ullReapedIOs;
+
+    // CPU time of the thread's helper (I/O ring submission poller or completion reaper)
+    // during the measured interval (100ns units)
+    UINT64 ullHelperKernelTime;
+    UINT64 ullHelperUserTime;
 };
 
 class Results
@@ -437,6 +707,7 @@ public:
     struct ETWMask EtwMask;
     struct ETWSessionInfo EtwSessionInfo;
     vector<ThreadResults> vThreadResults;
+    vector<ThreadResults> vCompletionPoolResults;   // CPU time and reaping of the shared completion pool (-Hp), if any
     UINT64 ullTimeCount;
     vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> vSystemProcessorPerfInfo;
 };
@@ -944,6 +1215,49 @@ enum class MemoryMappedIoFlushMode {
     NonVolatileMemoryNoDrain,
 };
 
+// completion wait strategies
+// Undefined -> default, equivalent to Block
+enum class WaitStrategy {
+    Undefined = 0,
+    Block,              // wait in the kernel for the next completion (-Yb)
+    Poll,               // never wait; spin checking for completions (-Yp)
+    SpinThenBlock,      // spin for up to the spin budget, then wait (-Ys)
+};
+
+// offset distributions for random access
+// Uniform -> default, every aligned offset is equally likely
+enum class DistributionType {
+    Uniform = 0,
+    Percent,            // hot/cold ranges, IO% to target% (-rdpct)
+    Absolute,           // hot/cold ranges, IO% to a size in bytes (-rdabs)
+    Zipf,               // Zipf(theta) over the block index (-rdzipf)
+    Pareto,             // self-similar skew, e.g. 80% of IO to 20% of the target (-rdpareto)
+    Normal,             // normal distribution around a center of the target (-rdnormal)
+};
+
+class DistributionRange
+{
+public:
+    UINT32 ulIoPercent;
+    UINT32 ulTargetPercent;
+    UINT64 ullTargetBytes;      // size of the range for absolute distributions, otherwise 0
+
+    DistributionRange() = delete;
+    DistributionRange(UINT32 p_ulIoPercent, UINT32 p_ulTargetPercent) :
+        ulIoPercent(p_ulIoPercent),
+        ulTargetPercent(p_ulTargetPercent),
+        ullTargetBytes(0)
+    {
+    }
+
+    DistributionRange(UINT32 p_ulIoPercent, UINT32 p_ulTargetPercent, UINT64 p_ullTargetBytes) :
+        ulIoPercent(p_ulIoPercent),
+        ulTargetPercent(p_ulTargetPercent),
+        ullTargetBytes(p_ullTargetBytes)
+    {
+    }
+};
+
 class ThreadTarget
 {
 public:
@@ -967,6 +1281,22 @@ private:
     UINT32 _ulWeight;
 };
 
+class BlockSizeWeight
+{
+public:
+    DWORD dwBlockSize;
+    UINT32 ulWeight;
+
+    BlockSizeWeight() = delete;
+    BlockSizeWeight(DWORD p_dwBlockSize, UINT32 p_ulWeight) :
+        dwBlockSize(p_dwBlockSize),
+        ulWeight(p_ulWeight)
+    {
+    }
+
+    string GetXml() const;
+};
+
 class Target
 {
 public:
@@ -978,9 +1308,17 @@ public:
         _ullBlockAlignment(64 * 1024),
         _fBlockAlignmentValid(false),
         _fUseRandomAccessPattern(false),
+        _fUseRandomPermutation(false),
+        _ulRandomRatio(100),
+        _ulMinSequentialRun(1),
+        _ulMaxSequentialRun(1),
         _ullBaseFileOffset(0),
         _fParallelAsyncIO(false),
         _fInterlockedSequential(false),
+        _ulSequentialStreams(1),
+        _fReverseSequential(false),
+        _ulSequentialReadRun(0),
+        _ulSequentialSkipRun(0),
         _cacheMode(TargetCacheMode::Cached),
         _writeThroughMode(WriteThroughMode::Off),
         _memoryMappedIoMode(MemoryMappedIoMode::Off),
@@ -994,6 +1332,24 @@ public:
         _ullFileSize(0),
         _ullMaxFileSize(0),
         _ulWriteRatio(0),
+        _ulTrimRatio(0),
+        _ulWriteZeroesRatio(0),
+        _ulDurableWriteRatio(0),
+        _ulFlushIoInterval(0),
+        _ulFlushTimeInterval(0),
+        _ulFlushRatio(0),
+        _fFlushDataOnly(false),
+        _fAppend(false),
+        _ullAppendPreallocationSize(0),
+        _ullAppendSegmentSize(0),
+        _ulCommitterCount(0),
+        _dwCommitRecordSize(4096),
+        _ulCommitThinkTime(0),
+        _fMetadata(false),
+        _ulMetadataFanout(4),
+        _ulMetadataDepth(2),
+        _ulMetadataFilesPerDirectory(64),
+        _vulMetadataWeights(METADATA_OPERATION_COUNT, 1),
         _fUseBurstSize(false),
         _dwBurstSize(0),
         _dwThinkTime(0),
@@ -1004,8 +1360,17 @@ public:
         _fUseLargePages(false),
         _mappedViewFileHandle(INVALID_HANDLE_VALUE),
         _mappedView(NULL),
+        _fDeviceTarget(false),
         _ioPriorityHint(IoPriorityHintNormal),
         _ulWeight(1),
+        _ullReadBlockSizeWeight(0),
+        _ullWriteBlockSizeWeight(0),
+        _distributionType(DistributionType::Uniform),
+        _lfZipfTheta(0),
+        _ulParetoHotPercent(0),
+        _lfNormalCenterPercent(50),
+        _lfNormalStdDevPercent(0),
+        _ullDistributionDrift(0),
         _dwThroughputBytesPerMillisecond(0),
         _cbRandomDataWriteBuffer(0),
         _sRandomDataWriteBufferSourcePath(),
@@ -1021,6 +1386,56 @@ public:
     void SetBlockSizeInBytes(DWORD dwBlockSize) { _dwBlockSize = dwBlockSize; }
     DWORD GetBlockSizeInBytes() const { return _dwBlockSize; }
 
+    // weighted block size distributions, one for reads and one for writes
+    // an IO type without a distribution uses the fixed block size
+    void AddBlockSizeWeight(IOOperation ioType, DWORD dwBlockSize, UINT32 ulWeight)
+    {
+        if (ioType == IOOperation::ReadIO)
+        {
+            _vReadBlockSizes.emplace_back(dwBlockSize, ulWeight);
+            _ullReadBlockSizeWeight += ulWeight;
+        }
+        else
+        {
+            _vWriteBlockSizes.emplace_back(dwBlockSize, ulWeight);
+            _ullWriteBlockSizeWeight += ulWeight;
+        }
+    }
+    const vector<BlockSizeWeight>& GetBlockSizeWeights(IOOperation ioType) const
+    {
+        return (ioType == IOOperation::ReadIO) ? _vReadBlockSizes : _vWriteBlockSizes;
+    }
+    bool GetUseBlockSizeDistribution() const { return !_vReadBlockSizes.empty() || !_vWriteBlockSizes.empty(); }
+
+    // largest size any IO to this target may use; buffers and offset bounds are sized to it
+    DWORD GetMaxBlockSizeInBytes() const;
+    // distinct sizes used by the target's IOs in ascending order, empty if no distribution is used
+    vector<DWORD> GetBlockSizeClasses() const;
+
+    DWORD GetNextBlockSizeInBytes(IOOperation ioType, Random *pRand) const
+    {
+        const vector<BlockSizeWeight>& vBlockSizes = GetBlockSizeWeights(ioType);
+        UINT64 ullTotalWeight = (ioType == IOOperation::ReadIO) ? _ullReadBlockSizeWeight : _ullWriteBlockSizeWeight;
+
+        if (vBlockSizes.empty())
+        {
+            return _dwBlockSize;
+        }
+
+        UINT64 ullWeight = Util::MultiplyHigh64(pRand->Rand64(), ullTotalWeight);
+        for (const auto& blockSize : vBlockSizes)
+        {
+            if (ullWeight < blockSize.ulWeight)
+            {
+                return blockSize.dwBlockSize;
+            }
+
+            ullWeight -= blockSize.ulWeight;
+        }
+
+        return vBlockSizes.back().dwBlockSize;
+    }
+
     void SetBlockAlignmentInBytes(UINT64 ullBlockAlignment)
     {
         _ullBlockAlignment = ullBlockAlignment;
@@ -1035,6 +1450,51 @@ public:
     void SetUseRandomAccessPattern(bool fBool) { _fUseRandomAccessPattern = fBool; }
     bool GetUseRandomAccessPattern() const { return _fUseRandomAccessPattern; } 
 
+    void SetUseRandomPermutation(bool fBool) { _fUseRandomPermutation = fBool; }
+    bool GetUseRandomPermutation() const { return _fUseRandomPermutation; }
+
+    void SetRandomRatio(UINT32 ulRandomRatio) { _ulRandomRatio = ulRandomRatio; }
+    UINT32 GetRandomRatio() const { return _ulRandomRatio; }
+
+    void SetSequentialRunLength(UINT32 ulMin, UINT32 ulMax)
+    {
+        _ulMinSequentialRun = ulMin;
+        _ulMaxSequentialRun = ulMax;
+    }
+    UINT32 GetMinSequentialRun() const { return _ulMinSequentialRun; }
+    UINT32 GetMaxSequentialRun() const { return _ulMaxSequentialRun; }
+
+    void SetRandomDistribution(DistributionType distributionType) { _distributionType = distributionType; }
+    DistributionType GetRandomDistribution() const { return _distributionType; }
+
+    void AddDistributionRange(UINT32 ulIoPercent, UINT32 ulTargetPercent) { _vDistributionRanges.emplace_back(ulIoPercent, ulTargetPercent); }
+    void AddDistributionRangeInBytes(UINT32 ulIoPercent, UINT64 ullTargetBytes) { _vDistributionRanges.emplace_back(ulIoPercent, 0, ullTargetBytes); }
+    const vector<DistributionRange>& GetDistributionRanges() const { return _vDistributionRanges; }
+
+    void SetDistributionDrift(UINT64 ullBytesPerSecond) { _ullDistributionDrift = ullBytesPerSecond; }
+    UINT64 GetDistributionDrift() const { return _ullDistributionDrift; }
+
+    void SetAccessPatternPlugin(const string& sPlugin, const string& sParameters)
+    {
+        _sAccessPatternPlugin = sPlugin;
+        _sAccessPatternParameters = sParameters;
+    }
+    string GetAccessPatternPlugin() const { return _sAccessPatternPlugin; }
+    string GetAccessPatternParameters() const { return _sAccessPatternParameters; }
+    bool GetUseAccessPatternPlugin() const { return !_sAccessPatternPlugin.empty(); }
+
+    void SetZipfTheta(double lfTheta) { _lfZipfTheta = lfTheta; }
+    double GetZipfTheta() const { return _lfZipfTheta; }
+
+    void SetParetoHotPercent(UINT32 ulHotPercent) { _ulParetoHotPercent = ulHotPercent; }
+    UINT32 GetParetoHotPercent() const { return _ulParetoHotPercent; }
+
+    void SetNormalCenterPercent(double lfCenter) { _lfNormalCenterPercent = lfCenter; }
+    double GetNormalCenterPercent() const { return _lfNormalCenterPercent; }
+
+    void SetNormalStdDevPercent(double lfStdDev) { _lfNormalStdDevPercent = lfStdDev; }
+    double GetNormalStdDevPercent() const { return _lfNormalStdDevPercent; }
+
     void SetBaseFileOffsetInBytes(UINT64 ullBaseFileOffset) { _ullBaseFileOffset = ullBaseFileOffset; }
     UINT64 GetBaseFileOffsetInBytes() const { return _ullBaseFileOffset; }
     UINT64 GetThreadBaseFileOffsetInBytes(UINT32 ulThreadNo) { return _ullBaseFileOffset + ulThreadNo * _ullThreadStride; }
@@ -1105,12 +1565,111 @@ public:
     void SetWriteRatio(UINT32 ulWriteRatio) { _ulWriteRatio = ulWriteRatio; }
     UINT32 GetWriteRatio() const { return _ulWriteRatio; }
 
+    // percentages of trim (-wt) and write-zeroes (-wz) operations; they are taken from the reads,
+    // which get whatever the write, trim and write-zeroes percentages leave
+    void SetTrimRatio(UINT32 ulTrimRatio) { _ulTrimRatio = ulTrimRatio; }
+    UINT32 GetTrimRatio() const { return _ulTrimRatio; }
+
+    void SetWriteZeroesRatio(UINT32 ulWriteZeroesRatio) { _ulWriteZeroesRatio = ulWriteZeroesRatio; }
+    UINT32 GetWriteZeroesRatio() const { return _ulWriteZeroesRatio; }
+
+    // percentage of operations which modify the target
+    UINT32 GetModifyRatio() const { return _ulWriteRatio + _ulTrimRatio + _ulWriteZeroesRatio; }
+
+    // percentage of the writes issued as durable (-wd), through a write-through handle
+    void SetDurableWriteRatio(UINT32 ulDurableWriteRatio) { _ulDurableWriteRatio = ulDurableWriteRatio; }
+    UINT32 GetDurableWriteRatio() const { return _ulDurableWriteRatio; }
+
+    // each thread flushes the target after so many of its I/Os (-wf), after so many milliseconds (-wft),
+    // or ahead of a percentage of its I/Os (-wfp); at most one of these is used
+    void SetFlushIoInterval(UINT32 ulFlushIoInterval) { _ulFlushIoInterval = ulFlushIoInterval; }
+    UINT32 GetFlushIoInterval() const { return _ulFlushIoInterval; }
+
+    void SetFlushTimeIntervalInMilliseconds(UINT32 ulFlushTimeInterval) { _ulFlushTimeInterval = ulFlushTimeInterval; }
+    UINT32 GetFlushTimeIntervalInMilliseconds() const { return _ulFlushTimeInterval; }
+
+    void SetFlushRatio(UINT32 ulFlushRatio) { _ulFlushRatio = ulFlushRatio; }
+    UINT32 GetFlushRatio() const { return _ulFlushRatio; }
+
+    bool GetUseFlush() const { return _ulFlushIoInterval != 0 || _ulFlushTimeInterval != 0 || _ulFlushRatio != 0; }
+
+    // flush only the data and the metadata needed to read it back (-wfd)
+    void SetFlushDataOnly(bool fFlushDataOnly) { _fFlushDataOnly = fFlushDataOnly; }
+    bool GetFlushDataOnly() const { return _fFlushDataOnly; }
+
+    // writes go to the tail of the target, which starts empty and grows during the run (-wa); space is
+    // allocated ahead of the tail in chunks of the preallocation size (-wap), and once a segment reaches
+    // the segment size (-was) the log rolls over to a new segment file; zero disables either
+    void SetUseAppend(bool fAppend) { _fAppend = fAppend; }
+    bool GetUseAppend() const { return _fAppend; }
+
+    void SetAppendPreallocationSizeInBytes(UINT64 ullSize) { _ullAppendPreallocationSize = ullSize; }
+    UINT64 GetAppendPreallocationSizeInBytes() const { return _ullAppendPreallocationSize; }
+
+    void SetAppendSegmentSizeInBytes(UINT64 ullSize) { _ullAppendSegmentSize = ullSize; }
+    UINT64 GetAppendSegmentSizeInBytes() const { return _ullAppendSegmentSize; }
+
+    // each thread acts as the log writer of a group commit (-wg): so many committers queue records of
+    // the record size (-wgr), the thread writes the queued records as one group and flushes it, and
+    // the committers queue their next record after the think time (-wgt) from their release
+    void SetCommitterCount(UINT32 ulCommitterCount) { _ulCommitterCount = ulCommitterCount; }
+    UINT32 GetCommitterCount() const { return _ulCommitterCount; }
+
+    void SetCommitRecordSizeInBytes(DWORD dwRecordSize) { _dwCommitRecordSize = dwRecordSize; }
+    DWORD GetCommitRecordSizeInBytes() const { return _dwCommitRecordSize; }
+
+    void SetCommitThinkTimeInMicroseconds(UINT32 ulThinkTime) { _ulCommitThinkTime = ulThinkTime; }
+    UINT32 GetCommitThinkTimeInMicroseconds() const { return _ulCommitThinkTime; }
+
+    bool GetUseGroupCommit() const { return _ulCommitterCount != 0; }
+
+    // instead of data I/O, the target is a directory under which each thread builds a tree of its own (-M):
+    // fanout subdirectories per level (-Mf) down to the depth (-Md), with a number of files in each directory
+    // at the bottom (-Mn); the thread then performs metadata operations on the files in the weighted mix (-Mw)
+    void SetUseMetadata(bool fMetadata) { _fMetadata = fMetadata; }
+    bool GetUseMetadata() const { return _fMetadata; }
+
+    void SetMetadataFanout(UINT32 ulFanout) { _ulMetadataFanout = ulFanout; }
+    UINT32 GetMetadataFanout() const { return _ulMetadataFanout; }
+
+    void SetMetadataDepth(UINT32 ulDepth) { _ulMetadataDepth = ulDepth; }
+    UINT32 GetMetadataDepth() const { return _ulMetadataDepth; }
+
+    void SetMetadataFilesPerDirectory(UINT32 ulFiles) { _ulMetadataFilesPerDirectory = ulFiles; }
+    UINT32 GetMetadataFilesPerDirectory() const { return _ulMetadataFilesPerDirectory; }
+
+    void SetMetadataWeight(MetadataOperation op, UINT32 ulWeight) { _vulMetadataWeights[static_cast<size_t>(op)] = ulWeight; }
+    UINT32 GetMetadataWeight(MetadataOperation op) const { return _vulMetadataWeights[static_cast<size_t>(op)]; }
+
+    // number of files in each thread's tree; zero if it does not fit in 32 bits
+    UINT32 GetMetadataFileCount() const;
+
     void SetUseParallelAsyncIO(bool fBool) { _fParallelAsyncIO = fBool; }
     bool GetUseParallelAsyncIO() const { return _fParallelAsyncIO; }
     
     void SetUseInterlockedSequential(bool fBool) { _fInterlockedSequential = fBool; }
     bool GetUseInterlockedSequential() const { return _fInterlockedSequential; }
 
+    void SetSequentialStreamCount(UINT32 ulStreams) { _ulSequentialStreams = ulStreams; }
+    UINT32 GetSequentialStreamCount() const { return _ulSequentialStreams; }
+
+    void SetUseReverseSequential(bool fBool) { _fReverseSequential = fBool; }
+    bool GetUseReverseSequential() const { return _fReverseSequential; }
+
+    void SetSequentialSkip(UINT32 ulReadRun, UINT32 ulSkipRun)
+    {
+        _ulSequentialReadRun = ulReadRun;
+        _ulSequentialSkipRun = ulSkipRun;
+    }
+    UINT32 GetSequentialReadRun() const { return _ulSequentialReadRun; }
+    UINT32 GetSequentialSkipRun() const { return _ulSequentialSkipRun; }
+
+    // any of -sn, -sr or -sk, which take the place of the single forward sequential stream
+    bool GetUseSequentialStreams() const
+    {
+        return _ulSequentialStreams != 1 || _fReverseSequential || _ulSequentialReadRun != 0;
+    }
+
     void SetThreadStrideInBytes(UINT64 ullThreadStride) { _ullThreadStride = ullThreadStride; }
     UINT64 GetThreadStrideInBytes() const { return _ullThreadStride; }
 
@@ -1120,6 +1679,10 @@ public:
     void SetMappedView(BYTE *MappedView) { _mappedView = MappedView; }
     BYTE* GetMappedView() const { return _mappedView; }
 
+    // set when the target is opened: a physical drive or partition rather than a file
+    void SetDeviceTarget(bool fDeviceTarget) { _fDeviceTarget = fDeviceTarget; }
+    bool GetDeviceTarget() const { return _fDeviceTarget; }
+
     void SetIOPriorityHint(PRIORITY_HINT _hint)
     {
         assert(_hint < MaximumIoPriorityHintType);
@@ -1194,10 +1757,18 @@ private:
     UINT64 _ullBlockAlignment;
     bool _fBlockAlignmentValid;
     bool _fUseRandomAccessPattern;
+    bool _fUseRandomPermutation;        // -rp; random without replacement
+    UINT32 _ulRandomRatio;              // -rs; percent of random I/O, the rest continues sequentially
+    UINT32 _ulMinSequentialRun;         // length of the sequential runs between random I/Os, in I/Os
+    UINT32 _ulMaxSequentialRun;
  
     UINT64 _ullBaseFileOffset;
     bool _fParallelAsyncIO;
     bool _fInterlockedSequential;
+    UINT32 _ulSequentialStreams;        // -sn; interleaved sequential streams per thread
+    bool _fReverseSequential;           // -sr; streams run backward from the end of the target
+    UINT32 _ulSequentialReadRun;        // -sk; read this many strides, then skip _ulSequentialSkipRun strides
+    UINT32 _ulSequentialSkipRun;
 
     TargetCacheMode _cacheMode;
     WriteThroughMode _writeThroughMode;
@@ -1214,6 +1785,24 @@ private:
     UINT64 _ullMaxFileSize;
 
     UINT32 _ulWriteRatio;
+    UINT32 _ulTrimRatio;            // -wt
+    UINT32 _ulWriteZeroesRatio;     // -wz
+    UINT32 _ulDurableWriteRatio;    // -wd; percent of the writes
+    UINT32 _ulFlushIoInterval;      // -wf; in I/Os
+    UINT32 _ulFlushTimeInterval;    // -wft; in milliseconds
+    UINT32 _ulFlushRatio;           // -wfp; percent of the I/Os
+    bool _fFlushDataOnly;           // -wfd
+    bool _fAppend;                          // -wa
+    UINT64 _ullAppendPreallocationSize;     // -wap
+    UINT64 _ullAppendSegmentSize;           // -was
+    UINT32 _ulCommitterCount;               // -wg; per thread
+    DWORD _dwCommitRecordSize;              // -wgr
+    UINT32 _ulCommitThinkTime;              // -wgt; in microseconds
+    bool _fMetadata;                        // -M
+    UINT32 _ulMetadataFanout;               // -Mf
+    UINT32 _ulMetadataDepth;                // -Md
+    UINT32 _ulMetadataFilesPerDirectory;    // -Mn
+    vector<UINT32> _vulMetadataWeights;     // -Mw; per MetadataOperation
     bool _fUseBurstSize;    // TODO: "use" or "enable"?; since burst size must be specified with the think time, one variable should be sufficient
     DWORD _dwBurstSize;     // number of IOs in a burst
     DWORD _dwThinkTime;     // time to pause before issuing the next burst of IOs
@@ -1232,18 +1821,692 @@ private:
 
     HANDLE _mappedViewFileHandle;
     BYTE *_mappedView;
+    bool _fDeviceTarget;
 
     PRIORITY_HINT _ioPriorityHint;
 
     UINT32 _ulWeight;
     vector<ThreadTarget> _vThreadTargets;
 
+    vector<BlockSizeWeight> _vReadBlockSizes;
+    vector<BlockSizeWeight> _vWriteBlockSizes;
+    UINT64 _ullReadBlockSizeWeight;
+    UINT64 _ullWriteBlockSizeWeight;
+
+    DistributionType _distributionType;
+    vector<DistributionRange> _vDistributionRanges;     // -rdpct; IO beyond the listed ranges goes to the rest of the target
+    double _lfZipfTheta;
+    UINT32 _ulParetoHotPercent;     // percent of the target receiving (100 - percent) of the IO
+    double _lfNormalCenterPercent;
+    double _lfNormalStdDevPercent;
+    UINT64 _ullDistributionDrift;   // -rdmove; bytes per second the distribution moves forward through the target
+
+    string _sAccessPatternPlugin;       // -A; DLL generating the offsets and read/write mix instead of -r/-s/-w
+    string _sAccessPatternParameters;   // passed to the plugin as is
+
     bool _FillRandomDataWriteBuffer(Random *pRand);
 
     friend class UnitTests::ProfileUnitTests;
     friend class UnitTests::TargetUnitTests;
 };
 
+// Per-thread sampler for a target's random offset distribution. All of the work which depends on the
+// size of the target is done once in Initialize so that NextBlock is O(1) per IO.
+class OffsetDistribution
+{
+public:
+    OffsetDistribution() :
+        _distributionType(DistributionType::Uniform),
+        _ullBlockCount(0),
+        _ullBlockCountReciprocal(0),
+        _lfZetaN(0),
+        _lfHalfPowTheta(0),
+        _lfAlpha(0),
+        _lfEta(0),
+        _lfParetoExponent(0),
+        _lfCenter(0),
+        _lfStdDev(0),
+        _lfNormalCdfLow(0),
+        _lfNormalCdfSpan(0),
+        _lfDriftBlocksPerTick(0),
+        _ullDriftStartTime(0)
+    {
+    }
+
+    void Initialize(const Target& target, UINT64 ullBlockCount);
+
+    // drift is measured from this time, taken by each thread as it starts issuing I/O
+    void StartDrift(UINT64 ullStartTime) { _ullDriftStartTime = ullStartTime; }
+    bool GetUseDrift() const { return _lfDriftBlocksPerTick != 0; }
+
+    // moves a block drawn by NextBlock along with the drifting distribution, wrapping at the end of the target;
+    // the reciprocal quotient is low by at most one
+    UINT64 Drift(UINT64 ullBlock, UINT64 ullTime) const
+    {
+        UINT64 ullShift = static_cast<UINT64>((ullTime - _ullDriftStartTime) * _lfDriftBlocksPerTick);
+        ullShift -= Util::MultiplyHigh64(ullShift, _ullBlockCountReciprocal) * _ullBlockCount;
+        ullShift = (ullShift >= _ullBlockCount) ? ullShift - _ullBlockCount : ullShift;
+        ullBlock += ullShift;
+        return (ullBlock >= _ullBlockCount) ? ullBlock - _ullBlockCount : ullBlock;
+    }
+
+    // returns a block index in [0, block count)
+    UINT64 NextBlock(Random *pRand) const
+    {
+        UINT64 ullBlock;
+
+        switch (_distributionType)
+        {
+        case DistributionType::Percent:
+        case DistributionType::Absolute:
+            {
+                // the high part of the product picks the percent, the low part is the uniform fraction within it
+                UINT64 ullRand = pRand->Rand64();
+                const PercentRange& range = _vRanges[_vbPercentToRange[Util::MultiplyHigh64(ullRand, 100)]];
+                ullBlock = range.ullFirstBlock + Util::MultiplyHigh64(ullRand * 100, range.ullBlockCount);
+            }
+            break;
+
+        case DistributionType::Zipf:
+            {
+                // Gray et al., "Quickly Generating Billion-Record Synthetic Databases"
+                double u = _Uniform(pRand);
+                double uz = u * _lfZetaN;
+                if (uz < 1.0)
+                {
+                    ullBlock = 0;
+                }
+                else if (uz < 1.0 + _lfHalfPowTheta)
+                {
+                    ullBlock = 1;
+                }
+                else
+                {
+                    ullBlock = static_cast<UINT64>(_ullBlockCount * pow(_lfEta * u - _lfEta + 1.0, _lfAlpha));
+                }
+            }
+            break;
+
+        case DistributionType::Pareto:
+            ullBlock = static_cast<UINT64>(_ullBlockCount * pow(_Uniform(pRand), _lfParetoExponent));
+            break;
+
+        case DistributionType::Normal:
+            {
+                // inverse CDF over the part of the distribution within the target, so there is nothing to redraw
+                double lfBlock = _lfCenter + _lfStdDev * _InverseNormalCdf(_lfNormalCdfLow + _lfNormalCdfSpan * _Uniform(pRand));
+                ullBlock = (lfBlock <= 0) ? 0 : (lfBlock >= _ullBlockCount) ? _ullBlockCount - 1 : static_cast<UINT64>(lfBlock);
+            }
+            break;
+
+        default:
+            ullBlock = Util::MultiplyHigh64(pRand->Rand64(), _ullBlockCount);
+            break;
+        }
+
+        // floating point rounding may land on the block count itself
+        return (ullBlock < _ullBlockCount) ? ullBlock : _ullBlockCount - 1;
+    }
+
+private:
+    struct PercentRange
+    {
+        UINT64 ullFirstBlock;
+        UINT64 ullBlockCount;
+    };
+
+    // uniform in [0, 1) with 53 bits of precision
+    static double _Uniform(Random *pRand)
+    {
+        return (pRand->Rand64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    static double _Zeta(UINT64 n, double theta);
+    static double _InverseNormalCdf(double p);
+
+    DistributionType _distributionType;
+    UINT64 _ullBlockCount;
+    UINT64 _ullBlockCountReciprocal;    // floor((2^64 - 1) / _ullBlockCount), for the drift
+
+    vector<PercentRange> _vRanges;
+    vector<BYTE> _vbPercentToRange;     // 100 entries, one per percent of IO
+
+    double _lfZetaN;
+    double _lfHalfPowTheta;
+    double _lfAlpha;
+    double _lfEta;
+
+    double _lfParetoExponent;
+
+    double _lfCenter;
+    double _lfStdDev;
+    double _lfNormalCdfLow;         // standard normal CDF at the start of the target
+    double _lfNormalCdfSpan;        // and its increase over the target
+
+    double _lfDriftBlocksPerTick;
+    UINT64 _ullDriftStartTime;
+};
+
+// Per-thread walk of a keyed permutation of a target's blocks, for random access without replacement.
+// A balanced Feistel network permutes the smallest power-of-four domain covering the blocks and values
+// beyond the block count are cycle-walked back into range, so there is no per-block state. Threads
+// sharing a target take interleaved positions of the same permutation, which makes their passes
+// disjoint; each pass is rekeyed from the seed and the pass number.
+class BlockPermutation
+{
+public:
+    BlockPermutation() :
+        _ullBlockCount(0),
+        _ulHalfBits(0),
+        _ullHalfMask(0),
+        _ullSeed(0),
+        _ullPass(0),
+        _ullPosition(0),
+        _ullStride(1)
+    {
+        memset(_ullRoundKeys, 0, sizeof(_ullRoundKeys));
+    }
+
+    void Initialize(UINT64 ullBlockCount, UINT64 ullSeed, UINT32 ulThread, UINT32 cThreads);
+
+    // returns a block index in [0, block count)
+    UINT64 NextBlock()
+    {
+        UINT64 ullBlock = _Permute(_ullPosition);
+
+        _ullPosition += _ullStride;
+        while (_ullPosition >= _ullBlockCount)
+        {
+            _ullPosition -= _ullBlockCount;
+            _ullPass++;
+            _SetRoundKeys();
+        }
+
+        return ullBlock;
+    }
+
+    UINT64 GetPass() const { return _ullPass; }
+
+private:
+    static const UINT32 _cRounds = 4;
+
+    static UINT64 _Mix(UINT64 z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    UINT64 _Permute(UINT64 ullIndex) const
+    {
+        // the input is in range, so walking its cycle is guaranteed to come back into range
+        do
+        {
+            UINT64 ullLeft = ullIndex >> _ulHalfBits;
+            UINT64 ullRight = ullIndex & _ullHalfMask;
+            for (UINT32 iRound = 0; iRound < _cRounds; iRound++)
+            {
+                UINT64 ullNext = ullLeft ^ (_Mix(ullRight + _ullRoundKeys[iRound]) & _ullHalfMask);
+                ullLeft = ullRight;
+                ullRight = ullNext;
+            }
+            ullIndex = (ullLeft << _ulHalfBits) | ullRight;
+        } while (ullIndex >= _ullBlockCount);
+
+        return ullIndex;
+    }
+
+    void _SetRoundKeys();
+
+    UINT64 _ullBlockCount;
+    UINT32 _ulHalfBits;
+    UINT64 _ullHalfMask;
+    UINT64 _ullRoundKeys[_cRounds];
+
+    UINT64 _ullSeed;
+    UINT64 _ullPass;
+    UINT64 _ullPosition;        // position within the current pass
+    UINT64 _ullStride;          // number of threads sharing the permutation
+};
+
+// Per-thread cursors for the sequential variants (-sn, -sr, -sk): one or more interleaved streams spread
+// evenly over the target, issued round robin. Each stream advances by the stride and, with a read/skip
+// pattern, jumps ahead after every read run. Reverse streams are the mirror image of forward ones, so
+// they run from the last offset at which an I/O fits down towards the base of the target.
+class SequentialStreams
+{
+public:
+    SequentialStreams() :
+        _iNextStream(0),
+        _ullStride(0),
+        _ullLastOffset(0),
+        _ullWrapOffset(0),
+        _ulReadRun(0),
+        _ullSkip(0),
+        _fReverse(false)
+    {
+    }
+
+    // offsets are relative to the base file offset; ullLastOffset is the highest offset at which an I/O fits
+    void Initialize(const Target& target, UINT64 ullThreadOffset, UINT64 ullLastOffset);
+
+    UINT64 NextOffset()
+    {
+        Stream& stream = _vStreams[_iNextStream];
+        if (++_iNextStream == _vStreams.size())
+        {
+            _iNextStream = 0;
+        }
+
+        UINT64 ullOffset = stream.ullOffset;
+
+        stream.ullOffset += _ullStride;
+        if (_ulReadRun != 0 && ++stream.ulRunCount == _ulReadRun)
+        {
+            stream.ulRunCount = 0;
+            stream.ullOffset += _ullSkip;
+        }
+
+        // same wrap as the single sequential stream: back to the thread's offset within the first stride
+        if (stream.ullOffset > _ullLastOffset)
+        {
+            stream.ullOffset = _ullWrapOffset;
+            stream.ulRunCount = 0;
+        }
+
+        return _fReverse ? _ullLastOffset - ullOffset : ullOffset;
+    }
+
+private:
+    struct Stream
+    {
+        UINT64 ullOffset;
+        UINT32 ulRunCount;      // I/Os issued in the current read run
+    };
+
+    vector<Stream> _vStreams;
+    size_t _iNextStream;
+
+    UINT64 _ullStride;
+    UINT64 _ullLastOffset;
+    UINT64 _ullWrapOffset;
+    UINT32 _ulReadRun;
+    UINT64 _ullSkip;
+    bool _fReverse;
+};
+
+// Per-thread geometry of a target, derived once its size is known so that computing the offset of each
+// I/O needs no divisions. Offsets are relative to the base file offset. Power of two alignments convert
+// between blocks and offsets with shifts; the interlocked sequential wrap divides by a precomputed
+// reciprocal instead.
+class TargetGeometry
+{
+public:
+    TargetGeometry() :
+        ullBaseFileOffset(0),
+        ullAlignment(1),
+        ulAlignmentShift(0),
+        fPowerOfTwoAlignment(true),
+        ullMaxBlockSize(0),
+        ullLastOffset(0),
+        ullBlockCount(1),
+        ullOpenSize(1),
+        ullOpenSizeReciprocal(0),
+        ullRunStride(0)
+    {
+    }
+
+    void Initialize(const Target& target, UINT64 ullFileSize);
+
+    UINT64 BlockToOffset(UINT64 ullBlock) const
+    {
+        return fPowerOfTwoAlignment ? (ullBlock << ulAlignmentShift) : (ullBlock * ullAlignment);
+    }
+
+    // uniformly drawn aligned offset within the target
+    UINT64 RandomOffset(Random *pRand) const
+    {
+        return BlockToOffset(Util::MultiplyHigh64(pRand->Rand64(), ullBlockCount));
+    }
+
+    // ullOffset modulo the open interval of aligned offsets; the reciprocal quotient is low by at most one
+    UINT64 WrapOffset(UINT64 ullOffset) const
+    {
+        UINT64 ullRemainder = ullOffset - Util::MultiplyHigh64(ullOffset, ullOpenSizeReciprocal) * ullOpenSize;
+        return (ullRemainder >= ullOpenSize) ? ullRemainder - ullOpenSize : ullRemainder;
+    }
+
+    // an offset beyond the last one, such as an access pattern plugin may return, wrapped in whole
+    // blocks so that it stays aligned; off the per-I/O path of diskspd's own patterns, so it may divide
+    UINT64 WrapToBlock(UINT64 ullOffset) const
+    {
+        UINT64 ullBlock = fPowerOfTwoAlignment ? (ullOffset >> ulAlignmentShift) : (ullOffset / ullAlignment);
+        return BlockToOffset(ullBlock % ullBlockCount);
+    }
+
+    UINT64 ullBaseFileOffset;
+    UINT64 ullAlignment;
+    UINT32 ulAlignmentShift;
+    bool fPowerOfTwoAlignment;
+    UINT64 ullMaxBlockSize;         // largest block size the target issues, which all offsets leave room for
+
+    UINT64 ullLastOffset;           // closed interval: the highest offset at which an I/O fits
+    UINT64 ullBlockCount;           // number of aligned offsets in [0, ullLastOffset]
+    UINT64 ullOpenSize;             // open interval: ullBlockCount * ullAlignment
+    UINT64 ullOpenSizeReciprocal;   // floor((2^64 - 1) / ullOpenSize)
+
+    UINT64 ullRunStride;            // block size rounded up to the alignment, for -rs sequential runs
+};
+
+// A loaded access pattern plugin (-A), shared by the threads using it; see AccessPatternPlugin.h
+// for the interface. The plugin stays loaded for the lifetime of the object.
+class AccessPatternPlugin
+{
+public:
+    AccessPatternPlugin() :
+        _hModule(nullptr),
+        _accessPattern()
+    {
+    }
+
+    ~AccessPatternPlugin() { Unload(); }
+
+    AccessPatternPlugin(const AccessPatternPlugin&) = delete;
+    AccessPatternPlugin& operator=(const AccessPatternPlugin&) = delete;
+
+    bool Load(const string& sPath);
+    void Unload();
+
+    void *CreateState(const DISKSPD_ACCESS_PATTERN_CONTEXT *pContext) const { return _accessPattern.CreateState(pContext); }
+    void Generate(void *pState, DISKSPD_IO_DECISION *pDecisions, UINT32 cDecisions) const { _accessPattern.Generate(pState, pDecisions, cDecisions); }
+    void DestroyState(void *pState) const { _accessPattern.DestroyState(pState); }
+
+private:
+    HMODULE _hModule;
+    DISKSPD_ACCESS_PATTERN _accessPattern;
+};
+
+// Per-thread batch of pregenerated decisions for the I/O to a target (-k). The issue path consumes them
+// in order and the whole batch is refilled when it runs out, keeping random number generation out of the
+// loop which submits I/O. Offsets are only pregenerated for random access; sequential offsets depend on
+// the request (-p), other threads (-si) or need no random numbers, and drifting distributions on time.
+class IOLookahead
+{
+public:
+    struct Decision
+    {
+        UINT64 ullOffset;
+        DWORD dwTransferSize;
+        IOOperation ioType;
+    };
+
+    IOLookahead() :
+        _iNext(0),
+        _fOffsets(false)
+    {
+    }
+
+    void Initialize(DWORD cDepth, bool fOffsets)
+    {
+        _vDecisions.resize(cDepth);
+        _iNext = _vDecisions.size();
+        _fOffsets = fOffsets;
+    }
+
+    bool GetUseOffsets() const { return _fOffsets; }
+    bool IsEmpty() const { return _iNext == _vDecisions.size(); }
+
+    // the batch is refilled in place, then rewound
+    vector<Decision>& GetDecisions() { return _vDecisions; }
+    void Rewind() { _iNext = 0; }
+
+    const Decision& Next() { return _vDecisions[_iNext++]; }
+
+private:
+    vector<Decision> _vDecisions;
+    size_t _iNext;
+    bool _fOffsets;
+};
+
+// Per-thread schedule of a target's flushes (-wf, -wft, -wfp). It is asked before each I/O to the
+// target whether a flush is due first, so a flush covers the writes the thread has completed by then.
+class FlushSchedule
+{
+public:
+    FlushSchedule() :
+        _ulIoInterval(0),
+        _ulIoCount(0),
+        _ullTimeInterval(0),
+        _ullNextFlushTime(0),
+        _ulRatio(0)
+    {
+    }
+
+    void Initialize(const Target& target)
+    {
+        _ulIoInterval = target.GetFlushIoInterval();
+        _ulIoCount = 0;
+        _ullTimeInterval = PerfTimer::MillisecondsToPerfTime(target.GetFlushTimeIntervalInMilliseconds());
+        _ulRatio = target.GetFlushRatio();
+    }
+
+    bool IsEnabled() const { return _ulIoInterval != 0 || _ullTimeInterval != 0 || _ulRatio != 0; }
+
+    // the time interval is measured from when the thread starts issuing I/O
+    void Start(UINT64 ullStartTime) { _ullNextFlushTime = ullStartTime + _ullTimeInterval; }
+
+    bool IsDue(Random *pRand)
+    {
+        if (_ulIoInterval != 0)
+        {
+            if (_ulIoCount < _ulIoInterval)
+            {
+                _ulIoCount++;
+                return false;
+            }
+
+            // the I/O about to be issued is the first of the next interval
+            _ulIoCount = 1;
+            return true;
+        }
+
+        if (_ullTimeInterval != 0)
+        {
+            UINT64 ullTime = PerfTimer::GetTime();
+            if (ullTime < _ullNextFlushTime)
+            {
+                return false;
+            }
+
+            // intervals which passed without I/O are not made up for with back to back flushes
+            _ullNextFlushTime = ullTime + _ullTimeInterval;
+            return true;
+        }
+
+        // scale to [0, 100) by multiply and shift rather than modulo
+        return static_cast<UINT32>((static_cast<UINT64>(pRand->Rand32()) * 100) >> 32) < _ulRatio;
+    }
+
+private:
+    UINT32 _ulIoInterval;
+    UINT32 _ulIoCount;          // I/Os issued since the last flush
+    UINT64 _ullTimeInterval;    // in perf timer units
+    UINT64 _ullNextFlushTime;
+    UINT32 _ulRatio;
+};
+
+// Per-thread group commit of a target (-wg). The thread is the log writer of a set of simulated
+// committers: each queues a record, and the writer takes the queued records as one group, writes
+// them with a single I/O and flushes the target once it completes. The committers of the group are
+// released then and queue their next record after their think time. A committer is in at most one
+// group at a time, so with more requests in flight several groups can be outstanding.
+class GroupCommit
+{
+public:
+    GroupCommit() :
+        _cbRecord(0),
+        _cMaxRecords(0),
+        _ullThinkTime(0),
+        _iNextCommitter(0)
+    {
+    }
+
+    void Initialize(const Target& target)
+    {
+        _vCommitters.clear();
+        _vCommitters.resize(target.GetCommitterCount());
+        _cbRecord = target.GetCommitRecordSizeInBytes();
+        _cMaxRecords = _cbRecord != 0 ? target.GetMaxBlockSizeInBytes() / _cbRecord : 0;
+        _ullThinkTime = PerfTimer::MicrosecondsToPerfTime(target.GetCommitThinkTimeInMicroseconds());
+        _iNextCommitter = 0;
+    }
+
+    bool IsEnabled() const { return !_vCommitters.empty(); }
+
+    // all committers queue their first record when the thread starts issuing I/O
+    void Start(UINT64 ullStartTime)
+    {
+        for (auto& committer : _vCommitters)
+        {
+            committer.ullQueueTime = ullStartTime;
+            committer.iRequest = NOT_IN_GROUP;
+        }
+    }
+
+    UINT64 GetWaitTime(UINT64 ullTime) const;
+    DWORD TakeGroup(UINT32 iRequest, UINT64 ullTime);
+    UINT32 Release(UINT32 iRequest, UINT64 ullTime, TargetResults *pTargetResults, bool fMeasureLatency);
+
+private:
+    static const UINT32 NOT_IN_GROUP = 0xFFFFFFFF;
+
+    struct Committer
+    {
+        Committer() :
+            ullQueueTime(0),
+            iRequest(NOT_IN_GROUP)
+        {
+        }
+
+        UINT64 ullQueueTime;    // when the committer queued, or is going to queue, its record
+        UINT32 iRequest;        // request writing the group the record is in
+    };
+
+    vector<Committer> _vCommitters;
+    DWORD _cbRecord;
+    DWORD _cMaxRecords;         // records fitting in one block
+    UINT64 _ullThinkTime;       // in perf timer units
+    size_t _iNextCommitter;     // where the next group starts taking records, so no committer is starved
+};
+
+// Tail of an appended target (-wa), shared by the threads writing to it. Each write reserves the next
+// range under the lock, which also rolls the log over to a new segment once the current one is full
+// and extends the allocation ahead of the tail. The first segment is the target itself, the following
+// ones are named after it with the segment number appended. The threads write through handles of
+// their own; the log holds one to the current segment for managing its allocation.
+class AppendLog
+{
+public:
+    AppendLog() :
+        _hSegment(INVALID_HANDLE_VALUE),
+        _ullSegmentSize(0),
+        _ullPreallocationSize(0),
+        _ulSegment(0),
+        _ullTail(0),
+        _ullAllocated(0),
+        _ullTotalBytes(0)
+    {
+        InitializeSRWLock(&_srwLock);
+    }
+
+    ~AppendLog() { Close(); }
+
+    AppendLog(const AppendLog&) = delete;
+    AppendLog& operator=(const AppendLog&) = delete;
+
+    // creates the first segment empty, replacing the target if it exists
+    bool Initialize(const Target& target);
+    void Close();
+
+    // reserves cbTransfer bytes at the tail, returning the segment and offset to write them to
+    bool Append(DWORD cbTransfer, UINT32 *pulSegment, UINT64 *pullOffset);
+
+    UINT32 GetSegmentCount() const { return _ulSegment + 1; }
+    UINT64 GetTotalBytes() const { return _ullTotalBytes; }
+
+    static string GetSegmentPath(const string& sPath, UINT32 ulSegment);
+
+private:
+    bool _CreateSegment();
+    bool _Preallocate(UINT64 ullSize);
+
+    SRWLOCK _srwLock;
+    HANDLE _hSegment;
+    string _sPath;
+
+    UINT64 _ullSegmentSize;         // 0 if the log does not roll over
+    UINT64 _ullPreallocationSize;   // 0 if space is not allocated ahead of the tail
+    UINT32 _ulSegment;              // current segment
+    UINT64 _ullTail;                // offset of the next write within the current segment
+    UINT64 _ullAllocated;           // space allocated to the current segment
+    UINT64 _ullTotalBytes;          // bytes appended over all segments
+};
+
+// Per-thread directory tree of a metadata target (-M), under a directory of the thread's own so the
+// threads never race for the same names. Each file of the tree is a slot which is either absent or
+// present under one of two names, which renames alternate between. The present slots are kept ahead
+// of the absent ones in a single array, so a slot of either kind can be drawn in constant time.
+class MetadataTree
+{
+public:
+    MetadataTree() :
+        _ulFanout(0),
+        _ulDepth(0),
+        _ulFilesPerDirectory(0),
+        _cPresent(0),
+        _ulTotalWeight(0)
+    {
+    }
+
+    void Initialize(const Target& target, UINT32 ulThreadNo);
+
+    // creates the directories and all of the files; leftovers of an earlier run are reused
+    bool Build();
+    // deletes the files and directories of the tree, leaving the target directory itself
+    bool Remove();
+
+    // draws the next operation in the weighted mix, and the slot it acts on; an operation without
+    // a slot to act on gives way to the one which makes such a slot: creates to unlinks, the rest to creates
+    MetadataOperation Next(Random *pRand, UINT32 *piSlot) const;
+    bool Perform(MetadataOperation op, UINT32 iSlot);
+
+    const string& GetRoot() const { return _sRoot; }
+    UINT32 GetFileCount() const { return static_cast<UINT32>(_vSlots.size()); }
+    UINT32 GetPresentFileCount() const { return _cPresent; }
+
+    static const char *GetOperationName(MetadataOperation op);
+
+private:
+    bool _BuildDirectory(const string& sPath, UINT32 ulLevel);
+    bool _RemoveDirectory(const string& sPath, UINT32 ulLevel);
+    string _GetFilePath(UINT32 iSlot, bool fRenamed) const;
+    void _MarkPresent(UINT32 iSlot, bool fPresent);
+
+    string _sRoot;
+    UINT32 _ulFanout;
+    UINT32 _ulDepth;
+    UINT32 _ulFilesPerDirectory;
+
+    vector<string> _vsDirectories;  // directories at the bottom of the tree, which hold the files
+    vector<UINT32> _vSlots;         // slots; the first _cPresent are present
+    vector<UINT32> _vulPositions;   // position of each slot in _vSlots
+    vector<bool> _vfRenamed;        // per slot, whether it is present under its second name
+    UINT32 _cPresent;
+
+    vector<UINT32> _vulWeights;     // per MetadataOperation
+    UINT32 _ulTotalWeight;
+};
+
 class AffinityAssignment
 {
 public:
@@ -1268,9 +2531,19 @@ public:
         _ulRandSeed(0),
         _dwThreadCount(0),
         _dwRequestCount(0),
+        _dwBatchSize(1),
+        _dwLookaheadDepth(0),
+        _waitStrategy(WaitStrategy::Undefined),
+        _dwSpinBudgetInMicroseconds(50),
         _fRandomWriteData(false),
         _fDisableAffinity(false),
         _fCompletionRoutines(false),
+        _fIoRing(false),
+        _fIoRingSubmissionPoller(false),
+        _fEventCompletions(false),
+        _fPollCompletions(false),
+        _fSeparateReaper(false),
+        _dwCompletionPoolThreadCount(0),
         _fMeasureLatency(false),
         _fCalculateIopsStdDev(false),
         _ulIoBucketDurationInMilliseconds(1000)
@@ -1315,11 +2588,44 @@ public:
     void SetRequestCount(DWORD dwRequestCount) { _dwRequestCount = dwRequestCount; }
     DWORD GetRequestCount() const { return _dwRequestCount; }
 
+    void SetBatchSize(DWORD dwBatchSize) { _dwBatchSize = dwBatchSize; }
+    DWORD GetBatchSize() const { return _dwBatchSize; }
+
+    void SetLookaheadDepth(DWORD dwLookaheadDepth) { _dwLookaheadDepth = dwLookaheadDepth; }
+    DWORD GetLookaheadDepth() const { return _dwLookaheadDepth; }
+
+    void SetLookaheadDumpPath(const string& sLookaheadDumpPath) { _sLookaheadDumpPath = sLookaheadDumpPath; }
+    string GetLookaheadDumpPath() const { return _sLookaheadDumpPath; }
+
+    void SetWaitStrategy(WaitStrategy waitStrategy) { _waitStrategy = waitStrategy; }
+    WaitStrategy GetWaitStrategy() const { return _waitStrategy; }
+
+    void SetSpinBudgetInMicroseconds(DWORD dwSpinBudget) { _dwSpinBudgetInMicroseconds = dwSpinBudget; }
+    DWORD GetSpinBudgetInMicroseconds() const { return _dwSpinBudgetInMicroseconds; }
+
     void SetDisableAffinity(bool fDisableAffinity) { _fDisableAffinity = fDisableAffinity; }
     bool GetDisableAffinity() const { return _fDisableAffinity; }
 
     void SetCompletionRoutines(bool fCompletionRoutines) { _fCompletionRoutines = fCompletionRoutines; }
     bool GetCompletionRoutines() const { return _fCompletionRoutines; }
+
+    void SetIoRing(bool fIoRing) { _fIoRing = fIoRing; }
+    bool GetIoRing() const { return _fIoRing; }
+
+    void SetIoRingSubmissionPoller(bool fIoRingSubmissionPoller) { _fIoRingSubmissionPoller = fIoRingSubmissionPoller; }
+    bool GetIoRingSubmissionPoller() const { return _fIoRingSubmissionPoller; }
+
+    void SetEventCompletions(bool fEventCompletions) { _fEventCompletions = fEventCompletions; }
+    bool GetEventCompletions() const { return _fEventCompletions; }
+
+    void SetPollCompletions(bool fPollCompletions) { _fPollCompletions = fPollCompletions; }
+    bool GetPollCompletions() const { return _fPollCompletions; }
+
+    void SetSeparateReaper(bool fSeparateReaper) { _fSeparateReaper = fSeparateReaper; }
+    bool GetSeparateReaper() const { return _fSeparateReaper; }
+
+    void SetCompletionPoolThreadCount(DWORD dwThreadCount) { _dwCompletionPoolThreadCount = dwThreadCount; }
+    DWORD GetCompletionPoolThreadCount() const { return _dwCompletionPoolThreadCount; }
     
     void SetMeasureLatency(bool fMeasureLatency) { _fMeasureLatency = fMeasureLatency; }
     bool GetMeasureLatency() const { return _fMeasureLatency; }
@@ -1341,10 +2647,21 @@ private:
     UINT32 _ulRandSeed;
     DWORD _dwThreadCount;
     DWORD _dwRequestCount;
+    DWORD _dwBatchSize;
+    DWORD _dwLookaheadDepth;
+    string _sLookaheadDumpPath;
+    WaitStrategy _waitStrategy;
+    DWORD _dwSpinBudgetInMicroseconds;
     bool _fRandomWriteData;
     bool _fDisableAffinity;
     vector<AffinityAssignment> _vAffinity;
     bool _fCompletionRoutines;
+    bool _fIoRing;
+    bool _fIoRingSubmissionPoller;
+    bool _fEventCompletions;
+    bool _fPollCompletions;
+    bool _fSeparateReaper;
+    DWORD _dwCompletionPoolThreadCount;
     bool _fMeasureLatency;
     bool _fCalculateIopsStdDev;
     UINT32 _ulIoBucketDurationInMilliseconds;
@@ -1501,17 +2818,90 @@ private:
     friend class UnitTests::ProfileUnitTests;
 };
 
+// Weighted choice among a thread's targets (-O with target and thread target weights) using Walker's
+// alias method. The table is built once per thread and shared by all of its IORequests, so selection
+// is O(1) - one random draw, one table lookup - however many targets there are and however their
+// weights differ.
+class TargetSelector
+{
+public:
+    TargetSelector() = default;
+
+    void AddTarget(Target *pTarget, UINT32 ulWeight)
+    {
+        _vTargets.push_back(pTarget);
+        _vulWeights.push_back(ulWeight);
+    }
+
+    // builds the alias table; call after all targets are added
+    void Initialize();
+
+    size_t GetTargetCount() const { return _vTargets.size(); }
+
+    // with lookahead (-k), picks are drawn in batches of cDepth and handed out in order
+    void SetLookaheadDepth(DWORD cDepth)
+    {
+        _vpPicks.resize(cDepth);
+        _iNextPick = _vpPicks.size();
+    }
+
+    Target *Next(Random *pRand)
+    {
+        if (_vpPicks.empty())
+        {
+            return Select(pRand);
+        }
+
+        if (_iNextPick == _vpPicks.size())
+        {
+            for (auto& pPick : _vpPicks)
+            {
+                pPick = Select(pRand);
+            }
+            _iNextPick = 0;
+        }
+
+        return _vpPicks[_iNextPick++];
+    }
+
+    Target *Select(Random *pRand) const
+    {
+        if (_vTargets.size() == 1)
+        {
+            return _vTargets[0];
+        }
+
+        // the low half picks a column by multiply-shift rather than modulo, the high half decides
+        // between the column's own target and its alias
+        UINT64 ullRand = pRand->Rand64();
+        size_t iColumn = static_cast<size_t>(((ullRand & 0xFFFFFFFF) * _vTargets.size()) >> 32);
+        return ((ullRand >> 32) < _vullThreshold[iColumn]) ? _vTargets[iColumn] : _vTargets[_vAlias[iColumn]];
+    }
+
+private:
+    vector<Target *> _vTargets;
+    vector<UINT32> _vulWeights;
+
+    vector<UINT64> _vullThreshold;      // probability of keeping the column's target, scaled to 2^32
+    vector<UINT32> _vAlias;
+
+    vector<Target *> _vpPicks;
+    size_t _iNextPick = 0;
+};
+
 class IORequest
 {
 public:
     IORequest(Random *pRand) :
         _ioType(IOOperation::ReadIO),
+        _fDurable(false),
         _pRand(pRand),
+        _pTargetSelector(nullptr),
         _pCurrentTarget(nullptr),
         _ullStartTime(0),
         _ulRequestIndex(0xFFFFFFFF),
-        _ullTotalWeight(0),
-        _fEqualWeights(true),
+        _dwTransferSize(0),
+        _ulSegment(0),
         _ActivityId()
     {
         memset(&_overlapped, 0, sizeof(OVERLAPPED));
@@ -1526,40 +2916,25 @@ public:
 
     OVERLAPPED *GetOverlapped() { return &_overlapped; }
     
-    void AddTarget(Target *pTarget, UINT32 ulWeight)
-    { 
-        _vTargets.push_back(pTarget); 
-        _vulTargetWeights.push_back(ulWeight);
-        _ullTotalWeight += ulWeight;
+    // a request either always goes to one target, or picks one per I/O from its thread's selector
+    void SetTarget(Target *pTarget)
+    {
+        _pTargetSelector = nullptr;
+        _pCurrentTarget = pTarget;
+    }
 
-        if (ulWeight != _vulTargetWeights[0]) {
-            _fEqualWeights = false;
-        }
+    void SetTargetSelector(TargetSelector *pTargetSelector)
+    {
+        _pTargetSelector = pTargetSelector;
+        _pCurrentTarget = nullptr;
     }
 
-    Target *GetCurrentTarget() { return _pCurrentTarget; }
+    Target *GetCurrentTarget() const { return _pCurrentTarget; }
 
     Target *GetNextTarget()
     {
-        UINT64 ullWeight;
-
-        if (_vTargets.size() == 1) {
-            _pCurrentTarget = _vTargets[0];
-        }
-        else if (_fEqualWeights) {
-            _pCurrentTarget = _vTargets[_pRand->Rand32() % _vTargets.size()];
-        }
-        else {
-            ullWeight = _pRand->Rand64() % _ullTotalWeight;
-            
-            for (size_t iTarget = 0; iTarget < _vTargets.size(); iTarget++) {
-                if (ullWeight < _vulTargetWeights[iTarget]) {
-                    _pCurrentTarget = _vTargets[iTarget];
-                    break;
-                }
-            
-                ullWeight -= _vulTargetWeights[iTarget];
-            }
+        if (_pTargetSelector != nullptr) {
+            _pCurrentTarget = _pTargetSelector->Next(_pRand);
         }
 
         return _pCurrentTarget;
@@ -1568,26 +2943,37 @@ public:
     void SetIoType(IOOperation ioType) { _ioType = ioType; }
     IOOperation GetIoType() const { return _ioType; }
 
+    // a durable write (-wd) goes through the target's write-through handle
+    void SetDurable(bool fDurable) { _fDurable = fDurable; }
+    bool GetDurable() const { return _fDurable; }
+
     void SetStartTime(UINT64 ullStartTime) { _ullStartTime = ullStartTime; }
     UINT64 GetStartTime() const { return _ullStartTime; }
 
     void SetRequestIndex(UINT32 ulRequestIndex) { _ulRequestIndex = ulRequestIndex; }
     UINT32 GetRequestIndex() const { return _ulRequestIndex; }
 
+    void SetTransferSize(DWORD dwTransferSize) { _dwTransferSize = dwTransferSize; }
+    DWORD GetTransferSize() const { return _dwTransferSize; }
+
+    // segment of an appended target (-wa) the request's I/O went to, so that it is flushed there
+    void SetSegment(UINT32 ulSegment) { _ulSegment = ulSegment; }
+    UINT32 GetSegment() const { return _ulSegment; }
+
     void SetActivityId(GUID ActivityId) { _ActivityId = ActivityId; }
     GUID GetActivityId() const { return _ActivityId; }
 
 private:
     OVERLAPPED _overlapped;
-    vector<Target*> _vTargets;
-    vector<UINT32> _vulTargetWeights;
-    UINT64 _ullTotalWeight;
-    bool _fEqualWeights;
     Random *_pRand;
+    TargetSelector *_pTargetSelector;
     Target *_pCurrentTarget;
     IOOperation _ioType;
+    bool _fDurable;
     UINT64 _ullStartTime;
     UINT32 _ulRequestIndex;
+    DWORD _dwTransferSize;
+    UINT32 _ulSegment;
     GUID _ActivityId;
 };
 
@@ -1617,10 +3003,12 @@ public:
     ThreadParameters() :
         pProfile(nullptr),
         pTimeSpan(nullptr),
+        hLookaheadDump(nullptr),
         pullSharedSequentialOffsets(nullptr),
         ulRandSeed(0),
         ulThreadNo(0),
-        ulRelativeThreadNo(0)
+        ulRelativeThreadNo(0),
+        hSharedCompletionPort(nullptr)
     {
     }
 
@@ -1631,18 +3019,78 @@ public:
     vector<HANDLE> vhTargets;
     vector<UINT64> vullFileSizes;
 
+    // Bounds and alignment of each target's offsets, indexed to number of targets
+    vector<TargetGeometry> vTargetGeometry;
+
+    // For lookahead (-k):
+    // Per-thread batches of pregenerated I/O decisions, indexed to number of targets; empty if not used
+    vector<IOLookahead> vLookahead;
+    HANDLE hLookaheadDump;      // file the batches are appended to as they are generated (-kd), if any
+
+    // For access pattern plugins (-A):
+    // Plugin and its per-thread state, indexed to number of targets; nullptr for targets without one
+    vector<const AccessPatternPlugin *> vpAccessPatternPlugins;
+    vector<void *> vpAccessPatternStates;
+    vector<DISKSPD_IO_DECISION> vAccessPatternDecisions;   // batch as returned by the plugin
+
     vector<TARGET_IO_REQUEST_BUFFERS> vPerTargetIORequestBuffers;
     vector<IORequest> vIORequest;
+
+    // For requests shared across targets (-O):
+    // Weighted target choice, referenced by each IORequest
+    TargetSelector targetSelector;
     vector<ThroughputMeter> vThroughputMeters;
+
+    // For flushes (-wf, -wft, -wfp):
+    // Per-thread flush schedules, indexed to number of targets; empty if no target is flushed
+    vector<FlushSchedule> vFlushSchedules;
+
+    // For group commit (-wg):
+    // Per-thread committers of each target, indexed to number of targets; empty if no target uses group commit
+    vector<GroupCommit> vGroupCommits;
+
+    // For metadata workloads (-M):
+    // Per-thread directory trees, indexed to number of targets; filled in place of the handles to the targets
+    vector<MetadataTree> vMetadataTrees;
+
+    // For durable writes (-wd):
+    // Write-through handles to the targets, indexed to number of targets; the same as vhTargets
+    // for targets without durable writes
+    vector<HANDLE> vhDurableTargets;
+
+    // For append mode (-wa):
+    // Shared log of each target, indexed to number of targets; nullptr for targets which are not appended to
+    vector<AppendLog *> vpAppendLogs;
+    // Handles to the segments of the log this thread has written to, indexed to number of targets, then
+    // segment; the first is the target's own handle and the others are opened as the thread reaches them
+    vector< vector<HANDLE> > vvhAppendSegments;
+    vector<DWORD> vdwAppendSegmentFlags;    // flags the segments are opened with, indexed to number of targets
+    vector<UINT32> vulAppendFlushSegments;  // first segment the next scheduled flush (-wf) covers, indexed to number of targets
   
     // For vanilla sequential access (-s):
     // Private per-thread offsets, incremented directly, indexed to number of targets
     vector<UINT64> vullPrivateSequentialOffsets;
 
+    // For the sequential stream variants (-sn, -sr, -sk):
+    // Per-thread stream cursors, indexed to number of targets
+    vector<SequentialStreams> vSequentialStreams;
+
     // For interlocked sequential access (-si):
     // Pointers to offsets shared between threads, incremented with an interlocked op
     UINT64* pullSharedSequentialOffsets;
 
+    // For skewed random access (-rd):
+    // Per-thread offset samplers, indexed to number of targets
+    vector<OffsetDistribution> vOffsetDistributions;
+
+    // For random access without replacement (-rp):
+    // Per-thread walks of the target's block permutation, indexed to number of targets
+    vector<BlockPermutation> vBlockPermutations;
+
+    // For mixed random/sequential access (-rs):
+    // Remaining I/Os in the current sequential run, indexed to number of targets
+    vector<UINT32> vulSequentialRunRemaining;
+
     Random *pRand;
 
     UINT32 ulRandSeed;
@@ -1661,14 +3109,20 @@ public:
     WORD wGroupNum;
     DWORD bProcNum;
 
+    //group affinity of the helper thread (I/O ring submission poller or completion reaper), if any
+    WORD wHelperGroupNum;
+    DWORD bHelperProcNum;
+
     HANDLE hStartEvent;
 
     // TODO: check how it's used
-    HANDLE hEndEvent;        //used only in case of completion routines (not for IO Completion Ports)
+    HANDLE hEndEvent;        //used only by the completion routine I/O engine (alertable wait)
+
+    HANDLE hSharedCompletionPort;   //completion port of the shared completion pool (-Hp), if any
     
     bool AllocateAndFillBufferForTarget(const Target& target);
     BYTE* GetReadBuffer(size_t iTarget, size_t iRequest);
-    BYTE* GetWriteBuffer(size_t iTarget, size_t iRequest);
+    BYTE* GetWriteBuffer(size_t iTarget, size_t iRequest, DWORD cbTransfer);
     DWORD GetTotalRequestCount() const;
     bool  InitializeMappedViewForTarget(Target& target, DWORD DesiredAccess);
 
@@ -0,0 +1,63 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "MinWindows.h"
+
+// CpuTimeMeter accumulates the CPU time consumed by a thread while accounting
+// is on. The meter is bound to the accounting flag and to the counters it adds
+// to by calling Start() from the measured thread. Update() must then be called
+// periodically from the same thread; it only samples the thread times when the
+// accounting flag changes. Stop() closes an interval which is still open.
+class CpuTimeMeter
+{
+public:
+    CpuTimeMeter(void);
+
+    void Start(volatile bool *pfAccountingOn, UINT64 *pullKernelTime, UINT64 *pullUserTime);
+    void Update(void)
+    {
+        if (*_pfAccountingOn != _fAccounting)
+        {
+            _Toggle();
+        }
+    }
+    void Stop(void);
+
+private:
+    void _Toggle(void);
+
+    volatile bool *_pfAccountingOn;
+    UINT64 *_pullKernelTime;        // accumulated kernel time (100ns units)
+    UINT64 *_pullUserTime;          // accumulated user time (100ns units)
+    bool _fAccounting;              // true = an interval is open
+    UINT64 _ullKernelStart;
+    UINT64 _ullUserStart;
+};
@@ -0,0 +1,263 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include "Common.h"
+#include "OverlappedQueue.h"
+
+//
+// IoEngine is the interface between a worker thread and the mechanism used to move data to and
+// from its targets. The worker opens an engine over its unique file handles, submits IORequests
+// whose offset, type and buffer have already been chosen, and reaps their completions.
+//
+// Submit may complete an I/O inline (e.g., synchronous I/O); in that case *pfCompleted is set and
+// the request must not be expected from Reap. Reap returns true with *ppIORequest == nullptr if
+// no completion arrived within the timeout. On failure, both return false with the error code
+// available from GetLastError().
+//
+// Trims and write-zeroes are submitted without a buffer. Engines issuing through ReadFile/WriteFile
+// issue them as controls on the same handle; the completion routine and I/O ring engines, whose
+// system interfaces only move data, do not support them.
+//
+// After Open, the worker hands the engine the data buffers it will transfer to and from. Engines
+// which can pre-register memory with the system (and so avoid probing and locking pages on every
+// I/O) do so; the others ignore the call.
+//
+// Handles opened after the engine (e.g., as an appended target rolls over to a new segment) are
+// added with AddFile before the first I/O to them. Engines which bind handles to a completion port
+// associate them with it; the others have nothing to do.
+//
+// To amortize system calls, an engine may hold submitted requests until Flush, which hands all of
+// them to the system at once and reports how many it did; engines which issue each request as it
+// is submitted report none. ReapBatch returns up to cMaxCompletions completions, waiting only for
+// the first. A zero timeout never waits, and engines avoid entering the kernel for it if they can.
+//
+struct IoEngineBuffer
+{
+    BYTE *pBuffer;
+    UINT32 cbBuffer;
+};
+
+struct IoEngineCompletion
+{
+    IORequest *pIORequest;
+    DWORD dwBytesTransferred;
+};
+
+class IoEngine
+{
+public:
+    virtual ~IoEngine() {}
+
+    virtual const char *GetName() const = 0;
+    virtual bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests) = 0;
+    virtual bool RegisterBuffers(const vector<IoEngineBuffer>& vBuffers) { UNREFERENCED_PARAMETER(vBuffers); return true; }
+    virtual bool AddFile(HANDLE hFile) { UNREFERENCED_PARAMETER(hFile); return true; }
+    virtual bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred) = 0;
+    virtual bool Flush(DWORD *pcSubmitted) { *pcSubmitted = 0; return true; }
+    virtual bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds) = 0;
+    virtual bool ReapBatch(IoEngineCompletion *pCompletions, DWORD cMaxCompletions, DWORD *pcCompletions, DWORD dwMilliseconds);
+    virtual void Close() = 0;
+};
+
+//
+// Synchronous positioned I/O: ReadFile/WriteFile against handles opened without FILE_FLAG_OVERLAPPED,
+// with the offset carried in the OVERLAPPED structure (the equivalent of pread/pwrite). Every
+// submission completes inline.
+//
+class SynchronousIoEngine : public IoEngine
+{
+public:
+    const char *GetName() const { return "synchronous"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    void Close();
+};
+
+//
+// Overlapped I/O completed through a per-thread I/O completion port. Each handle is associated with
+// the port using itself as the completion key, so that batches of completions can be checked for
+// errors. Submit and Reap may be called concurrently from two different threads.
+//
+class CompletionPortIoEngine : public IoEngine
+{
+public:
+    CompletionPortIoEngine() :
+        _hCompletionPort(nullptr)
+    {
+    }
+
+    ~CompletionPortIoEngine() { Close(); }
+
+    const char *GetName() const { return "completion port"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool AddFile(HANDLE hFile);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    bool ReapBatch(IoEngineCompletion *pCompletions, DWORD cMaxCompletions, DWORD *pcCompletions, DWORD dwMilliseconds);
+    void Close();
+
+private:
+    HANDLE _hCompletionPort;
+    vector<OVERLAPPED_ENTRY> _vEntries;     // dequeued by ReapBatch
+};
+
+//
+// Overlapped I/O completed through an I/O completion port which is shared by all worker threads
+// and drained by a separate pool of threads (-Hp). Each handle is associated with the port using
+// the key given by the worker, so that the pool can find the worker a completion belongs to. The
+// port belongs to the pool, and completions cannot be reaped through the engine.
+//
+class SharedCompletionPortIoEngine : public IoEngine
+{
+public:
+    SharedCompletionPortIoEngine(HANDLE hCompletionPort, ULONG_PTR ulCompletionKey) :
+        _hCompletionPort(hCompletionPort),
+        _ulCompletionKey(ulCompletionKey)
+    {
+    }
+
+    const char *GetName() const { return "shared completion port"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool AddFile(HANDLE hFile);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    void Close() {}
+
+private:
+    HANDLE _hCompletionPort;
+    ULONG_PTR _ulCompletionKey;
+};
+
+//
+// Overlapped I/O completed through completion routines (ReadFileEx/WriteFileEx). The routines run
+// as APCs while Reap waits alertably on the end-of-run event; they only queue the completed request,
+// which Reap then hands back to the worker loop.
+//
+class CompletionRoutineIoEngine : public IoEngine
+{
+public:
+    CompletionRoutineIoEngine(HANDLE hEndEvent) :
+        _hEndEvent(hEndEvent),
+        _dwError(ERROR_SUCCESS)
+    {
+    }
+
+    const char *GetName() const { return "completion routine"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    void Close();
+
+private:
+    static VOID CALLBACK _CompletionRoutine(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED pOverlapped);
+
+    HANDLE _hEndEvent;
+    DWORD _dwError;                     // first error reported to a completion routine
+    OverlappedQueue _completedQueue;    // requests completed by the routines, not yet reaped
+};
+
+//
+// Overlapped I/O completed through a per-request event, reaped by waiting on the events of all the
+// outstanding requests at once. This needs neither a completion port nor alertable waits, so it
+// works on any handle and any version of Windows, at up to MAXIMUM_WAIT_OBJECTS outstanding I/Os
+// per thread.
+//
+class EventIoEngine : public IoEngine
+{
+public:
+    EventIoEngine() :
+        _cPending(0)
+    {
+    }
+
+    ~EventIoEngine() { Close(); }
+
+    const char *GetName() const { return "event"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    void Close();
+
+private:
+    struct PendingIO
+    {
+        IORequest *pIORequest;
+        HANDLE hFile;
+    };
+
+    vector<HANDLE> _vhEvents;       // one manual-reset event per outstanding I/O
+    vector<PendingIO> _vPending;    // requests in flight, parallel to _vhEvents
+    DWORD _cPending;                // the first _cPending events are in flight; the rest are free
+};
+
+//
+// Overlapped I/O whose completions are polled for rather than waited on. The handles are not
+// associated with a completion port, so Reap scans the outstanding requests for one whose OVERLAPPED
+// is no longer pending and never blocks in the kernel; the timeout is ignored. This trades a busy
+// core for the wakeup latency of an interrupt-driven completion, and is meant for unbuffered targets.
+//
+class PolledIoEngine : public IoEngine
+{
+public:
+    const char *GetName() const { return "polled"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    void Close();
+
+private:
+    struct PendingIO
+    {
+        IORequest *pIORequest;
+        HANDLE hFile;
+    };
+
+    vector<PendingIO> _vPending;    // submitted requests which have not been reaped
+};
+
+//
+// I/O submitted and completed through a per-thread I/O ring (IoRing API). The ring's submission
+// and completion queues are sized to the thread's outstanding request count, and each entry carries
+// its IORequest in the user data field. The file handles and data buffers are registered with the
+// ring up front, and entries refer to them by index.
+//
+// With a submission poller, the worker does not submit to the ring itself: it hands requests to a
+// dedicated thread, affinitized per the timespan's affinity model, which spins building and submitting
+// entries, while the worker only reaps completions. The poller's CPU time during the measured
+// interval is recorded in the thread's results.
+//
+// The API is only present on recent versions of Windows, so it is resolved at run time:
+// LoadIoRingApi must succeed before CreateIoRingIoEngine is called.
+//
+bool LoadIoRingApi();
+IoEngine *CreateIoRingIoEngine(ThreadParameters *p);
@@ -0,0 +1,63 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "MinWindows.h"
+#include <atomic>
+#include <vector>
+
+//
+// OverlappedRing is a fixed-capacity, lock-free queue of OVERLAPPED elements for handing them from
+// exactly one producer thread to exactly one consumer thread. Unlike OverlappedQueue, it does not
+// link the elements through their Internal field, so an element may be in flight while it is queued.
+//
+class OverlappedRing
+{
+public:
+    OverlappedRing(void);
+
+    void Initialize(size_t cCapacity);
+
+    // producer side; fails if the ring is full
+    bool Add(OVERLAPPED *pOverlapped);
+
+    // consumer side; returns nullptr if the ring is empty
+    OVERLAPPED *Remove(void);
+
+    bool IsEmpty(void) const;
+
+private:
+    std::vector<OVERLAPPED *> _vpSlots;
+    size_t _cCapacity;
+
+    // head and tail are written by different threads; keep them on separate cache lines
+    alignas(64) std::atomic<size_t> _iHead;     // next slot to remove, written by the consumer
+    alignas(64) std::atomic<size_t> _iTail;     // next slot to fill, written by the producer
+};
@@ -49,14 +49,22 @@ private:
     void _PrintProfile(const Profile& profile);
     void _PrintSystemInfo(const SystemInformation& system);
     void _PrintCpuUtilization(const Results& results, const SystemInformation& system);
-    enum class _SectionEnum {TOTAL, READ, WRITE};
+    void _PrintThreadCpuUtilization(const vector<ThreadResults>& vThreadResults, UINT64 ullTimeCount, const char *pszTitle, bool fHelper);
+    void _PrintBatching(const Results& results);
+    enum class _SectionEnum {TOTAL, READ, WRITE, TRIM, WRITE_ZEROES, DURABLE_WRITE};
     void _PrintSectionFieldNames(const TimeSpan& timeSpan);
     void _PrintSectionBorderLine(const TimeSpan& timeSpan);
     void _PrintSection(_SectionEnum, const TimeSpan&, const Results&);
+    void _PrintFlushes(const TimeSpan& timeSpan, const Results& results);
+    void _PrintCommits(const TimeSpan& timeSpan, const Results& results);
+    void _PrintMetadataOperations(const TimeSpan& timeSpan, const Results& results);
     void _PrintLatencyPercentiles(const Results&);
     void _PrintLatencyChart(const Histogram<float>& readLatencyHistogram,
         const Histogram<float>& writeLatencyHistogram,
-        const Histogram<float>& totalLatencyHistogram);
+        const Histogram<float>& totalLatencyHistogram,
+        const char *pszReadName = "Read",
+        const char *pszWriteName = "Write");
+    void _PrintMetadataLatencyChart(const vector<Histogram<float>>& vLatencyHistograms);
 
     void _PrintLatencyBuckets(const Results& results, ConstHistogramBucketListPtr histogramBucketList, double fTestDurationInSeconds);
     void _PrintLatencyBucketsChart(const Histogram<float>& readLatencyHistogram,
@@ -65,7 +73,7 @@ private:
         ConstHistogramBucketListPtr histogramBucketList);
         
     void _PrintTimeSpan(const TimeSpan &timeSpan);
-    void _PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines);
+    void _PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines, bool fIoRing, bool fEventCompletions);
 
     string _sResult;
 
@@ -48,6 +48,8 @@ private:
     HRESULT _ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseThreadTargets(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseThreadTarget(IXMLDOMNode *pXmlNode, ThreadTarget *pThreadTarget);
+    HRESULT _ParseBlockSizeWeights(IXMLDOMNode *pXmlNode, const char *pszQuery, IOOperation ioType, Target *pTarget);
+    HRESULT _ParseDistribution(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseAffinityAssignment(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
     HRESULT _ParseAffinityGroupAssignment(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
 
@@ -55,6 +57,7 @@ private:
     HRESULT _GetUINT32(IXMLDOMNode *pXmlNode, const char *pszQuery, UINT32 *pulValue) const;
     HRESULT _GetUINT64(IXMLDOMNode *pXmlNode, const char *pszQuery, UINT64 *pullValue) const;
     HRESULT _GetDWORD(IXMLDOMNode *pXmlNode, const char *pszQuery, DWORD *pdwValue) const;
+    HRESULT _GetDouble(IXMLDOMNode *pXmlNode, const char *pszQuery, double *plfValue) const;
     HRESULT _GetBool(IXMLDOMNode *pXmlNode, const char *pszQuery, bool *pfValue) const;
 
     HRESULT _GetUINT32Attr(IXMLDOMNode *pXmlNode, const char *pszAttr, UINT32 *pulValue) const;
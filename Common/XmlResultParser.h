@@ -57,6 +57,8 @@ private:
     void _OutputLatencyInMilliseconds(const std::string& name, double value);
 
     void _OutputCpuUtilization(const Results& results, const SystemInformation& system);
+    void _OutputThreadCpuUtilization(const char *pszElement, UINT64 ullUserTime, UINT64 ullKernelTime, double fTime);
+    void _OutputBatching(const ThreadResults& threadResults);
     void _OutputETW(struct ETWMask ETWMask, struct ETWEventCounters EtwEventCounters);
     void _OutputETWSessionInfo(struct ETWSessionInfo sessionInfo);
     void _OutputLatencyPercentiles(const Histogram<float>& readLatencyHistogram, const Histogram<float>& writeLatencyHistogram,
@@ -68,7 +70,11 @@ private:
     void _OutputLatencySummary(const Histogram<float>& readLatencyHistogram, const Histogram<float>& writeLatencyHistogram,
         const Histogram<float>& totalLatencyHistogram, ConstHistogramBucketListPtr histogramBucketList, double fTestDurationInSeconds);
     void _OutputLatencySummary(const Histogram<float>& latencyHistogram, const std::string& latencyHistogramName);
-    void _OutputTargetIops(const IoBucketizer& readBucketizer, const IoBucketizer& writeBucketizer, UINT32 bucketTimeInMs);
+    void _OutputTargetIops(const IoBucketizer& readBucketizer,
+                           const IoBucketizer& writeBucketizer,
+                           const IoBucketizer& trimBucketizer,
+                           const IoBucketizer& writeZeroesBucketizer,
+                           UINT32 bucketTimeInMs);
     void _OutputOverallIops(const Results& results, UINT32 bucketTimeInMs);
     void _OutputIops(const IoBucketizer& readBucketizer, const IoBucketizer& writeBucketizer, UINT32 bucketTimeInMs);
 
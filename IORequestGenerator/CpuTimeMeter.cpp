@@ -0,0 +1,98 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "CpuTimeMeter.h"
+#include <assert.h>
+
+static void GetCurrentThreadCpuTimes(UINT64 *pullKernelTime, UINT64 *pullUserTime)
+{
+    FILETIME ftCreation, ftExit, ftKernel, ftUser;
+
+    if (GetThreadTimes(GetCurrentThread(), &ftCreation, &ftExit, &ftKernel, &ftUser))
+    {
+        *pullKernelTime = ((UINT64)ftKernel.dwHighDateTime << 32) | ftKernel.dwLowDateTime;
+        *pullUserTime = ((UINT64)ftUser.dwHighDateTime << 32) | ftUser.dwLowDateTime;
+    }
+    else
+    {
+        *pullKernelTime = 0;
+        *pullUserTime = 0;
+    }
+}
+
+CpuTimeMeter::CpuTimeMeter(void) :
+    _pfAccountingOn(nullptr),
+    _pullKernelTime(nullptr),
+    _pullUserTime(nullptr),
+    _fAccounting(false),
+    _ullKernelStart(0),
+    _ullUserStart(0)
+{
+}
+
+void CpuTimeMeter::Start(volatile bool *pfAccountingOn, UINT64 *pullKernelTime, UINT64 *pullUserTime)
+{
+    assert(nullptr != pfAccountingOn);
+
+    _pfAccountingOn = pfAccountingOn;
+    _pullKernelTime = pullKernelTime;
+    _pullUserTime = pullUserTime;
+    _fAccounting = false;
+
+    Update();
+}
+
+void CpuTimeMeter::Stop(void)
+{
+    if (_fAccounting)
+    {
+        _Toggle();
+    }
+}
+
+void CpuTimeMeter::_Toggle(void)
+{
+    UINT64 ullKernelTime;
+    UINT64 ullUserTime;
+
+    GetCurrentThreadCpuTimes(&ullKernelTime, &ullUserTime);
+
+    if (!_fAccounting)
+    {
+        _ullKernelStart = ullKernelTime;
+        _ullUserStart = ullUserTime;
+    }
+    else
+    {
+        *_pullKernelTime += ullKernelTime - _ullKernelStart;
+        *_pullUserTime += ullUserTime - _ullUserStart;
+    }
+
+    _fAccounting = !_fAccounting;
+}
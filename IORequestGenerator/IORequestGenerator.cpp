@@ -39,7 +39,10 @@ SOFTWARE.
 #include "IORequestGenerator.h"
 #include "etw.h"
 #include "ThroughputMeter.h"
+#include "CpuTimeMeter.h"
 #include "OverlappedQueue.h"
+#include "OverlappedRing.h"
+#include "IoEngine.h"
 
 #include <Winioctl.h>   //DISK_GEOMETRY
 
@@ -59,6 +62,14 @@ namespace fs = std::filesystem;
 #define FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN    (0x00000001)
 #endif
 
+// Flags for NtFlushBuffersFileEx
+#ifndef FLUSH_FLAGS_FILE_DATA_SYNC_ONLY
+#define FLUSH_FLAGS_FILE_DATA_SYNC_ONLY     (0x00000004)
+#endif
+
+// Decisions asked of an access pattern plugin at a time, unless -k sets the lookahead depth
+#define DEFAULT_ACCESS_PATTERN_BATCH    64
+
 /*****************************************************************************/
 // gets size of a dynamic volume, return zero on failure
 //
@@ -433,6 +444,9 @@ static RtlGetNvToken g_pfnRtlGetNonVolatileToken;
 typedef NTSTATUS(__stdcall *RtlFreeNvToken)(PVOID);
 static RtlFreeNvToken g_pfnRtlFreeNonVolatileToken;
 
+typedef NTSTATUS (__stdcall *NtFlushBuffersEx)(HANDLE, ULONG, PVOID, ULONG, PIO_STATUS_BLOCK);
+static NtFlushBuffersEx g_pfnNtFlushBuffersFileEx;
+
 static PRINTF g_pfnPrintOut = nullptr;
 static PRINTF g_pfnPrintError = nullptr;
 static PRINTF g_pfnPrintVerbose = nullptr;
@@ -575,6 +589,7 @@ bool IORequestGenerator::_LoadDLLs()
     g_pfnRtlFlushNonVolatileMemory = (RtlFlushNvMemory)GetProcAddress(_hNTDLL, "RtlFlushNonVolatileMemory");
     g_pfnRtlGetNonVolatileToken = (RtlGetNvToken)GetProcAddress(_hNTDLL, "RtlGetNonVolatileToken");
     g_pfnRtlFreeNonVolatileToken = (RtlFreeNvToken)GetProcAddress(_hNTDLL, "RtlFreeNonVolatileToken");
+    g_pfnNtFlushBuffersFileEx = (NtFlushBuffersEx)GetProcAddress(_hNTDLL, "NtFlushBuffersFileEx");
 
     return true;
 }
@@ -651,48 +666,100 @@ __inline UINT64 IORequestGenerator::GetNextFileOffset(ThreadParameters& tp, size
 {
     Target &target = tp.vTargets[targetNum];
 
-    UINT64 blockAlignment = target.GetBlockAlignmentInBytes();
-    UINT64 baseFileOffset = target.GetBaseFileOffsetInBytes();
-    UINT64 baseThreadOffset = target.GetThreadBaseFileOffsetInBytes(tp.ulRelativeThreadNo);
-    UINT64 blockSize = target.GetBlockSizeInBytes();
+    // bounds and alignment are precalculated once the target size is known, see TargetGeometry
+    const TargetGeometry& geometry = tp.vTargetGeometry[targetNum];
+    UINT64 blockAlignment = geometry.ullAlignment;
     UINT64 nextBlockOffset;
 
-    // now apply bounds for IO offset
-    // aligned target size is the closed interval of byte offsets at which it is legal to issue IO
-    // ISSUE IMPROVEMENT: much of this should be precalculated. It belongs within Target, which will
-    //      need discovery of target sizing moved from its current just-in-time at thread launch.
-    UINT64 alignedTargetSize = tp.vullFileSizes[targetNum] - baseFileOffset - blockSize;
-
     if (target.GetUseRandomAccessPattern() ||
         target.GetUseInterlockedSequential())
     {
-        // convert aligned target size to the open interval
-        alignedTargetSize = ((alignedTargetSize / blockAlignment) + 1) * blockAlignment;
-
         // increment/produce - note, logically relative to base offset
         if (target.GetUseRandomAccessPattern())
         {
-            nextBlockOffset = tp.pRand->Rand64();
-            nextBlockOffset -= (nextBlockOffset % blockAlignment);
-            nextBlockOffset %= alignedTargetSize;
+            bool fRandom = true;
+            UINT32 ulRandomRatio = target.GetRandomRatio();
+
+            if (ulRandomRatio < 100)
+            {
+                // mixed random/sequential: each random I/O is followed by a sequential run continuing from it.
+                // runs are decided at their start, weighted by the mean run length so that the random I/O
+                // still makes up ulRandomRatio percent of the total: P(random) = r*m / (r*m + (100 - r))
+                UINT32 &ulRunRemaining = tp.vulSequentialRunRemaining[targetNum];
+                if (ulRunRemaining > 0)
+                {
+                    ulRunRemaining--;
+                    fRandom = false;
+                }
+                else
+                {
+                    UINT32 ulMinRun = target.GetMinSequentialRun();
+                    UINT32 ulMaxRun = target.GetMaxSequentialRun();
+                    UINT64 ullRandomWeight = static_cast<UINT64>(ulRandomRatio) * (ulMinRun + ulMaxRun);
+
+                    fRandom = Util::MultiplyHigh64(tp.pRand->Rand64(), ullRandomWeight + 2 * (100 - ulRandomRatio)) < ullRandomWeight;
+                    if (!fRandom)
+                    {
+                        UINT32 ulRunSpan = ulMaxRun - ulMinRun + 1;
+                        ulRunRemaining = ulMinRun + static_cast<UINT32>((static_cast<UINT64>(tp.pRand->Rand32()) * ulRunSpan) >> 32) - 1;
+                    }
+                }
+            }
+
+            if (!fRandom)
+            {
+                // step by the block size rounded up to the alignment, so the run is contiguous and stays aligned
+                nextBlockOffset = tp.vullPrivateSequentialOffsets[targetNum] + geometry.ullRunStride;
+                if (nextBlockOffset >= geometry.ullOpenSize)
+                {
+                    nextBlockOffset = 0;
+                }
+            }
+            else if (target.GetUseRandomPermutation())
+            {
+                nextBlockOffset = geometry.BlockToOffset(tp.vBlockPermutations[targetNum].NextBlock());
+            }
+            else if (target.GetRandomDistribution() != DistributionType::Uniform)
+            {
+                const OffsetDistribution& distribution = tp.vOffsetDistributions[targetNum];
+                UINT64 ullBlock = distribution.NextBlock(tp.pRand);
+                if (distribution.GetUseDrift())
+                {
+                    ullBlock = distribution.Drift(ullBlock, PerfTimer::GetTime());
+                }
+                nextBlockOffset = geometry.BlockToOffset(ullBlock);
+            }
+            else
+            {
+                nextBlockOffset = geometry.RandomOffset(tp.pRand);
+            }
+
+            if (ulRandomRatio < 100)
+            {
+                tp.vullPrivateSequentialOffsets[targetNum] = nextBlockOffset;
+            }
         }
         else
         {
             nextBlockOffset = InterlockedAdd64((PLONGLONG) &tp.pullSharedSequentialOffsets[targetNum], blockAlignment) - blockAlignment;
-            nextBlockOffset %= alignedTargetSize;
+            nextBlockOffset = geometry.WrapOffset(nextBlockOffset);
         }
     }
+    else if (target.GetUseSequentialStreams())
+    {
+        nextBlockOffset = tp.vSequentialStreams[targetNum].NextOffset();
+    }
     else
     {
         if (prevOffset == FIRST_OFFSET)
         {
-            nextBlockOffset = baseThreadOffset - baseFileOffset;
+            nextBlockOffset = target.GetThreadBaseFileOffsetInBytes(tp.ulRelativeThreadNo) - geometry.ullBaseFileOffset;
         }
         else 
         {
             if (target.GetUseParallelAsyncIO())
             {
-                nextBlockOffset = prevOffset - baseFileOffset + blockAlignment;
+                nextBlockOffset = prevOffset - geometry.ullBaseFileOffset + blockAlignment;
             }
             else // normal sequential access pattern
             {
@@ -702,8 +769,8 @@ __inline UINT64 IORequestGenerator::GetNextFileOffset(ThreadParameters& tp, size
 
         // parasync and seq bases are potentially modified by threadstride and loop back to the
         // file base offset + increment which will return them to their initial base offset.
-        if (nextBlockOffset > alignedTargetSize) {
-            nextBlockOffset = (baseThreadOffset - baseFileOffset) % blockAlignment;
+        if (nextBlockOffset > geometry.ullLastOffset) {
+            nextBlockOffset = (target.GetThreadBaseFileOffsetInBytes(tp.ulRelativeThreadNo) - geometry.ullBaseFileOffset) % blockAlignment;
 
         }
 
@@ -714,46 +781,467 @@ __inline UINT64 IORequestGenerator::GetNextFileOffset(ThreadParameters& tp, size
     }
 
     // Convert into the next full offset
-    nextBlockOffset += baseFileOffset;
+    nextBlockOffset += geometry.ullBaseFileOffset;
 
 #ifndef NDEBUG
     // Don't overrun the end of the file
     UINT64 fileSize = tp.vullFileSizes[targetNum];
-    assert(nextBlockOffset + blockSize <= fileSize);
+    assert(nextBlockOffset + geometry.ullMaxBlockSize <= fileSize);
 #endif
 
     return nextBlockOffset;
 }
 
 /*****************************************************************************/
-// Decide the kind of IO to issue during a mix test
+// Decide the kind of IO to issue during a mix test: writes, trims and write-zeroes take
+// consecutive slices of the percentage range, and reads get the rest
 // Future Work: Add more types of distribution in addition to random
-__inline static IOOperation DecideIo(Random *pRand, UINT32 ulWriteRatio)
+__inline static IOOperation DecideIo(Random *pRand, UINT32 ulWriteRatio, UINT32 ulTrimRatio, UINT32 ulWriteZeroesRatio)
+{
+    // scale to [1, 100] by multiply and shift rather than modulo
+    UINT32 ulPercent = static_cast<UINT32>((static_cast<UINT64>(pRand->Rand32()) * 100) >> 32) + 1;
+    if (ulPercent <= ulWriteRatio)
+    {
+        return IOOperation::WriteIO;
+    }
+
+    ulPercent -= ulWriteRatio;
+    if (ulPercent <= ulTrimRatio)
+    {
+        return IOOperation::TrimIO;
+    }
+
+    ulPercent -= ulTrimRatio;
+    return (ulPercent > ulWriteZeroesRatio) ? IOOperation::ReadIO : IOOperation::WriteZeroesIO;
+}
+
+/*****************************************************************************/
+// Decide whether a write is durable (-wd), i.e. issued through the target's write-through handle
+__inline static bool DecideDurable(Random *pRand, UINT32 ulDurableWriteRatio)
+{
+    if (ulDurableWriteRatio == 0 || ulDurableWriteRatio == 100)
+    {
+        return ulDurableWriteRatio == 100;
+    }
+
+    // scale to [0, 100) by multiply and shift rather than modulo
+    return static_cast<UINT32>((static_cast<UINT64>(pRand->Rand32()) * 100) >> 32) < ulDurableWriteRatio;
+}
+
+/*****************************************************************************/
+// Apply the target's caching and priority settings to a handle just opened to it
+//
+static bool configureHandle(const Target& target, HANDLE hFile, const string& sPath)
+{
+    if (target.GetCacheMode() == TargetCacheMode::DisableLocalCache)
+    {
+        DWORD Status = DisableLocalCache(hFile);
+        if (Status != ERROR_SUCCESS)
+        {
+            PrintError("Failed to disable local caching (error %u). NOTE: only supported on remote filesystems with Windows 8 or newer.\n", Status);
+            return false;
+        }
+    }
+
+    //set IO priority
+    if (target.GetIOPriorityHint() != IoPriorityHintNormal)
+    {
+        _declspec(align(8)) FILE_IO_PRIORITY_HINT_INFO hintInfo;
+        hintInfo.PriorityHint = target.GetIOPriorityHint();
+        if (!SetFileInformationByHandle(hFile, FileIoPriorityHintInfo, &hintInfo, sizeof(hintInfo)))
+        {
+            PrintError("Error setting IO priority for file: %s [%u]\n", sPath.c_str(), GetLastError());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+// Handle through which the thread writes to a segment of an appended target (-wa). The thread opens
+// each segment, and adds it to its I/O engine, when the log first hands it an offset within it.
+//
+static bool getAppendSegment(ThreadParameters *p, IoEngine *pIoEngine, size_t iTarget, UINT32 ulSegment, HANDLE *phFile)
+{
+    vector<HANDLE>& vhSegments = p->vvhAppendSegments[iTarget];
+    if (ulSegment < vhSegments.size() && vhSegments[ulSegment] != nullptr)
+    {
+        *phFile = vhSegments[ulSegment];
+        return true;
+    }
+
+    const Target& target = p->vTargets[iTarget];
+    string sPath = AppendLog::GetSegmentPath(target.GetPath(), ulSegment);
+    HANDLE hFile = CreateFile(sPath.c_str(),
+        GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,        //security
+        OPEN_EXISTING,
+        p->vdwAppendSegmentFlags[iTarget],
+        nullptr);       //template file
+    if (INVALID_HANDLE_VALUE == hFile)
+    {
+        PrintError("thread %u: error opening segment '%s' (error code: %u)\n", p->ulThreadNo, sPath.c_str(), GetLastError());
+        return false;
+    }
+
+    // from here on the handle is closed with the thread's other segments
+    if (ulSegment >= vhSegments.size())
+    {
+        vhSegments.resize(ulSegment + 1, nullptr);
+    }
+    vhSegments[ulSegment] = hFile;
+
+    if (!configureHandle(target, hFile, sPath))
+    {
+        return false;
+    }
+
+    if (!pIoEngine->AddFile(hFile))
+    {
+        PrintError("thread %u: unable to add segment '%s' to %s I/O engine (error code: %u)\n", p->ulThreadNo, sPath.c_str(), pIoEngine->GetName(), GetLastError());
+        return false;
+    }
+
+    *phFile = hFile;
+    return true;
+}
+
+/*****************************************************************************/
+// Flush one file of a target: the target itself, or a segment of an appended target
+static bool flushFile(ThreadParameters *p, size_t iTarget, HANDLE hFile)
+{
+    if (p->vTargets[iTarget].GetFlushDataOnly())
+    {
+        IO_STATUS_BLOCK ioStatusBlock;
+        NTSTATUS status = g_pfnNtFlushBuffersFileEx(hFile, FLUSH_FLAGS_FILE_DATA_SYNC_ONLY, nullptr, 0, &ioStatusBlock);
+
+        // as FlushFileBuffers does, wait out a flush pending on a handle opened for overlapped I/O
+        if (status == (NTSTATUS)STATUS_PENDING)
+        {
+            WaitForSingleObject(hFile, INFINITE);
+            status = ioStatusBlock.Status;
+        }
+
+        if (!NT_SUCCESS(status))
+        {
+            PrintError("thread %u: error flushing target '%s' (status: 0x%x)\n", p->ulThreadNo, p->vTargets[iTarget].GetPath().c_str(), status);
+            return false;
+        }
+    }
+    else if (!FlushFileBuffers(hFile))
+    {
+        PrintError("thread %u: error flushing target '%s' (error code: %u)\n", p->ulThreadNo, p->vTargets[iTarget].GetPath().c_str(), GetLastError());
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+// Flush a target on behalf of the worker thread (-wf, -wft, -wfp, -wg). The flush is synchronous and is
+// timed on its own; only the worker thread touches the flush counters, so no lock is needed even
+// when another thread reaps the thread's I/O.
+//
+// Given a request, only the file its write went to is flushed. Otherwise, on an appended target, every
+// segment which may hold a write completed since the last such flush is: those from the oldest segment
+// still being written by a request at the last flush up to the newest.
+static bool flushTarget(ThreadParameters *p, size_t iTarget, const IORequest *pIORequest)
+{
+    const vector<HANDLE>& vhSegments = p->vvhAppendSegments[iTarget];
+    UINT64 ullStartTime = PerfTimer::GetTime();
+
+    if (vhSegments.empty())
+    {
+        if (!flushFile(p, iTarget, p->vhTargets[iTarget]))
+        {
+            return false;
+        }
+    }
+    else if (pIORequest != nullptr)
+    {
+        if (!flushFile(p, iTarget, vhSegments[pIORequest->GetSegment()]))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        for (size_t i = p->vulAppendFlushSegments[iTarget]; i < vhSegments.size(); i++)
+        {
+            // segments other threads wrote all of are never opened here
+            if (vhSegments[i] != nullptr && !flushFile(p, iTarget, vhSegments[i]))
+            {
+                return false;
+            }
+        }
+
+        // a write still in flight is covered by the next flush; a request is only reissued once its
+        // I/O has completed, so its segment is that of its last write to the target
+        UINT32 ulNextSegment = (UINT32)(vhSegments.size() - 1);
+        for (const auto& ioRequest : p->vIORequest)
+        {
+            if (ioRequest.GetCurrentTarget() == &p->vTargets[iTarget])
+            {
+                ulNextSegment = std::min(ulNextSegment, ioRequest.GetSegment());
+            }
+        }
+        p->vulAppendFlushSegments[iTarget] = ulNextSegment;
+    }
+
+    if (*p->pfAccountingOn)
+    {
+        p->pResults->vTargetResults[iTarget].AddFlush(ullStartTime, p->pTimeSpan->GetMeasureLatency());
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+// Completes the group commit written by a request: the group is flushed and its committers released.
+// Called on the worker thread, once the request's write has been accounted for.
+//
+static bool commitGroup(ThreadParameters *p, IORequest *pIORequest)
+{
+    size_t iTarget = pIORequest->GetCurrentTarget() - &p->vTargets[0];
+
+    if (p->vGroupCommits.size() == 0 || !p->vGroupCommits[iTarget].IsEnabled())
+    {
+        return true;
+    }
+
+    if (!flushTarget(p, iTarget, pIORequest))
+    {
+        return false;
+    }
+
+    TargetResults *pTargetResults = *p->pfAccountingOn ? &p->pResults->vTargetResults[iTarget] : nullptr;
+    p->vGroupCommits[iTarget].Release(pIORequest->GetRequestIndex(), PerfTimer::GetTime(), pTargetResults, p->pTimeSpan->GetMeasureLatency());
+
+    return true;
+}
+
+/*****************************************************************************/
+// Name of the kind of IO, as traced and reported in errors
+static const char *ioTypeName(IOOperation ioType)
+{
+    switch (ioType)
+    {
+    case IOOperation::ReadIO:
+        return "Read";
+    case IOOperation::WriteIO:
+        return "Write";
+    case IOOperation::TrimIO:
+        return "Trim";
+    default:
+        return "WriteZeroes";
+    }
+}
+
+/*****************************************************************************/
+// Append a freshly generated lookahead batch to the dump file (-kd) as CSV:
+// thread,target,offset,type,size. Offsets which are not pregenerated are left empty; the type is
+// r, w, t (trim) or z (write zeroes).
+// Best effort, as a debugging aid; each batch goes out in one append so threads do not interleave lines.
+static void dumpLookahead(const ThreadParameters *p, size_t iTarget, const IOLookahead& lookahead, const vector<IOLookahead::Decision>& vDecisions)
 {
-    return ((pRand->Rand32() % 100 + 1) > ulWriteRatio) ? IOOperation::ReadIO : IOOperation::WriteIO;
+    string sBatch;
+    char buffer[128];
+
+    for (const auto& decision : vDecisions)
+    {
+        char chType = 'r';
+        switch (decision.ioType)
+        {
+        case IOOperation::WriteIO:
+            chType = 'w';
+            break;
+        case IOOperation::TrimIO:
+            chType = 't';
+            break;
+        case IOOperation::WriteZeroesIO:
+            chType = 'z';
+            break;
+        }
+
+        if (lookahead.GetUseOffsets())
+        {
+            sprintf_s(buffer, _countof(buffer), "%u,%d,%I64u,%c,%u\n",
+                      p->ulThreadNo,
+                      p->vTargets[iTarget].GetTargetID(),
+                      decision.ullOffset,
+                      chType,
+                      decision.dwTransferSize);
+        }
+        else
+        {
+            sprintf_s(buffer, _countof(buffer), "%u,%d,,%c,%u\n",
+                      p->ulThreadNo,
+                      p->vTargets[iTarget].GetTargetID(),
+                      chType,
+                      decision.dwTransferSize);
+        }
+        sBatch += buffer;
+    }
+
+    DWORD cbWritten;
+    WriteFile(p->hLookaheadDump, sBatch.c_str(), static_cast<DWORD>(sBatch.length()), &cbWritten, nullptr);
 }
 
-VOID CALLBACK fileIOCompletionRoutine(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED pOverlapped);
+/*****************************************************************************/
+// Refill a target's lookahead batch (-k). Each kind of decision is generated in its own pass so that
+// the loops stay small; offsets are generated first, in the order the I/O will be issued. Targets
+// using an access pattern plugin (-A) get their offsets and types from it instead.
+static void fillLookahead(ThreadParameters *p, size_t iTarget)
+{
+    IOLookahead& lookahead = p->vLookahead[iTarget];
+    const Target& target = p->vTargets[iTarget];
+    vector<IOLookahead::Decision>& vDecisions = lookahead.GetDecisions();
+
+    const AccessPatternPlugin *pPlugin = p->vpAccessPatternPlugins.empty() ? nullptr : p->vpAccessPatternPlugins[iTarget];
+    if (pPlugin != nullptr)
+    {
+        // the plugin decides offsets and types together; offsets beyond the last one at which
+        // an I/O fits are wrapped, in whole blocks, rather than trusted
+        const TargetGeometry& geometry = p->vTargetGeometry[iTarget];
+        vector<DISKSPD_IO_DECISION>& vPluginDecisions = p->vAccessPatternDecisions;
+        vPluginDecisions.resize(vDecisions.size());
+        pPlugin->Generate(p->vpAccessPatternStates[iTarget], &vPluginDecisions[0], static_cast<UINT32>(vPluginDecisions.size()));
+
+        for (size_t i = 0; i < vDecisions.size(); i++)
+        {
+            UINT64 ullOffset = vPluginDecisions[i].Offset;
+            if (ullOffset > geometry.ullLastOffset)
+            {
+                ullOffset = geometry.WrapToBlock(ullOffset);
+            }
+            vDecisions[i].ullOffset = geometry.ullBaseFileOffset + ullOffset;
+            vDecisions[i].ioType = vPluginDecisions[i].Write ? IOOperation::WriteIO : IOOperation::ReadIO;
+        }
+    }
+    else
+    {
+        if (lookahead.GetUseOffsets())
+        {
+            // random access does not depend on the previous offset of the request
+            for (auto& decision : vDecisions)
+            {
+                decision.ullOffset = IORequestGenerator::GetNextFileOffset(*p, iTarget, 0);
+            }
+        }
+
+        UINT32 ulWriteRatio = target.GetWriteRatio();
+        UINT32 ulTrimRatio = target.GetTrimRatio();
+        UINT32 ulWriteZeroesRatio = target.GetWriteZeroesRatio();
+        for (auto& decision : vDecisions)
+        {
+            decision.ioType = DecideIo(p->pRand, ulWriteRatio, ulTrimRatio, ulWriteZeroesRatio);
+        }
+    }
+
+    for (auto& decision : vDecisions)
+    {
+        decision.dwTransferSize = target.GetNextBlockSizeInBytes(decision.ioType, p->pRand);
+    }
+
+    if (p->hLookaheadDump != nullptr)
+    {
+        dumpLookahead(p, iTarget, lookahead, vDecisions);
+    }
+
+    lookahead.Rewind();
+}
 
-static bool issueNextIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBytesTransferred, bool useCompletionRoutines)
+static bool issueNextIO(ThreadParameters *p, IoEngine *pIoEngine, IORequest *pIORequest, bool *pfCompleted, DWORD *pdwBytesTransferred)
 {
     OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
     Target *pTarget = pIORequest->GetCurrentTarget();
     size_t iTarget = pTarget - &p->vTargets[0];
     UINT32 iRequest = pIORequest->GetRequestIndex();
+    AppendLog *pAppendLog = p->vpAppendLogs.empty() ? nullptr : p->vpAppendLogs[iTarget];
+    HANDLE hFile = p->vhTargets[iTarget];
     LARGE_INTEGER li;
-    BOOL rslt = true;
+    bool fOk = true;
+
+    IOOperation readOrWrite;
+    DWORD cbTransfer;
 
     li.LowPart = pOverlapped->Offset;
     li.HighPart = pOverlapped->OffsetHigh;
+
+    // a flush which has fallen due goes out ahead of the I/O
+    if (p->vFlushSchedules.size() != 0 &&
+        p->vFlushSchedules[iTarget].IsEnabled() &&
+        p->vFlushSchedules[iTarget].IsDue(p->pRand))
+    {
+        if (!flushTarget(p, iTarget, nullptr))
+        {
+            return false;
+        }
+    }
     
-    li.QuadPart = IORequestGenerator::GetNextFileOffset(*p, iTarget, li.QuadPart);
+    if (p->vLookahead.size() != 0)
+    {
+        IOLookahead& lookahead = p->vLookahead[iTarget];
+        if (lookahead.IsEmpty())
+        {
+            fillLookahead(p, iTarget);
+        }
+
+        const IOLookahead::Decision& decision = lookahead.Next();
+        if (lookahead.GetUseOffsets())
+        {
+            li.QuadPart = decision.ullOffset;
+        }
+        else if (pAppendLog == nullptr)
+        {
+            li.QuadPart = IORequestGenerator::GetNextFileOffset(*p, iTarget, li.QuadPart);
+        }
+        readOrWrite = decision.ioType;
+        cbTransfer = decision.dwTransferSize;
+    }
+    else
+    {
+        if (pAppendLog == nullptr)
+        {
+            li.QuadPart = IORequestGenerator::GetNextFileOffset(*p, iTarget, li.QuadPart);
+        }
+        readOrWrite = DecideIo(p->pRand, pTarget->GetWriteRatio(), pTarget->GetTrimRatio(), pTarget->GetWriteZeroesRatio());
+        cbTransfer = pTarget->GetNextBlockSizeInBytes(readOrWrite, p->pRand);
+    }
+
+    // a group commit writes whichever records its committers have queued, all in one I/O
+    if (p->vGroupCommits.size() != 0 && p->vGroupCommits[iTarget].IsEnabled())
+    {
+        cbTransfer = p->vGroupCommits[iTarget].TakeGroup(iRequest, PerfTimer::GetTime());
+    }
+
+    // appended writes take the next range at the tail of the log, in whichever segment it is
+    if (pAppendLog != nullptr)
+    {
+        UINT32 ulSegment;
+        UINT64 ullOffset;
+        if (!pAppendLog->Append(cbTransfer, &ulSegment, &ullOffset))
+        {
+            PrintError("thread %u: error appending to target '%s' (error code: %u)\n", p->ulThreadNo, pTarget->GetPath().c_str(), GetLastError());
+            return false;
+        }
+
+        if (!getAppendSegment(p, pIoEngine, iTarget, ulSegment, &hFile))
+        {
+            return false;
+        }
+        li.QuadPart = ullOffset;
+        pIORequest->SetSegment(ulSegment);
+    }
     
     pOverlapped->Offset = li.LowPart;
     pOverlapped->OffsetHigh = li.HighPart;
     
-    IOOperation readOrWrite = DecideIo(p->pRand, pTarget->GetWriteRatio());
     pIORequest->SetIoType(readOrWrite);
+    pIORequest->SetTransferSize(cbTransfer);
+    pIORequest->SetDurable(readOrWrite == IOOperation::WriteIO && DecideDurable(p->pRand, pTarget->GetDurableWriteRatio()));
     
     if (TraceLoggingProviderEnabled(g_hEtwProvider,
                                     TRACE_LEVEL_VERBOSE,
@@ -770,9 +1258,9 @@ static bool issueNextIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBy
                                   TraceLoggingOpcode(EVENT_TRACE_TYPE_START),
                                   TraceLoggingLevel(TRACE_LEVEL_VERBOSE),
                                   TraceLoggingUInt32(p->ulThreadNo, "Thread"),
-                                  TraceLoggingString(readOrWrite == IOOperation::ReadIO ? "Read" : "Write", "IO Type"),
+                                  TraceLoggingString(ioTypeName(readOrWrite), "IO Type"),
                                   TraceLoggingUInt64(iTarget, "Target"),
-                                  TraceLoggingInt32(pTarget->GetBlockSizeInBytes(), "Block Size"),
+                                  TraceLoggingInt32(cbTransfer, "Block Size"),
                                   TraceLoggingInt64(li.QuadPart, "Offset"));
     }
 
@@ -781,30 +1269,29 @@ static bool issueNextIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBy
         pIORequest->SetStartTime(PerfTimer::GetTime());
     }
     
-    if (readOrWrite == IOOperation::ReadIO)
+    if (readOrWrite == IOOperation::TrimIO || readOrWrite == IOOperation::WriteZeroesIO)
+    {
+        // no data moves; the engine only hands the range to the target
+        fOk = pIoEngine->Submit(pIORequest, hFile, nullptr, cbTransfer, pfCompleted, pdwBytesTransferred);
+    }
+    else if (readOrWrite == IOOperation::ReadIO)
     {
         if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
         {
             if (pTarget->GetWriteThroughMode() == WriteThroughMode::On )
             {
-                g_pfnRtlCopyMemoryNonTemporal(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes());
+                g_pfnRtlCopyMemoryNonTemporal(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, cbTransfer);
             }
             else
             {
-                memcpy(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes());
+                memcpy(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, cbTransfer);
             }
-            *pdwBytesTransferred = pTarget->GetBlockSizeInBytes();
+            *pdwBytesTransferred = cbTransfer;
+            *pfCompleted = true;
         }
         else
         {
-            if (useCompletionRoutines)
-            {
-                rslt = ReadFileEx(p->vhTargets[iTarget], p->GetReadBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pOverlapped, fileIOCompletionRoutine);
-            }
-            else
-            {
-                rslt = ReadFile(p->vhTargets[iTarget], p->GetReadBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pdwBytesTransferred, pOverlapped);
-            }
+            fOk = pIoEngine->Submit(pIORequest, hFile, p->GetReadBuffer(iTarget, iRequest), cbTransfer, pfCompleted, pdwBytesTransferred);
         }
     }
     else
@@ -813,46 +1300,44 @@ static bool issueNextIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBy
         {
             if (pTarget->GetWriteThroughMode() == WriteThroughMode::On)
             {
-                g_pfnRtlCopyMemoryNonTemporal(pTarget->GetMappedView() + li.QuadPart, p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes());
+                g_pfnRtlCopyMemoryNonTemporal(pTarget->GetMappedView() + li.QuadPart, p->GetWriteBuffer(iTarget, iRequest, cbTransfer), cbTransfer);
             }
             else
             {
-                memcpy(pTarget->GetMappedView() + li.QuadPart, p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes());
+                memcpy(pTarget->GetMappedView() + li.QuadPart, p->GetWriteBuffer(iTarget, iRequest, cbTransfer), cbTransfer);
 
                 switch (pTarget->GetMemoryMappedIoFlushMode())
                 {
                     case MemoryMappedIoFlushMode::ViewOfFile:
-                        FlushViewOfFile(pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes());
+                        FlushViewOfFile(pTarget->GetMappedView() + li.QuadPart, cbTransfer);
                         break;
                     case MemoryMappedIoFlushMode::NonVolatileMemory:
-                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes(), 0);
+                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, cbTransfer, 0);
                         break;
                     case MemoryMappedIoFlushMode::NonVolatileMemoryNoDrain:
-                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes(), FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN);
+                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, cbTransfer, FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN);
                         break;
                 }
             }
-            *pdwBytesTransferred = pTarget->GetBlockSizeInBytes();
+            *pdwBytesTransferred = cbTransfer;
+            *pfCompleted = true;
         }
         else
         {
-            if (useCompletionRoutines)
+            if (pIORequest->GetDurable())
             {
-                rslt = WriteFileEx(p->vhTargets[iTarget], p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pOverlapped, fileIOCompletionRoutine);
-            }
-            else
-            {
-                rslt = WriteFile(p->vhTargets[iTarget], p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pdwBytesTransferred, pOverlapped);
+                hFile = p->vhDurableTargets[iTarget];
             }
+            fOk = pIoEngine->Submit(pIORequest, hFile, p->GetWriteBuffer(iTarget, iRequest, cbTransfer), cbTransfer, pfCompleted, pdwBytesTransferred);
         }
     }
 
     if (p->vThroughputMeters.size() != 0 && p->vThroughputMeters[iTarget].IsRunning())
     {
-        p->vThroughputMeters[iTarget].Adjust(pTarget->GetBlockSizeInBytes());
+        p->vThroughputMeters[iTarget].Adjust(cbTransfer);
     }
 
-    return (rslt) ? true : false;
+    return fOk;
 }
 
 static void completeIO(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytesTransferred)
@@ -875,19 +1360,27 @@ static void completeIO(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytes
                                   TraceLoggingLevel(TRACE_LEVEL_VERBOSE));
     }
 
+    // a trim or write-zeroes returns no data; if it succeeded, it covered its whole range
+    if (pIORequest->GetIoType() == IOOperation::TrimIO || pIORequest->GetIoType() == IOOperation::WriteZeroesIO)
+    {
+        dwBytesTransferred = pIORequest->GetTransferSize();
+    }
+
     //check if I/O transferred all of the requested bytes
-    if (dwBytesTransferred != pTarget->GetBlockSizeInBytes())
+    if (dwBytesTransferred != pIORequest->GetTransferSize())
     {
         PrintError("Warning: thread %u transferred %u bytes instead of %u bytes\n",
             p->ulThreadNo,
             dwBytesTransferred,
-            pTarget->GetBlockSizeInBytes());
+            pIORequest->GetTransferSize());
     }
 
     if (*p->pfAccountingOn)
     {
         p->pResults->vTargetResults[iTarget].Add(dwBytesTransferred,
+            pIORequest->GetTransferSize(),
             pIORequest->GetIoType(),
+            pIORequest->GetDurable(),
             pIORequest->GetStartTime(),
             *(p->pullStartTime),
             p->pTimeSpan->GetMeasureLatency(),
@@ -907,77 +1400,433 @@ static void completeIO(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytes
 
 /*****************************************************************************/
 // function called from worker thread
-// performs synch I/O
+// reaps a batch of completions, waiting for them per the timespan's wait strategy
 //
-static bool doWorkUsingSynchronousIO(ThreadParameters *p)
+static bool reapCompletions(IoEngine *pIoEngine, WaitStrategy waitStrategy, UINT64 ullSpinBudget,
+                            IoEngineCompletion *pCompletions, DWORD cMaxCompletions, DWORD *pcCompletions)
 {
-    bool fOk = true;
-    BOOL rslt = FALSE;
-    DWORD dwBytesTransferred;
-    size_t cIORequests = p->vIORequest.size();
+    if (waitStrategy == WaitStrategy::Poll)
+    {
+        return pIoEngine->ReapBatch(pCompletions, cMaxCompletions, pcCompletions, 0);
+    }
 
-    while(g_bRun && !g_bThreadError)
+    if (waitStrategy == WaitStrategy::SpinThenBlock)
     {
-        DWORD dwMinSleepTime = ~((DWORD)0);
-        for (size_t i = 0; i < cIORequests; i++)
+        UINT64 ullSpinUntil = PerfTimer::GetTime() + ullSpinBudget;
+        do
         {
-            IORequest *pIORequest = &p->vIORequest[i];
-            Target *pTarget = pIORequest->GetNextTarget();
-
-            if (p->vThroughputMeters.size() != 0)
+            if (!pIoEngine->ReapBatch(pCompletions, cMaxCompletions, pcCompletions, 0))
             {
-                size_t iTarget = pTarget - &p->vTargets[0];
-                ThroughputMeter *pThroughputMeter = &p->vThroughputMeters[iTarget];
+                return false;
+            }
+            if (*pcCompletions > 0)
+            {
+                return true;
+            }
+            YieldProcessor();
+        } while (PerfTimer::GetTime() < ullSpinUntil);
+    }
 
-                DWORD dwSleepTime = pThroughputMeter->GetSleepTime();
-                dwMinSleepTime = std::min(dwMinSleepTime, dwSleepTime);
-                if (pThroughputMeter->IsRunning() && dwSleepTime > 0)
-                {
-                    continue;
-                }
+    // block, with a timeout so that the end of the run is noticed
+    return pIoEngine->ReapBatch(pCompletions, cMaxCompletions, pcCompletions, 1);
+}
+
+/*****************************************************************************/
+// state shared between a worker thread and the thread(s) reaping its completions: either
+// its own completion reaper (-H) or the shared completion pool (-Hp)
+//
+struct CompletionHandoff
+{
+    ThreadParameters *p;
+    IoEngine *pIoEngine;                    // reaped by the completion reaper
+    WaitStrategy waitStrategy;
+    UINT64 ullSpinBudget;
+
+    OverlappedRing returnRing;              // completed requests handed back to the worker
+    HANDLE hReturnEvent;                    // set when the worker may be waiting on an empty ring
+    volatile LONG lWorkerWaiting;
+    volatile bool fStop;
+
+    SRWLOCK srwLock;                        // serializes the pool threads completing the worker's I/O
+};
+
+/*****************************************************************************/
+// function called from the completion reaper and the completion pool
+// wakes the worker if it is waiting for requests to be returned
+//
+static void signalReturnedRequests(CompletionHandoff *pHandoff)
+{
+    // the exchange orders the ring update before the check; see waitForReturnedRequests
+    if (InterlockedExchange(&pHandoff->lWorkerWaiting, 0) != 0)
+    {
+        SetEvent(pHandoff->hReturnEvent);
+    }
+}
+
+/*****************************************************************************/
+// completion reaper thread function
+// completes and accounts for the worker's I/O, and returns each request to the worker
+//
+static DWORD WINAPI reaperThreadFunc(LPVOID cookie)
+{
+    CompletionHandoff *pHandoff = reinterpret_cast<CompletionHandoff *>(cookie);
+    ThreadParameters *p = pHandoff->p;
+    ThreadResults *pResults = p->pResults;
+    CpuTimeMeter cpuTimeMeter;
+    DWORD cBatchSize = p->pTimeSpan->GetBatchSize();
+    vector<IoEngineCompletion> vCompletions(cBatchSize);
+
+    // the reaper follows the worker threads in the timespan's affinity model
+    if (!p->pTimeSpan->GetDisableAffinity())
+    {
+        GROUP_AFFINITY GroupAffinity = {};
+        GroupAffinity.Group = p->wHelperGroupNum;
+        GroupAffinity.Mask = (KAFFINITY)1 << p->bHelperProcNum;
+        SetThreadGroupAffinity(GetCurrentThread(), &GroupAffinity, nullptr);
+    }
+
+    // charge the reaper's CPU time to the measured interval only
+    cpuTimeMeter.Start(p->pfAccountingOn, &pResults->ullHelperKernelTime, &pResults->ullHelperUserTime);
+
+    while (!pHandoff->fStop && !g_bThreadError)
+    {
+        cpuTimeMeter.Update();
+
+        DWORD cCompletions;
+        if (!reapCompletions(pHandoff->pIoEngine, pHandoff->waitStrategy, pHandoff->ullSpinBudget, &vCompletions[0], cBatchSize, &cCompletions))
+        {
+            PrintError("error during overlapped IO operation (error code: %u)\n", GetLastError());
+            g_bThreadError = TRUE;
+            break;
+        }
+
+        if (cCompletions == 0)
+        {
+            continue;
+        }
+
+        for (DWORD iCompletion = 0; iCompletion < cCompletions; iCompletion++)
+        {
+            IORequest *pIORequest = vCompletions[iCompletion].pIORequest;
+
+            completeIO(p, pIORequest, vCompletions[iCompletion].dwBytesTransferred);
+
+            // the ring holds every request of the thread, so it can never be full
+            pHandoff->returnRing.Add(pIORequest->GetOverlapped());
+        }
+
+        if (*p->pfAccountingOn)
+        {
+            pResults->ullReapCalls++;
+            pResults->ullReapedIOs += cCompletions;
+        }
+
+        signalReturnedRequests(pHandoff);
+    }
+
+    cpuTimeMeter.Stop();
+    return 0;
+}
+
+/*****************************************************************************/
+// function called from worker thread
+// waits per the timespan's wait strategy until at least one request has been returned to it,
+// or a timeout passes so that the end of the run is noticed
+//
+static void waitForReturnedRequests(CompletionHandoff *pHandoff)
+{
+    if (!pHandoff->returnRing.IsEmpty())
+    {
+        return;
+    }
+
+    if (pHandoff->waitStrategy == WaitStrategy::Poll)
+    {
+        YieldProcessor();
+        return;
+    }
+
+    if (pHandoff->waitStrategy == WaitStrategy::SpinThenBlock)
+    {
+        UINT64 ullSpinUntil = PerfTimer::GetTime() + pHandoff->ullSpinBudget;
+        do
+        {
+            YieldProcessor();
+            if (!pHandoff->returnRing.IsEmpty())
+            {
+                return;
             }
+        } while (PerfTimer::GetTime() < ullSpinUntil);
+    }
+
+    // announce the wait before the final check, so that a request returned in between
+    // is either seen here or signalled by whoever returned it
+    InterlockedExchange(&pHandoff->lWorkerWaiting, 1);
+    if (pHandoff->returnRing.IsEmpty())
+    {
+        WaitForSingleObject(pHandoff->hReturnEvent, 1);
+    }
+    InterlockedExchange(&pHandoff->lWorkerWaiting, 0);
+}
+
+/*****************************************************************************/
+// completion pool (-Hp): threads draining the I/O completion port shared by all worker threads of
+// the timespan. The completion key of each handle is the handoff of the worker which opened it, so
+// every completion is accounted to the worker which issued the I/O and returned to it.
+//
+class CompletionPool
+{
+public:
+    CompletionPool() :
+        _hCompletionPort(nullptr),
+        _pTimeSpan(nullptr),
+        _pfAccountingOn(nullptr),
+        _fStop(false)
+    {
+    }
 
-            rslt = issueNextIO(p, pIORequest, &dwBytesTransferred, false);
+    ~CompletionPool() { Stop(); }
 
-            if (!rslt)
+    bool Start(const TimeSpan& timeSpan, const vector<AffinityAssignment>& vAffinity, vector<ThreadResults>& vResults, volatile bool *pfAccountingOn);
+    void Stop();
+
+    HANDLE GetCompletionPort() const { return _hCompletionPort; }
+
+private:
+    struct PoolThread
+    {
+        CompletionPool *pPool;
+        ThreadResults *pResults;
+        WORD wGroupNum;
+        BYTE bProcNum;
+        HANDLE hThread;
+    };
+
+    static DWORD WINAPI _ThreadFunc(LPVOID cookie);
+    void _Drain(PoolThread *pThread);
+    bool _Reap(WaitStrategy waitStrategy, UINT64 ullSpinBudget, OVERLAPPED_ENTRY *pEntries, ULONG cMaxEntries, ULONG *pcEntries);
+    bool _Dequeue(OVERLAPPED_ENTRY *pEntries, ULONG cMaxEntries, ULONG *pcEntries, DWORD dwMilliseconds);
+
+    HANDLE _hCompletionPort;
+    const TimeSpan *_pTimeSpan;
+    volatile bool *_pfAccountingOn;
+    volatile bool _fStop;
+    vector<PoolThread> _vThreads;
+};
+
+bool CompletionPool::Start(const TimeSpan& timeSpan, const vector<AffinityAssignment>& vAffinity, vector<ThreadResults>& vResults, volatile bool *pfAccountingOn)
+{
+    DWORD cThreads = timeSpan.GetCompletionPoolThreadCount();
+
+    _pTimeSpan = &timeSpan;
+    _pfAccountingOn = pfAccountingOn;
+    _fStop = false;
+
+    // the system lets as many threads run against the port as there are in the pool
+    _hCompletionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, cThreads);
+    if (nullptr == _hCompletionPort)
+    {
+        return false;
+    }
+
+    vResults.clear();
+    vResults.resize(cThreads);
+    _vThreads.resize(cThreads);
+    for (DWORD iThread = 0; iThread < cThreads; iThread++)
+    {
+        PoolThread *pThread = &_vThreads[iThread];
+
+        pThread->pPool = this;
+        pThread->pResults = &vResults[iThread];
+        pThread->wGroupNum = vAffinity[iThread].wGroup;
+        pThread->bProcNum = vAffinity[iThread].bProc;
+        pThread->hThread = CreateThread(NULL, 64 * 1024, _ThreadFunc, pThread, 0, NULL);
+        if (nullptr == pThread->hThread)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CompletionPool::Stop()
+{
+    _fStop = true;
+    for (auto& thread : _vThreads)
+    {
+        if (nullptr != thread.hThread)
+        {
+            WaitForSingleObject(thread.hThread, INFINITE);
+            CloseHandle(thread.hThread);
+            thread.hThread = nullptr;
+        }
+    }
+
+    if (nullptr != _hCompletionPort)
+    {
+        CloseHandle(_hCompletionPort);
+        _hCompletionPort = nullptr;
+    }
+}
+
+DWORD WINAPI CompletionPool::_ThreadFunc(LPVOID cookie)
+{
+    PoolThread *pThread = reinterpret_cast<PoolThread *>(cookie);
+    pThread->pPool->_Drain(pThread);
+    return 0;
+}
+
+void CompletionPool::_Drain(PoolThread *pThread)
+{
+    ThreadResults *pResults = pThread->pResults;
+    CpuTimeMeter cpuTimeMeter;
+    WaitStrategy waitStrategy = _pTimeSpan->GetWaitStrategy();
+    UINT64 ullSpinBudget = PerfTimer::MicrosecondsToPerfTime(_pTimeSpan->GetSpinBudgetInMicroseconds());
+    vector<OVERLAPPED_ENTRY> vEntries(_pTimeSpan->GetBatchSize());
+
+    // pool threads follow the worker threads in the timespan's affinity model
+    if (!_pTimeSpan->GetDisableAffinity())
+    {
+        GROUP_AFFINITY GroupAffinity = {};
+        GroupAffinity.Group = pThread->wGroupNum;
+        GroupAffinity.Mask = (KAFFINITY)1 << pThread->bProcNum;
+        SetThreadGroupAffinity(GetCurrentThread(), &GroupAffinity, nullptr);
+    }
+
+    // charge the pool thread's CPU time to the measured interval only
+    cpuTimeMeter.Start(_pfAccountingOn, &pResults->ullKernelTime, &pResults->ullUserTime);
+
+    // keep draining after an error: the workers wait for all of their in-flight requests
+    // before they exit, and only the pool can return them
+    bool fReapError = false;
+    while (!_fStop)
+    {
+        cpuTimeMeter.Update();
+
+        ULONG cEntries;
+        if (!_Reap(waitStrategy, ullSpinBudget, &vEntries[0], (ULONG)vEntries.size(), &cEntries))
+        {
+            if (!fReapError)
             {
-                PrintError("t[%u] error during %s error code: %u)\n", (UINT32)i, (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"), GetLastError());
-                fOk = false;
-                goto cleanup;
+                PrintError("error dequeuing from the shared completion port (error code: %u)\n", GetLastError());
+                fReapError = true;
+            }
+            g_bThreadError = TRUE;
+            continue;
+        }
+
+        for (ULONG iEntry = 0; iEntry < cEntries; iEntry++)
+        {
+            CompletionHandoff *pHandoff = reinterpret_cast<CompletionHandoff *>(vEntries[iEntry].lpCompletionKey);
+            ThreadParameters *p = pHandoff->p;
+            OVERLAPPED *pOverlapped = vEntries[iEntry].lpOverlapped;
+            IORequest *pIORequest = IORequest::OverlappedToIORequest(pOverlapped);
+            size_t iTarget = pIORequest->GetCurrentTarget() - &p->vTargets[0];
+            DWORD dwBytesTransferred;
+
+            // other pool threads may be completing I/O of the same worker at the same time
+            AcquireSRWLockExclusive(&pHandoff->srwLock);
+
+            // the I/O is done, so this does not wait; it only translates the status of the entry
+            if (GetOverlappedResult(p->vhTargets[iTarget], pOverlapped, &dwBytesTransferred, FALSE))
+            {
+                completeIO(p, pIORequest, dwBytesTransferred);
             }
+            else
+            {
+                PrintError("thread %u: error during overlapped IO operation (error code: %u)\n", p->ulThreadNo, GetLastError());
+                g_bThreadError = TRUE;
+            }
+
+            // the request goes back even on error, since the worker waits for all of them before it exits
+            pHandoff->returnRing.Add(pOverlapped);
+            ReleaseSRWLockExclusive(&pHandoff->srwLock);
 
-            completeIO(p, pIORequest, dwBytesTransferred);
+            signalReturnedRequests(pHandoff);
         }
 
-        // if no IOs were issued, wait for the next scheduling time
-        if (dwMinSleepTime != ~((DWORD)0) && dwMinSleepTime != 0)
+        if (cEntries > 0 && *_pfAccountingOn)
         {
-            Sleep(dwMinSleepTime);
+            pResults->ullReapCalls++;
+            pResults->ullReapedIOs += cEntries;
         }
+    }
 
-        assert(!g_bError);  // at this point we shouldn't be seeing initialization error
+    cpuTimeMeter.Stop();
+}
+
+bool CompletionPool::_Reap(WaitStrategy waitStrategy, UINT64 ullSpinBudget, OVERLAPPED_ENTRY *pEntries, ULONG cMaxEntries, ULONG *pcEntries)
+{
+    if (waitStrategy == WaitStrategy::Poll)
+    {
+        return _Dequeue(pEntries, cMaxEntries, pcEntries, 0);
     }
 
-cleanup:
-    return fOk;
+    if (waitStrategy == WaitStrategy::SpinThenBlock)
+    {
+        UINT64 ullSpinUntil = PerfTimer::GetTime() + ullSpinBudget;
+        do
+        {
+            if (!_Dequeue(pEntries, cMaxEntries, pcEntries, 0))
+            {
+                return false;
+            }
+            if (*pcEntries > 0)
+            {
+                return true;
+            }
+            YieldProcessor();
+        } while (PerfTimer::GetTime() < ullSpinUntil);
+    }
+
+    // block, with a timeout so that the end of the run is noticed
+    return _Dequeue(pEntries, cMaxEntries, pcEntries, 1);
+}
+
+bool CompletionPool::_Dequeue(OVERLAPPED_ENTRY *pEntries, ULONG cMaxEntries, ULONG *pcEntries, DWORD dwMilliseconds)
+{
+    *pcEntries = 0;
+    if (!GetQueuedCompletionStatusEx(_hCompletionPort, pEntries, cMaxEntries, pcEntries, dwMilliseconds, FALSE))
+    {
+        *pcEntries = 0;
+        return (GetLastError() == WAIT_TIMEOUT) ? true : false;
+    }
+
+    return true;
 }
 
 /*****************************************************************************/
 // function called from worker thread
-// performs asynch I/O using IO Completion Ports
+// issues and completes I/O through the thread's I/O engine
 //
-static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletionPort)
+static bool doWorkUsingIoEngine(ThreadParameters *p, IoEngine *pIoEngine, CompletionHandoff *pHandoff)
 {
-    assert(nullptr!= p);
-    assert(nullptr != hCompletionPort);
+    assert(nullptr != p);
+    assert(nullptr != pIoEngine);
 
     bool fOk = true;
-    BOOL rslt = FALSE;
-    OVERLAPPED * pCompletedOvrp;
-    ULONG_PTR ulCompletionKey;
+    bool fCompleted;
     DWORD dwBytesTransferred;
     OverlappedQueue overlappedQueue;
+    CpuTimeMeter cpuTimeMeter;
     size_t cIORequests = p->vIORequest.size();
+    ThreadResults *pResults = p->pResults;
+
+    // polled completions are only ever checked for, never waited on
+    WaitStrategy waitStrategy = p->pTimeSpan->GetPollCompletions() ? WaitStrategy::Poll : p->pTimeSpan->GetWaitStrategy();
+    UINT64 ullSpinBudget = PerfTimer::MicrosecondsToPerfTime(p->pTimeSpan->GetSpinBudgetInMicroseconds());
+
+    // up to this many completions are reaped per call
+    DWORD cBatchSize = p->pTimeSpan->GetBatchSize();
+    vector<IoEngineCompletion> vCompletions(cBatchSize);
+
+    // with a separate reaper or the completion pool, this thread only submits; completions
+    // come back through the handoff's ring
+    HANDLE hReaperThread = nullptr;
+
+    // charge the thread's own CPU time to the measured interval only
+    cpuTimeMeter.Start(p->pfAccountingOn, &p->pResults->ullKernelTime, &p->pResults->ullUserTime);
 
     //start IO operations
     for (size_t i = 0; i < cIORequests; i++)
@@ -985,11 +1834,27 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
         overlappedQueue.Add(p->vIORequest[i].GetOverlapped());
     }
 
+    if (p->pTimeSpan->GetSeparateReaper())
+    {
+        pHandoff->pIoEngine = pIoEngine;
+
+        hReaperThread = CreateThread(NULL, 64 * 1024, reaperThreadFunc, pHandoff, 0, NULL);
+        if (nullptr == hReaperThread)
+        {
+            PrintError("unable to create completion reaper thread (error code: %u)\n", GetLastError());
+            fOk = false;
+            goto cleanup;
+        }
+    }
+
     //
     // perform work
     //
     while(g_bRun && !g_bThreadError)
     {
+        cpuTimeMeter.Update();
+
+        DWORD cSubmitted = 0;
         DWORD dwMinSleepTime = ~((DWORD)0);
         for (size_t i = 0; i < overlappedQueue.GetCount(); i++)
         {
@@ -1011,141 +1876,182 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
                 }
             }
 
-            rslt = issueNextIO(p, pIORequest, &dwBytesTransferred, false);
+            // a group commit has nothing to write until one of its committers has queued a record
+            if (p->vGroupCommits.size() != 0)
+            {
+                size_t iTarget = pTarget - &p->vTargets[0];
+                GroupCommit *pGroupCommit = &p->vGroupCommits[iTarget];
 
-            if (!rslt && GetLastError() != ERROR_IO_PENDING)
+                UINT64 ullWaitTime = pGroupCommit->IsEnabled() ? pGroupCommit->GetWaitTime(PerfTimer::GetTime()) : 0;
+                if (ullWaitTime > 0)
+                {
+                    // if all committers are in groups in flight, a completion is what is waited for
+                    if (ullWaitTime != MAXUINT64)
+                    {
+                        // the sleep below has millisecond resolution; rather than spin out a shorter think time
+                        // with Sleep(0), a thread which does not poll sleeps for at least a millisecond
+                        double lfSleepTime = PerfTimer::PerfTimeToMilliseconds(ullWaitTime);
+                        DWORD dwSleepTime = static_cast<DWORD>((waitStrategy == WaitStrategy::Poll) ? lfSleepTime : ceil(lfSleepTime));
+                        dwMinSleepTime = std::min(dwMinSleepTime, dwSleepTime);
+                    }
+                    overlappedQueue.Add(pReadyOverlapped);
+                    continue;
+                }
+            }
+
+            if (!issueNextIO(p, pIoEngine, pIORequest, &fCompleted, &dwBytesTransferred))
             {
                 UINT32 iIORequest = (UINT32)(pIORequest - &p->vIORequest[0]);
-                PrintError("t[%u] error during %s error code: %u)\n", iIORequest, (pIORequest->GetIoType()== IOOperation::ReadIO ? "read" : "write"), GetLastError());
+                PrintError("t[%u] error during %s error code: %u)\n", iIORequest, ioTypeName(pIORequest->GetIoType()), GetLastError());
+
+                // it never went out, so it is not waited for on the way out
+                overlappedQueue.Add(pReadyOverlapped);
                 fOk = false;
                 goto cleanup;
             }
 
-            if (rslt && pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+            // synchronous and memory mapped IO complete inline
+            if (fCompleted)
             {
                 completeIO(p, pIORequest, dwBytesTransferred);
                 overlappedQueue.Add(pReadyOverlapped);
+
+                if (!commitGroup(p, pIORequest))
+                {
+                    fOk = false;
+                    goto cleanup;
+                }
+            }
+            else
+            {
+                cSubmitted++;
+            }
+        }
+
+        // hand everything submitted above to the system, if the engine held it back
+        if (cSubmitted > 0)
+        {
+            DWORD cFlushed;
+
+            if (!pIoEngine->Flush(&cFlushed))
+            {
+                PrintError("error submitting IO operations (error code: %u)\n", GetLastError());
+                fOk = false;
+                goto cleanup;
+            }
+
+            // an engine which did not hold requests back issued each one in its own call
+            if (*p->pfAccountingOn)
+            {
+                pResults->ullSubmitCalls += (cFlushed > 0) ? (1 + cSubmitted - cFlushed) : cSubmitted;
+                pResults->ullSubmittedIOs += cSubmitted;
             }
         }
 
         // if no IOs are in flight, wait for the next scheduling time
-        if ((overlappedQueue.GetCount() == p->vIORequest.size()) && dwMinSleepTime != ~((DWORD)0))
+        if ((overlappedQueue.GetCount() == cIORequests) && dwMinSleepTime != ~((DWORD)0))
         {
-            Sleep(dwMinSleepTime);
+            if (waitStrategy == WaitStrategy::Poll)
+            {
+                // don't give up the CPU; the meter only has millisecond resolution, so neither does this
+                ULONGLONG ullWakeTime = GetTickCount64() + dwMinSleepTime;
+                while (GetTickCount64() < ullWakeTime && g_bRun)
+                {
+                    YieldProcessor();
+                }
+            }
+            else
+            {
+                Sleep(dwMinSleepTime);
+            }
         }
 
-        // wait till one of the IO operations finishes
-        if (GetQueuedCompletionStatus(hCompletionPort, &dwBytesTransferred, &ulCompletionKey, &pCompletedOvrp, 1) != 0)
+        // take back whatever the reaper or pool has finished with, waiting if there is nothing yet
+        if (pHandoff != nullptr)
         {
-            //find which I/O operation it was (so we know to which buffer should we use)
-            IORequest *pIORequest = IORequest::OverlappedToIORequest(pCompletedOvrp);
-            completeIO(p, pIORequest, dwBytesTransferred);
-            overlappedQueue.Add(pCompletedOvrp);
+            if (overlappedQueue.GetCount() != cIORequests)
+            {
+                OVERLAPPED *pReturnedOverlapped;
+
+                waitForReturnedRequests(pHandoff);
+                while ((pReturnedOverlapped = pHandoff->returnRing.Remove()) != nullptr)
+                {
+                    overlappedQueue.Add(pReturnedOverlapped);
+                }
+            }
         }
-        else
+        // wait till one of the IO operations finishes, and take any others which are done
+        else if (overlappedQueue.GetCount() != cIORequests)
         {
-            DWORD err = GetLastError();
-            if (err != WAIT_TIMEOUT)
+            DWORD cCompletions;
+
+            if (!reapCompletions(pIoEngine, waitStrategy, ullSpinBudget, &vCompletions[0], cBatchSize, &cCompletions))
             {
-                PrintError("error during overlapped IO operation (error code: %u)\n", err);
+                PrintError("error during overlapped IO operation (error code: %u)\n", GetLastError());
                 fOk = false;
                 goto cleanup;
             }
-        }
-    } // end work loop
-
-cleanup:
-    return fOk;
-}
 
-/*****************************************************************************/
-// I/O completion routine. used by ReadFileEx and WriteFileEx
-//
+            for (DWORD iCompletion = 0; iCompletion < cCompletions; iCompletion++)
+            {
+                IORequest *pIORequest = vCompletions[iCompletion].pIORequest;
 
-VOID CALLBACK fileIOCompletionRoutine(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED pOverlapped)
-{
-    assert(NULL != pOverlapped);
+                completeIO(p, pIORequest, vCompletions[iCompletion].dwBytesTransferred);
+                overlappedQueue.Add(pIORequest->GetOverlapped());
 
-    BOOL rslt = FALSE;
+                if (!commitGroup(p, pIORequest))
+                {
+                    fOk = false;
+                    goto cleanup;
+                }
+            }
 
-    ThreadParameters *p = (ThreadParameters *)pOverlapped->hEvent;
+            if (cCompletions > 0 && *p->pfAccountingOn)
+            {
+                pResults->ullReapCalls++;
+                pResults->ullReapedIOs += cCompletions;
+            }
+        }
 
-    assert(NULL != p);
+        assert(!g_bError);  // at this point we shouldn't be seeing initialization error
+    } // end work loop
 
-    //check error code
-    if (0 != dwErrorCode)
+cleanup:
+    // the reaper must be gone before the engine it reaps from is closed
+    if (nullptr != hReaperThread)
     {
-        PrintError("Thread %u failed executing an I/O operation (error code: %u)\n", p->ulThreadNo, dwErrorCode);
-        goto cleanup;
+        pHandoff->fStop = true;
+        WaitForSingleObject(hReaperThread, INFINITE);
+        CloseHandle(hReaperThread);
     }
 
-    IORequest *pIORequest = IORequest::OverlappedToIORequest(pOverlapped);
-
-    completeIO(p, pIORequest, dwBytesTransferred);
-
-    // start a new IO operation
-    if (g_bRun && !g_bThreadError)
+    // the pool keys completions by the handoff, so it must be done with all of this thread's
+    // requests before the handoff goes away
+    if (p->hSharedCompletionPort != nullptr)
     {
-        Target *pTarget = pIORequest->GetNextTarget();
-        size_t iTarget = pTarget - &p->vTargets[0];
-
-        rslt = issueNextIO(p, pIORequest, NULL, true);
+        OVERLAPPED *pReturnedOverlapped;
 
-        if (!rslt)
+        // after an error, don't wait out the in-flight I/O; cancelled requests still come
+        // back through the pool
+        if (g_bThreadError)
         {
-            PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, iTarget, (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"), GetLastError());
-            goto cleanup;
+            for (auto hTarget : p->vhTargets)
+            {
+                CancelIoEx(hTarget, nullptr);
+            }
         }
-    }
-
-cleanup:
-    return;
-}
-
-/*****************************************************************************/
-// function called from worker thread
-// performs asynch I/O using IO Completion Routines (ReadFileEx, WriteFileEx)
-//
-static bool doWorkUsingCompletionRoutines(ThreadParameters *p)
-{
-    assert(NULL != p);
-    bool fOk = true;
-    BOOL rslt = FALSE;
-    
-    //start IO operations
-    UINT32 cIORequests = (UINT32)p->vIORequest.size();
-
-    for (size_t iIORequest = 0; iIORequest < cIORequests; iIORequest++) {
-        IORequest *pIORequest = &p->vIORequest[iIORequest];
-        Target *pTarget = pIORequest->GetNextTarget();
-        size_t iTarget = pTarget - &p->vTargets[0];
-
-        rslt = issueNextIO(p, pIORequest, NULL, true);
 
-        if (!rslt)
+        while (overlappedQueue.GetCount() != cIORequests)
         {
-            PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, iTarget, (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"), GetLastError());
-            fOk = false;
-            goto cleanup;
+            waitForReturnedRequests(pHandoff);
+            while ((pReturnedOverlapped = pHandoff->returnRing.Remove()) != nullptr)
+            {
+                overlappedQueue.Add(pReturnedOverlapped);
+            }
         }
     }
 
-    DWORD dwWaitResult = 0;
-    while( g_bRun && !g_bThreadError )
-    {
-        dwWaitResult = WaitForSingleObjectEx(p->hEndEvent, INFINITE, TRUE);
-
-        assert(WAIT_IO_COMPLETION == dwWaitResult || (WAIT_OBJECT_0 == dwWaitResult && (!g_bRun || g_bThreadError)));
-
-        //check WaitForSingleObjectEx status
-        if( WAIT_IO_COMPLETION != dwWaitResult && WAIT_OBJECT_0 != dwWaitResult )
-        {
-            PrintError("Error in thread %u during WaitForSingleObjectEx (in completion routines)\n", p->ulThreadNo);
-            fOk = false;
-            goto cleanup;
-        }
-    }
-cleanup:
+    cpuTimeMeter.Stop();
     return fOk;
 }
 
@@ -1193,6 +2099,151 @@ struct UniqueTarget {
     }
 };
 
+/*****************************************************************************/
+// Open a handle to a target, or reuse the one the thread has already opened with the same parameters.
+// Newly opened handles are added to the thread's unique handles, which it closes on the way out.
+//
+static bool openUniqueHandle(const Target& target, const char *pszName, const UniqueTarget& ut,
+                             vector<HANDLE>& vhUniqueHandles, map< UniqueTarget, UINT32 >& mHandleMap, HANDLE *phFile)
+{
+    auto it = mHandleMap.find(ut);
+    if (it != mHandleMap.end())
+    {
+        *phFile = vhUniqueHandles[it->second];
+        return true;
+    }
+
+    HANDLE hFile = CreateFile(pszName,
+        ut.dwDesiredAccess,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,        //security
+        OPEN_EXISTING,
+        ut.dwFlags,     //flags
+        nullptr);       //template file
+    if (INVALID_HANDLE_VALUE == hFile)
+    {
+        // TODO: error out
+        PrintError("Error opening file: %s [%u]\n", ut.path.c_str(), GetLastError());
+        return false;
+    }
+
+    // from here on the handle is closed with the others, whether or not it is set up
+    mHandleMap[ut] = (UINT32)vhUniqueHandles.size();
+    vhUniqueHandles.push_back(hFile);
+
+    if (!configureHandle(target, hFile, ut.path))
+    {
+        return false;
+    }
+
+    *phFile = hFile;
+    return true;
+}
+
+/*****************************************************************************/
+// Runs a metadata workload (-M) in place of data I/O. The thread builds its trees under the targets
+// before it waits for the signal to start, then performs one operation after another, taking the
+// targets in turn, and removes the trees on the way out.
+//
+static bool doMetadataWork(ThreadParameters *p)
+{
+    bool fOk = true;
+    CpuTimeMeter cpuTimeMeter;
+    size_t cTargets = p->vTargets.size();
+    size_t iTarget = 0;
+
+    p->pResults->vTargetResults.clear();
+    p->pResults->vTargetResults.resize(cTargets);
+    p->vMetadataTrees.clear();
+    p->vMetadataTrees.resize(cTargets);
+
+    for (size_t i = 0; i < cTargets; i++)
+    {
+        const Target& target = p->vTargets[i];
+        string sPath = target.GetPath();
+
+        // physical disks (#<n>) and volumes (<letter>:) have no directories to build trees in
+        if ((sPath.length() >= 1 && '#' == sPath[0]) || (sPath.length() == 2 && ':' == sPath[1]))
+        {
+            PrintError("Metadata workloads (-M) are only supported on directories\n");
+            fOk = false;
+            goto cleanup;
+        }
+
+        p->vMetadataTrees[i].Initialize(target, p->ulThreadNo);
+        if (!p->vMetadataTrees[i].Build())
+        {
+            PrintError("thread %u: error building directory tree '%s' (error code: %u)\n", p->ulThreadNo, p->vMetadataTrees[i].GetRoot().c_str(), GetLastError());
+            fOk = false;
+            goto cleanup;
+        }
+
+        printfv(p->pProfile->GetVerbose(), "thread %u starting: directory tree '%s' with %u files\n",
+            p->ulThreadNo,
+            p->vMetadataTrees[i].GetRoot().c_str(),
+            p->vMetadataTrees[i].GetFileCount());
+
+        // there is no file size; the tree is counted in files
+        p->pResults->vTargetResults[i].iTargetID = target.GetTargetID();
+        p->pResults->vTargetResults[i].sPath = sPath;
+        p->pResults->vTargetResults[i].ullFileSize = 0;
+    }
+
+    printfv(p->pProfile->GetVerbose(), "thread %u: waiting for a signal to start\n", p->ulThreadNo);
+    if (WAIT_FAILED == WaitForSingleObject(p->hStartEvent, INFINITE))
+    {
+        PrintError("Waiting for a signal to start failed (error code: %u)\n", GetLastError());
+        fOk = false;
+        goto cleanup;
+    }
+    printfv(p->pProfile->GetVerbose(), "thread %u: received signal to start\n", p->ulThreadNo);
+
+    if (g_bError)
+    {
+        fOk = false;
+        goto cleanup;
+    }
+
+    cpuTimeMeter.Start(p->pfAccountingOn, &p->pResults->ullKernelTime, &p->pResults->ullUserTime);
+
+    while (g_bRun && !g_bThreadError)
+    {
+        cpuTimeMeter.Update();
+
+        MetadataTree& tree = p->vMetadataTrees[iTarget];
+        UINT32 iSlot;
+        MetadataOperation op = tree.Next(p->pRand, &iSlot);
+
+        UINT64 ullStartTime = PerfTimer::GetTime();
+        if (!tree.Perform(op, iSlot))
+        {
+            PrintError("thread %u: error during %s in '%s' (error code: %u)\n", p->ulThreadNo, MetadataTree::GetOperationName(op), tree.GetRoot().c_str(), GetLastError());
+            fOk = false;
+            break;
+        }
+
+        if (*p->pfAccountingOn)
+        {
+            p->pResults->vTargetResults[iTarget].AddMetadataOperation(op, ullStartTime, p->pTimeSpan->GetMeasureLatency());
+        }
+
+        iTarget = (iTarget + 1) % cTargets;
+    }
+
+    cpuTimeMeter.Stop();
+
+cleanup:
+    for (auto& tree : p->vMetadataTrees)
+    {
+        if (!tree.Remove())
+        {
+            PrintError("Warning: thread %u could not remove all of directory tree '%s' (error code: %u)\n", p->ulThreadNo, tree.GetRoot().c_str(), GetLastError());
+        }
+    }
+
+    return fOk;
+}
+
 /*****************************************************************************/
 // worker thread function
 //
@@ -1202,7 +2253,9 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     bool fAnyMappedIo = false;
     bool fAllMappedIo = true;
     ThreadParameters *p = reinterpret_cast<ThreadParameters *>(cookie);
-    HANDLE hCompletionPort = nullptr;
+    IoEngine *pIoEngine = nullptr;
+    CompletionHandoff handoff = {};
+    CompletionHandoff *pHandoff = nullptr;
 
     //
     // A single file can be specified in multiple targets, so only open one
@@ -1253,6 +2306,14 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         }
     }
 
+    // a metadata workload has no handles to open and no requests to fill; either all of a time span's
+    // targets are metadata targets or none are
+    if (p->vTargets[0].GetUseMetadata())
+    {
+        fOk = doMetadataWork(p);
+        goto cleanup;
+    }
+
     UINT32 cIORequests = p->GetTotalRequestCount();
 
     // TODO: open files
@@ -1310,15 +2371,43 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         {
             fname = sPath.c_str();
         }
+        else if (pTarget->GetWriteZeroesRatio() != 0)
+        {
+            PrintError("Write-zeroes (-wz) is only supported on files\n");
+            fOk = false;
+            goto cleanup;
+        }
+        pTarget->SetDeviceTarget(fPhysical || fPartition);
+
+        if (pTarget->GetFlushDataOnly())
+        {
+            if (pTarget->GetDeviceTarget())
+            {
+                PrintError("Data-only flushes (-wfd) are only supported on files\n");
+                fOk = false;
+                goto cleanup;
+            }
+            if (nullptr == g_pfnNtFlushBuffersFileEx)
+            {
+                PrintError("ERROR: Windows runtime environment does not support data-only flushes (-wfd) for target '%s'.\n", pTarget->GetPath().c_str());
+                fOk = false;
+                goto cleanup;
+            }
+        }
 
         // get/set file flags
-        DWORD dwFlags = pTarget->GetCreateFlags(cIORequests > 1);
+        DWORD dwFlags = pTarget->GetCreateFlags(cIORequests > 1 ||
+                                                p->pTimeSpan->GetIoRing() ||
+                                                p->pTimeSpan->GetEventCompletions() ||
+                                                p->pTimeSpan->GetPollCompletions() ||
+                                                p->pTimeSpan->GetSeparateReaper() ||
+                                                p->hSharedCompletionPort != nullptr);
         DWORD dwDesiredAccess = 0;
-        if (pTarget->GetWriteRatio() == 0)
+        if (pTarget->GetModifyRatio() == 0)
         {
             dwDesiredAccess = GENERIC_READ;
         }
-        else if (pTarget->GetWriteRatio() == 100)
+        else if (pTarget->GetModifyRatio() == 100)
         {
             dwDesiredAccess = GENERIC_WRITE;
         }
@@ -1345,56 +2434,66 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         ut.dwDesiredAccess = dwDesiredAccess;
         ut.dwFlags = dwFlags;
 
-        if (mHandleMap.find(ut) == mHandleMap.end()) {
-            hFile = CreateFile(fname,
-                dwDesiredAccess,
-                FILE_SHARE_READ | FILE_SHARE_WRITE,
-                nullptr,        //security
-                OPEN_EXISTING,
-                dwFlags,        //flags
-                nullptr);       //template file
-            if (INVALID_HANDLE_VALUE == hFile)
+        if (!openUniqueHandle(*pTarget, fname, ut, vhUniqueHandles, mHandleMap, &hFile))
+        {
+            fOk = false;
+            goto cleanup;
+        }
+
+        p->vhTargets.push_back(hFile);
+
+        // an unbuffered group write is a whole number of records, so a record must be a whole number of the
+        // target's sectors; validation only knows of 512 byte sectors. Targets which can't say are not checked.
+        if (pTarget->GetUseGroupCommit() && pTarget->GetCacheMode() == TargetCacheMode::DisableOSCache)
+        {
+            FILE_STORAGE_INFO storageInfo = {};
+            if (GetFileInformationByHandleEx(hFile, FileStorageInfo, &storageInfo, sizeof(storageInfo)) &&
+                storageInfo.LogicalBytesPerSector != 0 &&
+                (pTarget->GetCommitRecordSizeInBytes() % storageInfo.LogicalBytesPerSector) != 0)
             {
-                // TODO: error out
-                PrintError("Error opening file: %s [%u]\n", sPath.c_str(), GetLastError());
+                PrintError("ERROR: with unbuffered IO (-Su or -Sh), commit record size (-wgr) must be a multiple of the sector size of target '%s'. Record size: %u sector size: %u\n",
+                    pTarget->GetPath().c_str(),
+                    pTarget->GetCommitRecordSizeInBytes(),
+                    storageInfo.LogicalBytesPerSector);
                 fOk = false;
                 goto cleanup;
             }
+        }
 
-            if (pTarget->GetCacheMode() == TargetCacheMode::DisableLocalCache)
-            {
-                DWORD Status = DisableLocalCache(hFile);
-                if (Status != ERROR_SUCCESS)
-                {
-                    PrintError("Failed to disable local caching (error %u). NOTE: only supported on remote filesystems with Windows 8 or newer.\n", Status);
-                    fOk = false;
-                    goto cleanup;
-                }
-            }
-
-            //set IO priority
-            if (pTarget->GetIOPriorityHint() != IoPriorityHintNormal)
+        // durable writes (-wd) go through a second handle opened for write through, unless the target
+        // is written through already
+        {
+            HANDLE hDurableFile = hFile;
+            if (pTarget->GetDurableWriteRatio() != 0 && !(dwFlags & FILE_FLAG_WRITE_THROUGH))
             {
-                _declspec(align(8)) FILE_IO_PRIORITY_HINT_INFO hintInfo;
-                hintInfo.PriorityHint = pTarget->GetIOPriorityHint();
-                if (!SetFileInformationByHandle(hFile, FileIoPriorityHintInfo, &hintInfo, sizeof(hintInfo)))
+                ut.dwFlags = dwFlags | FILE_FLAG_WRITE_THROUGH;
+                if (!openUniqueHandle(*pTarget, fname, ut, vhUniqueHandles, mHandleMap, &hDurableFile))
                 {
-                    PrintError("Error setting IO priority for file: %s [%u]\n", sPath.c_str(), GetLastError());
                     fOk = false;
                     goto cleanup;
                 }
-            }
-            
-            mHandleMap[ut] = (UINT32)vhUniqueHandles.size();
-            vhUniqueHandles.push_back(hFile);
-        }
-        else {
-            hFile = vhUniqueHandles[mHandleMap[ut]];
+            }
+
+            p->vhDurableTargets.push_back(hDurableFile);
         }
 
-        p->vhTargets.push_back(hFile);
+        // appended targets (-wa) start out in their first segment, which is the target itself
+        p->vvhAppendSegments.push_back(pTarget->GetUseAppend() ? vector<HANDLE>(1, hFile) : vector<HANDLE>());
+        p->vdwAppendSegmentFlags.push_back(dwFlags);
+        p->vulAppendFlushSegments.push_back(0);
+
+        // an appended target starts empty and grows during the run, so there is no size to check
+        if (pTarget->GetUseAppend())
+        {
+            p->vullFileSizes.push_back(0);
 
+            printfv(p->pProfile->GetVerbose(), "thread %u starting: file '%s' relative thread %u appending\n",
+                p->ulThreadNo,
+                pTarget->GetPath().c_str(),
+                p->ulRelativeThreadNo);
+        }
         // obtain file/disk/partition size
+        else
         {
             UINT64 fsize = 0;   //file size
 
@@ -1455,14 +2554,14 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             UINT64 startingFileOffset = pTarget->GetThreadBaseFileOffsetInBytes(p->ulRelativeThreadNo);
 
             // test whether the file is large enough for this thread to do work
-            if (startingFileOffset + pTarget->GetBlockSizeInBytes() >= p->vullFileSizes[iTarget])
+            if (startingFileOffset + pTarget->GetMaxBlockSizeInBytes() >= p->vullFileSizes[iTarget])
             {
                 PrintError("The file is too small. File: '%s' relative thread %u size: %I64u, base offset: %I64u block size: %u\n",
                     pTarget->GetPath().c_str(),
                     p->ulRelativeThreadNo,
                     fsize,
                     pTarget->GetBaseFileOffsetInBytes(),
-                    pTarget->GetBlockSizeInBytes());
+                    pTarget->GetMaxBlockSizeInBytes());
                 fOk = false;
                 goto cleanup;
             }
@@ -1548,17 +2647,141 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     
     p->vullPrivateSequentialOffsets.clear();
     p->vullPrivateSequentialOffsets.resize(p->vTargets.size());
+    p->vTargetGeometry.clear();
+    p->vTargetGeometry.resize(p->vTargets.size());
+    p->vLookahead.clear();
+    p->vpAccessPatternStates.clear();
+    p->vpAccessPatternStates.resize(p->vTargets.size());
+    // access pattern plugins are always asked for decisions in batches; without -k the other targets
+    // get batches of one, which consume the random number generator just as without lookahead
+    DWORD cLookahead = p->pTimeSpan->GetLookaheadDepth();
+    bool fAccessPatternPlugins = false;
+    for (const auto pPlugin : p->vpAccessPatternPlugins)
+    {
+        fAccessPatternPlugins = fAccessPatternPlugins || (pPlugin != nullptr);
+    }
+    if (cLookahead > 0 || fAccessPatternPlugins)
+    {
+        p->vLookahead.resize(p->vTargets.size());
+    }
+    p->vSequentialStreams.clear();
+    p->vSequentialStreams.resize(p->vTargets.size());
+    p->vOffsetDistributions.clear();
+    p->vOffsetDistributions.resize(p->vTargets.size());
+    p->vBlockPermutations.clear();
+    p->vBlockPermutations.resize(p->vTargets.size());
+    p->vulSequentialRunRemaining.clear();
+    p->vulSequentialRunRemaining.resize(p->vTargets.size());
     p->pResults->vTargetResults.clear();
     p->pResults->vTargetResults.resize(p->vTargets.size());
     for (size_t i = 0; i < p->vullFileSizes.size(); i++)
     {
+        const Target& target = p->vTargets[i];
+
+        // this thread's position among the threads sharing the target: with -F, all threads or
+        // those listed in the target's ThreadTargets
+        UINT32 ulTargetThread = p->ulRelativeThreadNo;
+        UINT32 cTargetThreads = target.GetThreadsPerFile();
+        if (p->pTimeSpan->GetThreadCount() > 0)
+        {
+            cTargetThreads = p->pTimeSpan->GetThreadCount();
+
+            const vector<ThreadTarget> vThreadTargets = target.GetThreadTargets();
+            if (vThreadTargets.size() > 0)
+            {
+                cTargetThreads = static_cast<UINT32>(vThreadTargets.size());
+                for (UINT32 iThreadTarget = 0; iThreadTarget < vThreadTargets.size(); iThreadTarget++)
+                {
+                    if (vThreadTargets[iThreadTarget].GetThread() == p->ulThreadNo)
+                    {
+                        ulTargetThread = iThreadTarget;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // same aligned interval of offsets that GetNextFileOffset draws uniform random offsets from;
+        // appended targets have no fixed extent, as their offsets come from the log
+        TargetGeometry& geometry = p->vTargetGeometry[i];
+        if (!target.GetUseAppend())
+        {
+            geometry.Initialize(target, p->vullFileSizes[i]);
+        }
+        UINT64 ullBlockCount = geometry.ullBlockCount;
+
+        if (target.GetUseRandomAccessPattern() && target.GetRandomDistribution() != DistributionType::Uniform)
+        {
+            p->vOffsetDistributions[i].Initialize(target, ullBlockCount);
+        }
+
+        if (!target.GetUseRandomAccessPattern() && target.GetUseSequentialStreams())
+        {
+            p->vSequentialStreams[i].Initialize(target, p->ulRelativeThreadNo * target.GetThreadStrideInBytes(), geometry.ullLastOffset);
+        }
+
+        if (target.GetUseRandomAccessPattern() && target.GetUseRandomPermutation())
+        {
+            // all threads sharing the target walk the same permutation (keyed by the timespan seed, not
+            // the per-thread one) from interleaved positions, so between them each block is hit once per pass
+            p->vBlockPermutations[i].Initialize(ullBlockCount, p->pTimeSpan->GetRandSeed(), ulTargetThread, cTargetThreads);
+        }
+
+        const AccessPatternPlugin *pPlugin = p->vpAccessPatternPlugins.empty() ? nullptr : p->vpAccessPatternPlugins[i];
+        if (pPlugin != nullptr)
+        {
+            string sPath = target.GetPath();
+            string sParameters = target.GetAccessPatternParameters();
+
+            DISKSPD_ACCESS_PATTERN_CONTEXT context = {};
+            context.Parameters = sParameters.c_str();
+            context.TargetPath = sPath.c_str();
+            context.ThreadNo = p->ulThreadNo;
+            context.RelativeThreadNo = ulTargetThread;
+            context.ThreadsPerTarget = cTargetThreads;
+            context.WriteRatio = target.GetWriteRatio();
+            context.Seed = p->ulRandSeed;
+            context.Geometry.FileSize = p->vullFileSizes[i];
+            context.Geometry.BaseFileOffset = geometry.ullBaseFileOffset;
+            context.Geometry.LastOffset = geometry.ullLastOffset;
+            context.Geometry.Alignment = geometry.ullAlignment;
+            context.Geometry.BlockCount = geometry.ullBlockCount;
+            context.Geometry.BlockSize = target.GetBlockSizeInBytes();
+            context.Geometry.MaxBlockSize = static_cast<UINT32>(geometry.ullMaxBlockSize);
+
+            p->vpAccessPatternStates[i] = pPlugin->CreateState(&context);
+            if (nullptr == p->vpAccessPatternStates[i])
+            {
+                PrintError("thread %u: access pattern plugin %s failed to initialize for target %s\n", p->ulThreadNo, target.GetAccessPatternPlugin().c_str(), sPath.c_str());
+                fOk = false;
+                goto cleanup;
+            }
+        }
+
+        if (p->vLookahead.size() != 0)
+        {
+            if (pPlugin != nullptr)
+            {
+                p->vLookahead[i].Initialize((cLookahead > 0) ? cLookahead : DEFAULT_ACCESS_PATTERN_BATCH, true);
+            }
+            else
+            {
+                bool fOffsets = target.GetUseRandomAccessPattern() && !p->vOffsetDistributions[i].GetUseDrift();
+                p->vLookahead[i].Initialize((cLookahead > 0) ? cLookahead : 1, fOffsets);
+            }
+        }
+
         p->pResults->vTargetResults[i].iTargetID = p->vTargets[i].GetTargetID();
         p->pResults->vTargetResults[i].sPath = p->vTargets[i].GetPath();
         p->pResults->vTargetResults[i].ullFileSize = p->vullFileSizes[i];
+        p->pResults->vTargetResults[i].SetBlockSizeClasses(p->vTargets[i].GetBlockSizeClasses());
         if(fCalculateIopsStdDev) 
         {
             p->pResults->vTargetResults[i].readBucketizer.Initialize(ioBucketDuration, expectedNumberOfBuckets);
             p->pResults->vTargetResults[i].writeBucketizer.Initialize(ioBucketDuration, expectedNumberOfBuckets);
+            p->pResults->vTargetResults[i].trimBucketizer.Initialize(ioBucketDuration, expectedNumberOfBuckets);
+            p->pResults->vTargetResults[i].writeZeroesBucketizer.Initialize(ioBucketDuration, expectedNumberOfBuckets);
+            p->pResults->vTargetResults[i].durableWriteBucketizer.Initialize(ioBucketDuration, expectedNumberOfBuckets);
         }
     }
 
@@ -1571,32 +2794,40 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     if (p->pTimeSpan->GetThreadCount() != 0 &&
         p->pTimeSpan->GetRequestCount() != 0)
     {
-        p->vIORequest.resize(cIORequests, IORequest(p->pRand));
-
-        for (UINT32 iIORequest = 0; iIORequest < cIORequests; iIORequest++)
+        // one weighted selector for the thread, shared by all of its requests
+        p->targetSelector = TargetSelector();
+        for (unsigned int iFile = 0; iFile < p->vTargets.size(); iFile++)
         {
-            p->vIORequest[iIORequest].SetRequestIndex(iIORequest);
+            Target *pTarget = &p->vTargets[iFile];
+            const vector<ThreadTarget> vThreadTargets = pTarget->GetThreadTargets();
+            UINT32 ulWeight = pTarget->GetWeight();
 
-            for (unsigned int iFile = 0; iFile < p->vTargets.size(); iFile++)
+            for (UINT32 iThreadTarget = 0; iThreadTarget < vThreadTargets.size(); iThreadTarget++)
             {
-                Target *pTarget = &p->vTargets[iFile];
-                const vector<ThreadTarget> vThreadTargets = pTarget->GetThreadTargets();
-                UINT32 ulWeight = pTarget->GetWeight();
-
-                for (UINT32 iThreadTarget = 0; iThreadTarget < vThreadTargets.size(); iThreadTarget++)
+                if (vThreadTargets[iThreadTarget].GetThread() == p->ulRelativeThreadNo)
                 {
-                    if (vThreadTargets[iThreadTarget].GetThread() == p->ulRelativeThreadNo)
+                    if (vThreadTargets[iThreadTarget].GetWeight() != 0)
                     {
-                        if (vThreadTargets[iThreadTarget].GetWeight() != 0)
-                        {
-                            ulWeight = vThreadTargets[iThreadTarget].GetWeight();
-                        }
-                        break;
+                        ulWeight = vThreadTargets[iThreadTarget].GetWeight();
                     }
+                    break;
                 }
-
-                p->vIORequest[iIORequest].AddTarget(pTarget, ulWeight);
             }
+
+            p->targetSelector.AddTarget(pTarget, ulWeight);
+        }
+        p->targetSelector.Initialize();
+        if (p->pTimeSpan->GetLookaheadDepth() > 0 && p->targetSelector.GetTargetCount() > 1)
+        {
+            p->targetSelector.SetLookaheadDepth(p->pTimeSpan->GetLookaheadDepth());
+        }
+
+        p->vIORequest.resize(cIORequests, IORequest(p->pRand));
+
+        for (UINT32 iIORequest = 0; iIORequest < cIORequests; iIORequest++)
+        {
+            p->vIORequest[iIORequest].SetRequestIndex(iIORequest);
+            p->vIORequest[iIORequest].SetTargetSelector(&p->targetSelector);
         }
     }
     else
@@ -1608,7 +2839,7 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             for (DWORD iRequest = 0; iRequest < pTarget->GetRequestCount(); ++iRequest)
             {
                 IORequest ioRequest(p->pRand);
-                ioRequest.AddTarget(pTarget, 1);
+                ioRequest.SetTarget(pTarget);
                 ioRequest.SetRequestIndex(iRequest);
                 p->vIORequest.push_back(ioRequest);
             }
@@ -1644,7 +2875,7 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         if (pTarget->GetThroughputInBytesPerMillisecond() > 0 || pTarget->GetThinkTime() > 0)
         {
             fUseThrougputMeter = true;
-            throughputMeter.Start(pTarget->GetThroughputInBytesPerMillisecond(), pTarget->GetBlockSizeInBytes(), pTarget->GetThinkTime(), dwBurstSize);
+            throughputMeter.Start(pTarget->GetThroughputInBytesPerMillisecond(), pTarget->GetMaxBlockSizeInBytes(), pTarget->GetThinkTime(), dwBurstSize);
         }
 
         p->vThroughputMeters.push_back(throughputMeter);
@@ -1654,40 +2885,133 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     {
         p->vThroughputMeters.clear();
     }
+
+    //
+    // fill the flush schedules
+    //
+    bool fUseFlushSchedule = false;
+    for (size_t i = 0; i < cTargets; i++)
+    {
+        FlushSchedule flushSchedule;
+        flushSchedule.Initialize(p->vTargets[i]);
+        fUseFlushSchedule = fUseFlushSchedule || flushSchedule.IsEnabled();
+        p->vFlushSchedules.push_back(flushSchedule);
+    }
+
+    if (!fUseFlushSchedule)
+    {
+        p->vFlushSchedules.clear();
+    }
+
+    //
+    // fill the group commits
+    //
+    bool fUseGroupCommit = false;
+    for (size_t i = 0; i < cTargets; i++)
+    {
+        GroupCommit groupCommit;
+        groupCommit.Initialize(p->vTargets[i]);
+        fUseGroupCommit = fUseGroupCommit || groupCommit.IsEnabled();
+        p->vGroupCommits.push_back(groupCommit);
+    }
+
+    if (!fUseGroupCommit)
+    {
+        p->vGroupCommits.clear();
+    }
     
+    //
+    // completed requests come back through the handoff if another thread reaps them
+    //
+    if (p->pTimeSpan->GetSeparateReaper() || p->hSharedCompletionPort != nullptr)
+    {
+        handoff.p = p;
+        handoff.waitStrategy = p->pTimeSpan->GetWaitStrategy();
+        handoff.ullSpinBudget = PerfTimer::MicrosecondsToPerfTime(p->pTimeSpan->GetSpinBudgetInMicroseconds());
+        handoff.returnRing.Initialize(cIORequests);
+        InitializeSRWLock(&handoff.srwLock);
+
+        handoff.hReturnEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (nullptr == handoff.hReturnEvent)
+        {
+            PrintError("unable to create completion handoff event (error code: %u)\n", GetLastError());
+            fOk = false;
+            goto cleanup;
+        }
+        pHandoff = &handoff;
+    }
+
     //FUTURE EXTENSION: enable asynchronous I/O even if only 1 outstanding I/O per file (requires another parameter)
-    if (cIORequests == 1 || fAllMappedIo)
+    if (p->pTimeSpan->GetIoRing())
+    {
+        pIoEngine = CreateIoRingIoEngine(p);
+    }
+    else if (p->pTimeSpan->GetEventCompletions())
+    {
+        pIoEngine = new EventIoEngine();
+    }
+    else if (p->pTimeSpan->GetPollCompletions())
+    {
+        pIoEngine = new PolledIoEngine();
+    }
+    else if (p->hSharedCompletionPort != nullptr)
+    {
+        // the pool finds this thread's handoff through the completion key
+        pIoEngine = new SharedCompletionPortIoEngine(p->hSharedCompletionPort, (ULONG_PTR)pHandoff);
+    }
+    else if (p->pTimeSpan->GetSeparateReaper())
+    {
+        // the reaper and the worker share the port, so this applies to a single outstanding I/O as well
+        pIoEngine = new CompletionPortIoEngine();
+    }
+    else if (cIORequests == 1 || fAllMappedIo)
     {
-        //synchronous IO - no setup needed
+        pIoEngine = new SynchronousIoEngine();
     }
     else if (p->pTimeSpan->GetCompletionRoutines() && !fAnyMappedIo)
     {
-        //in case of completion routines hEvent field is not used,
-        //so we can use it to pass a pointer to the thread parameters
-        for (UINT32 iIORequest = 0; iIORequest < cIORequests; iIORequest++) {
-            OVERLAPPED *pOverlapped;
-
-            pOverlapped = p->vIORequest[iIORequest].GetOverlapped();
-            pOverlapped->hEvent = (HANDLE)p;
-        }
+        pIoEngine = new CompletionRoutineIoEngine(p->hEndEvent);
     }
     else
     {
-        //
-        // create IO completion port if not doing completion routines or synchronous IO
-        //
-        for (unsigned int i = 0; i < vhUniqueHandles.size(); i++)
+        pIoEngine = new CompletionPortIoEngine();
+    }
+
+    if (!pIoEngine->Open(vhUniqueHandles, cIORequests))
+    {
+        PrintError("unable to open %s I/O engine (error code: %u)\n", pIoEngine->GetName(), GetLastError());
+        fOk = false;
+        goto cleanup;
+    }
+
+    // let the engine register the data buffers, if it is able to
+    {
+        vector<IoEngineBuffer> vBuffers;
+        for (const auto& targetIORequestBuffers : p->vPerTargetIORequestBuffers)
         {
-            hCompletionPort = CreateIoCompletionPort(vhUniqueHandles[i], hCompletionPort, 0, 1);
-            if (nullptr == hCompletionPort)
+            for (const auto& ioRequestBuffers : targetIORequestBuffers.vIORequestBuffers)
             {
-                PrintError("unable to create IO completion port (error code: %u)\n", GetLastError());
-                fOk = false;
-                goto cleanup;
+                if (ioRequestBuffers.vpReadDataBuffer != nullptr)
+                {
+                    vBuffers.push_back({ ioRequestBuffers.vpReadDataBuffer, ioRequestBuffers.ulSize });
+                }
+                if (ioRequestBuffers.vpWriteDataBuffer != nullptr)
+                {
+                    vBuffers.push_back({ ioRequestBuffers.vpWriteDataBuffer, ioRequestBuffers.ulSize });
+                }
             }
         }
+
+        if (!pIoEngine->RegisterBuffers(vBuffers))
+        {
+            PrintError("unable to register buffers with %s I/O engine (error code: %u)\n", pIoEngine->GetName(), GetLastError());
+            fOk = false;
+            goto cleanup;
+        }
     }
 
+    printfv(p->pProfile->GetVerbose(), "thread %u: using %s I/O engine\n", p->ulThreadNo, pIoEngine->GetName());
+
     //
     // wait for a signal to start
     //
@@ -1700,6 +3024,23 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     }
     printfv(p->pProfile->GetVerbose(), "thread %u: received signal to start\n", p->ulThreadNo);
 
+    // moving distributions start from their initial position now, and timed flushes and commits count from now
+    {
+        UINT64 ullStartTime = PerfTimer::GetTime();
+        for (auto& distribution : p->vOffsetDistributions)
+        {
+            distribution.StartDrift(ullStartTime);
+        }
+        for (auto& flushSchedule : p->vFlushSchedules)
+        {
+            flushSchedule.Start(ullStartTime);
+        }
+        for (auto& groupCommit : p->vGroupCommits)
+        {
+            groupCommit.Start(ullStartTime);
+        }
+    }
+
     //check if everything is ok
     if (g_bError)
     {
@@ -1707,33 +3048,10 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         goto cleanup;
     }
 
-    //error handling and memory freeing is done in doWorkUsingIOCompletionPorts and doWorkUsingCompletionRoutines
-    if (cIORequests == 1 || fAllMappedIo)
-    {
-        // use synchronous IO (it will also clse the event)
-        if (!doWorkUsingSynchronousIO(p))
-        {
-            fOk = false;
-            goto cleanup;
-        }
-    }
-    else if (!p->pTimeSpan->GetCompletionRoutines() || fAnyMappedIo)
-    {
-        // use IO Completion Ports (it will also close the I/O completion port)
-        if (!doWorkUsingIOCompletionPorts(p, hCompletionPort))
-        {
-            fOk = false;
-            goto cleanup;
-        }
-    }
-    else
+    if (!doWorkUsingIoEngine(p, pIoEngine, pHandoff))
     {
-        //use completion routines
-        if (!doWorkUsingCompletionRoutines(p))
-        {
-            fOk = false;
-            goto cleanup;
-        }
+        fOk = false;
+        goto cleanup;
     }
 
     assert(!g_bError);  // at this point we shouldn't be seeing initialization error
@@ -1746,6 +3064,19 @@ cleanup:
         g_bThreadError = TRUE;
     }
 
+    // close the I/O engine (and its completion port, if any); this also drops any
+    // registrations it holds on the buffers and files released below
+    if (pIoEngine != nullptr)
+    {
+        pIoEngine->Close();
+        delete pIoEngine;
+    }
+
+    if (pHandoff != nullptr)
+    {
+        CloseHandle(pHandoff->hReturnEvent);
+    }
+
     // free memory allocated with VirtualAlloc
     for (auto itTargetIORequestBuffers = p->vPerTargetIORequestBuffers.begin(); itTargetIORequestBuffers != p->vPerTargetIORequestBuffers.end(); 
         itTargetIORequestBuffers++)
@@ -1767,6 +3098,15 @@ cleanup:
         }
     }
 
+    // release access pattern plugin state
+    for (size_t i = 0; i < p->vpAccessPatternStates.size(); i++)
+    {
+        if (p->vpAccessPatternStates[i] != nullptr)
+        {
+            p->vpAccessPatternPlugins[i]->DestroyState(p->vpAccessPatternStates[i]);
+        }
+    }
+
     // free NV tokens
     for (auto i = p->vTargets.begin(); i != p->vTargets.end(); i++)
     {
@@ -1777,16 +3117,22 @@ cleanup:
         }
     }
 
-    // close files
-    for (auto i = vhUniqueHandles.begin(); i != vhUniqueHandles.end(); i++)
+    // close the segments of appended targets opened during the run; the first is one of the unique handles
+    for (const auto& vhSegments : p->vvhAppendSegments)
     {
-        CloseHandle(*i);
+        for (size_t i = 1; i < vhSegments.size(); i++)
+        {
+            if (vhSegments[i] != nullptr)
+            {
+                CloseHandle(vhSegments[i]);
+            }
+        }
     }
 
-    // close completion ports
-    if (hCompletionPort != nullptr)
+    // close files
+    for (auto i = vhUniqueHandles.begin(); i != vhUniqueHandles.end(); i++)
     {
-        CloseHandle(hCompletionPort);
+        CloseHandle(*i);
     }
 
     delete p->pRand;
@@ -2224,6 +3570,12 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         return false;
     }
 
+    if (timeSpan.GetIoRing() && !LoadIoRingApi())
+    {
+        PrintError("ERROR: I/O rings (-xr) are not supported on this system\n");
+        return false;
+    }
+
     //FUTURE EXTENSION: check for conflicts in alignment (when cache is turned off only sector aligned I/O are permitted)
     //FUTURE EXTENSION: check if file sizes are enough to have at least first requests not wrapping around
 
@@ -2327,11 +3679,112 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
     BYTE bProcCtr = 0;
     g_SystemInformation.processorTopology.GetActiveGroupProcessor(wGroupCtr, bProcCtr, false);
 
+    // helper threads (I/O ring submission pollers, completion reapers, the completion pool)
+    // continue the round robin where the worker threads leave off
+    WORD wHelperGroupCtr = wGroupCtr;
+    BYTE bHelperProcCtr = bProcCtr;
+    if (timeSpan.GetIoRingSubmissionPoller() || timeSpan.GetSeparateReaper() || timeSpan.GetCompletionPoolThreadCount() > 0)
+    {
+        for (UINT32 iThread = 0; iThread < cThreads; ++iThread)
+        {
+            g_SystemInformation.processorTopology.GetActiveGroupProcessor(wHelperGroupCtr, bHelperProcCtr, true);
+        }
+    }
+
     volatile bool fAccountingOn = false;
     UINT64 ullStartTime;    //start time
     UINT64 ullTimeDiff;  //elapsed test time (in units returned by QueryPerformanceCounter)
     vector<UINT64> vullSharedSequentialOffsets(vTargets.size(), 0);
 
+    // start the completion pool, if any, so its port is ready when the workers open their files
+    CompletionPool completionPool;
+    results.vCompletionPoolResults.clear();
+    if (timeSpan.GetCompletionPoolThreadCount() > 0)
+    {
+        vector<AffinityAssignment> vPoolAffinity;
+        WORD wPoolGroupCtr = wHelperGroupCtr;
+        BYTE bPoolProcCtr = bHelperProcCtr;
+
+        for (DWORD iPoolThread = 0; iPoolThread < timeSpan.GetCompletionPoolThreadCount(); ++iPoolThread)
+        {
+            if (vAffinity.size() == 0)
+            {
+                vPoolAffinity.emplace_back(wPoolGroupCtr, bPoolProcCtr);
+                g_SystemInformation.processorTopology.GetActiveGroupProcessor(wPoolGroupCtr, bPoolProcCtr, true);
+            }
+            else
+            {
+                const auto& affinity = vAffinity[(cThreads + iPoolThread) % vAffinity.size()];
+                vPoolAffinity.emplace_back(affinity.wGroup, affinity.bProc);
+            }
+        }
+
+        if (!completionPool.Start(timeSpan, vPoolAffinity, results.vCompletionPoolResults, &fAccountingOn))
+        {
+            PrintError("ERROR: unable to start the completion pool (error code: %u)\n", GetLastError());
+            return false;
+        }
+    }
+
+    // load each access pattern plugin once; they stay loaded until the threads using them are done
+    map<string, AccessPatternPlugin> mAccessPatternPlugins;
+    for (const auto& target : vTargets)
+    {
+        string sPlugin = target.GetAccessPatternPlugin();
+        if (!sPlugin.empty() && mAccessPatternPlugins.find(sPlugin) == mAccessPatternPlugins.end())
+        {
+            if (!mAccessPatternPlugins[sPlugin].Load(sPlugin))
+            {
+                PrintError("ERROR: unable to load access pattern plugin %s (error code: %u)\n", sPlugin.c_str(), GetLastError());
+                return false;
+            }
+            printfv(profile.GetVerbose(), "loaded access pattern plugin %s\n", sPlugin.c_str());
+        }
+    }
+
+    // each appended target (-wa) is emptied and gets one log, shared by the threads writing to it
+    map<string, AppendLog> mAppendLogs;
+    for (const auto& target : vTargets)
+    {
+        string str = target.GetPath();
+        if (target.GetUseAppend() && mAppendLogs.find(str) == mAppendLogs.end())
+        {
+            if ('#' == str[0] || (':' == str[1] && '\0' == str[2]))
+            {
+                PrintError("ERROR: append (-wa) is only supported on files\n");
+                return false;
+            }
+
+            if (!mAppendLogs[str].Initialize(target))
+            {
+                PrintError("ERROR: unable to create target '%s' for append (error code: %u)\n", str.c_str(), GetLastError());
+                return false;
+            }
+        }
+    }
+
+    // the lookahead dump (-kd) is shared by all threads, which append whole batches to it
+    HANDLE hLookaheadDump = nullptr;
+    if (!timeSpan.GetLookaheadDumpPath().empty())
+    {
+        hLookaheadDump = CreateFileA(timeSpan.GetLookaheadDumpPath().c_str(),
+                                     FILE_APPEND_DATA,
+                                     FILE_SHARE_READ,
+                                     nullptr,
+                                     CREATE_ALWAYS,
+                                     FILE_ATTRIBUTE_NORMAL,
+                                     nullptr);
+        if (INVALID_HANDLE_VALUE == hLookaheadDump)
+        {
+            PrintError("ERROR: unable to create lookahead dump file '%s' (error code: %u)\n", timeSpan.GetLookaheadDumpPath().c_str(), GetLastError());
+            return false;
+        }
+
+        const char szHeader[] = "thread,target,offset,type,size\n";
+        DWORD cbWritten;
+        WriteFile(hLookaheadDump, szHeader, sizeof(szHeader) - 1, &cbWritten, nullptr);
+    }
+
     results.vThreadResults.clear();
     results.vThreadResults.resize(cThreads);
     for (UINT32 iThread = 0; iThread < cThreads; ++iThread)
@@ -2434,6 +3887,14 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         cookie->pullStartTime = &ullStartTime;
         cookie->ulRandSeed = timeSpan.GetRandSeed() + iThread;  // each thread has a different random seed
         cookie->pRand = pRand;
+        cookie->hSharedCompletionPort = completionPool.GetCompletionPort();
+        cookie->hLookaheadDump = hLookaheadDump;
+
+        for (const auto& target : cookie->vTargets)
+        {
+            cookie->vpAccessPatternPlugins.push_back(target.GetUseAccessPatternPlugin() ? &mAccessPatternPlugins[target.GetAccessPatternPlugin()] : nullptr);
+            cookie->vpAppendLogs.push_back(target.GetUseAppend() ? &mAppendLogs[target.GetPath()] : nullptr);
+        }
 
         //Set thread group and proc affinity
 
@@ -2443,9 +3904,12 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         {
             cookie->wGroupNum = wGroupCtr;
             cookie->bProcNum = bProcCtr;
+            cookie->wHelperGroupNum = wHelperGroupCtr;
+            cookie->bHelperProcNum = bHelperProcCtr;
 
             // advance to next active
             g_SystemInformation.processorTopology.GetActiveGroupProcessor(wGroupCtr, bProcCtr, true);
+            g_SystemInformation.processorTopology.GetActiveGroupProcessor(wHelperGroupCtr, bHelperProcCtr, true);
         }
         // Assigned affinity. Round robin through the assignment list.
         else
@@ -2454,6 +3918,11 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
 
             cookie->wGroupNum = vAffinity[i].wGroup;
             cookie->bProcNum = vAffinity[i].bProc;
+
+            i = (cThreads + iThread) % vAffinity.size();
+
+            cookie->wHelperGroupNum = vAffinity[i].wGroup;
+            cookie->bHelperProcNum = vAffinity[i].bProc;
         }
 
         //create thread
@@ -2714,6 +4183,36 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
     }
 #pragma warning( pop )
 
+    // the workers have taken back all of their requests, so the pool is idle
+    completionPool.Stop();
+
+    if (nullptr != hLookaheadDump)
+    {
+        CloseHandle(hLookaheadDump);
+        hLookaheadDump = nullptr;
+    }
+
+    // appended targets have grown during the run, so report the size they have reached
+    for (auto& threadResults : results.vThreadResults)
+    {
+        for (auto& targetResults : threadResults.vTargetResults)
+        {
+            auto it = mAppendLogs.find(targetResults.sPath);
+            if (it != mAppendLogs.end())
+            {
+                targetResults.ullFileSize = it->second.GetTotalBytes();
+            }
+        }
+    }
+
+    for (const auto& appendLog : mAppendLogs)
+    {
+        printfv(profile.GetVerbose(), "appended %I64u bytes to '%s' in %u segment(s)\n",
+            appendLog.second.GetTotalBytes(),
+            appendLog.first.c_str(),
+            appendLog.second.GetSegmentCount());
+    }
+
     //check if there has been an error during threads execution
     if (g_bThreadError)
     {
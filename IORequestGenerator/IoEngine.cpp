@@ -0,0 +1,1124 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "IoEngine.h"
+#include "OverlappedRing.h"
+#include "CpuTimeMeter.h"
+#include <ioringapi.h>
+#include <Winioctl.h>   //FSCTL_FILE_LEVEL_TRIM, FSCTL_SET_ZERO_DATA, DSM trim
+#include <assert.h>
+#include <algorithm>
+
+/*****************************************************************************/
+// issue a request on behalf of an engine. Reads and writes move data through the buffer; trims and
+// write-zeroes only name a range of the target, and go through DeviceIoControl with the same
+// OVERLAPPED. These controls are buffered, so their input need not outlive the call.
+//
+struct DsmTrimInput
+{
+    DEVICE_MANAGE_DATA_SET_ATTRIBUTES attributes;
+    DEVICE_DATA_SET_RANGE range;
+};
+
+static BOOL IssueIo(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, DWORD *pdwBytesTransferred, OVERLAPPED *pOverlapped)
+{
+    UINT64 ullOffset = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+
+    switch (pIORequest->GetIoType())
+    {
+    case IOOperation::ReadIO:
+        return ReadFile(hFile, pBuffer, cbTransfer, pdwBytesTransferred, pOverlapped);
+
+    case IOOperation::WriteIO:
+        return WriteFile(hFile, pBuffer, cbTransfer, pdwBytesTransferred, pOverlapped);
+
+    case IOOperation::TrimIO:
+        if (pIORequest->GetCurrentTarget()->GetDeviceTarget())
+        {
+            // disks and partitions: data set management trim of the one range
+            DsmTrimInput dsm = {};
+            dsm.attributes.Size = sizeof(dsm.attributes);
+            dsm.attributes.Action = DeviceDsmAction_Trim;
+            dsm.attributes.DataSetRangesOffset = FIELD_OFFSET(DsmTrimInput, range);
+            dsm.attributes.DataSetRangesLength = sizeof(dsm.range);
+            dsm.range.StartingOffset = ullOffset;
+            dsm.range.LengthInBytes = cbTransfer;
+
+            return DeviceIoControl(hFile, IOCTL_STORAGE_MANAGE_DATA_SET_ATTRIBUTES, &dsm, sizeof(dsm), nullptr, 0, pdwBytesTransferred, pOverlapped);
+        }
+        else
+        {
+            // files: the file system releases the range and passes the trim on to the storage
+            FILE_LEVEL_TRIM trim = {};
+            trim.NumRanges = 1;
+            trim.Ranges[0].Offset = ullOffset;
+            trim.Ranges[0].Length = cbTransfer;
+
+            return DeviceIoControl(hFile, FSCTL_FILE_LEVEL_TRIM, &trim, sizeof(trim), nullptr, 0, pdwBytesTransferred, pOverlapped);
+        }
+
+    default:
+        {
+            // sparse files deallocate the range, others have it written with zeroes by the file system
+            FILE_ZERO_DATA_INFORMATION zero;
+            zero.FileOffset.QuadPart = ullOffset;
+            zero.BeyondFinalZero.QuadPart = ullOffset + cbTransfer;
+
+            return DeviceIoControl(hFile, FSCTL_SET_ZERO_DATA, &zero, sizeof(zero), nullptr, 0, pdwBytesTransferred, pOverlapped);
+        }
+    }
+}
+
+/*****************************************************************************/
+// default batched reaping: one Reap which may wait, then only what has already arrived
+//
+bool IoEngine::ReapBatch(IoEngineCompletion *pCompletions, DWORD cMaxCompletions, DWORD *pcCompletions, DWORD dwMilliseconds)
+{
+    *pcCompletions = 0;
+
+    while (*pcCompletions < cMaxCompletions)
+    {
+        IoEngineCompletion *pCompletion = &pCompletions[*pcCompletions];
+
+        if (!Reap(&pCompletion->pIORequest, &pCompletion->dwBytesTransferred, (0 == *pcCompletions) ? dwMilliseconds : 0))
+        {
+            return false;
+        }
+
+        if (nullptr == pCompletion->pIORequest)
+        {
+            break;
+        }
+
+        (*pcCompletions)++;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+// synchronous positioned I/O
+//
+bool SynchronousIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    UNREFERENCED_PARAMETER(vhFiles);
+    UNREFERENCED_PARAMETER(cIORequests);
+
+    return true;
+}
+
+bool SynchronousIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    BOOL rslt;
+
+    rslt = IssueIo(pIORequest, hFile, pBuffer, cbTransfer, pdwBytesTransferred, pIORequest->GetOverlapped());
+
+    *pfCompleted = true;
+    return (rslt) ? true : false;
+}
+
+bool SynchronousIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    UNREFERENCED_PARAMETER(pdwBytesTransferred);
+    UNREFERENCED_PARAMETER(dwMilliseconds);
+
+    // nothing is ever outstanding
+    *ppIORequest = nullptr;
+    return true;
+}
+
+void SynchronousIoEngine::Close()
+{
+}
+
+/*****************************************************************************/
+// I/O completion port
+//
+bool CompletionPortIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    for (auto i = vhFiles.begin(); i != vhFiles.end(); i++)
+    {
+        _hCompletionPort = CreateIoCompletionPort(*i, _hCompletionPort, (ULONG_PTR)*i, 1);
+        if (nullptr == _hCompletionPort)
+        {
+            return false;
+        }
+    }
+
+    _vEntries.resize(cIORequests);
+    return true;
+}
+
+bool CompletionPortIoEngine::AddFile(HANDLE hFile)
+{
+    return (nullptr != CreateIoCompletionPort(hFile, _hCompletionPort, (ULONG_PTR)hFile, 1)) ? true : false;
+}
+
+bool CompletionPortIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    BOOL rslt;
+
+    // the completion is always queued to the port, even if the I/O finishes immediately
+    rslt = IssueIo(pIORequest, hFile, pBuffer, cbTransfer, pdwBytesTransferred, pIORequest->GetOverlapped());
+
+    *pfCompleted = false;
+    return (rslt || GetLastError() == ERROR_IO_PENDING) ? true : false;
+}
+
+bool CompletionPortIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    OVERLAPPED *pCompletedOvrp;
+    ULONG_PTR ulCompletionKey;
+
+    *ppIORequest = nullptr;
+    if (GetQueuedCompletionStatus(_hCompletionPort, pdwBytesTransferred, &ulCompletionKey, &pCompletedOvrp, dwMilliseconds) != 0)
+    {
+        //find which I/O operation it was (so we know to which buffer should we use)
+        *ppIORequest = IORequest::OverlappedToIORequest(pCompletedOvrp);
+    }
+    else if (GetLastError() != WAIT_TIMEOUT)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool CompletionPortIoEngine::ReapBatch(IoEngineCompletion *pCompletions, DWORD cMaxCompletions, DWORD *pcCompletions, DWORD dwMilliseconds)
+{
+    ULONG cEntries;
+
+    // a single completion is dequeued as before
+    if (cMaxCompletions == 1)
+    {
+        return IoEngine::ReapBatch(pCompletions, cMaxCompletions, pcCompletions, dwMilliseconds);
+    }
+
+    *pcCompletions = 0;
+    cMaxCompletions = std::min(cMaxCompletions, (DWORD)_vEntries.size());
+
+    if (!GetQueuedCompletionStatusEx(_hCompletionPort, &_vEntries[0], cMaxCompletions, &cEntries, dwMilliseconds, FALSE))
+    {
+        return (GetLastError() == WAIT_TIMEOUT) ? true : false;
+    }
+
+    for (ULONG i = 0; i < cEntries; i++)
+    {
+        OVERLAPPED *pCompletedOvrp = _vEntries[i].lpOverlapped;
+        IoEngineCompletion *pCompletion = &pCompletions[i];
+
+        // the I/O is done, so this does not wait; it only translates the status of the entry
+        pCompletion->pIORequest = IORequest::OverlappedToIORequest(pCompletedOvrp);
+        if (!GetOverlappedResult((HANDLE)_vEntries[i].lpCompletionKey, pCompletedOvrp, &pCompletion->dwBytesTransferred, FALSE))
+        {
+            return false;
+        }
+    }
+
+    *pcCompletions = cEntries;
+    return true;
+}
+
+void CompletionPortIoEngine::Close()
+{
+    if (_hCompletionPort != nullptr)
+    {
+        CloseHandle(_hCompletionPort);
+        _hCompletionPort = nullptr;
+    }
+}
+
+/*****************************************************************************/
+// I/O completion port shared with the completion pool
+//
+bool SharedCompletionPortIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    UNREFERENCED_PARAMETER(cIORequests);
+
+    for (auto i = vhFiles.begin(); i != vhFiles.end(); i++)
+    {
+        if (nullptr == CreateIoCompletionPort(*i, _hCompletionPort, _ulCompletionKey, 0))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SharedCompletionPortIoEngine::AddFile(HANDLE hFile)
+{
+    return (nullptr != CreateIoCompletionPort(hFile, _hCompletionPort, _ulCompletionKey, 0)) ? true : false;
+}
+
+bool SharedCompletionPortIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    BOOL rslt;
+
+    // the completion is always queued to the port, even if the I/O finishes immediately
+    rslt = IssueIo(pIORequest, hFile, pBuffer, cbTransfer, pdwBytesTransferred, pIORequest->GetOverlapped());
+
+    *pfCompleted = false;
+    return (rslt || GetLastError() == ERROR_IO_PENDING) ? true : false;
+}
+
+bool SharedCompletionPortIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    UNREFERENCED_PARAMETER(pdwBytesTransferred);
+    UNREFERENCED_PARAMETER(dwMilliseconds);
+
+    // completions on the shared port are reaped by the completion pool
+    *ppIORequest = nullptr;
+    SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
+/*****************************************************************************/
+// completion routines (ReadFileEx/WriteFileEx)
+//
+bool CompletionRoutineIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    UNREFERENCED_PARAMETER(vhFiles);
+    UNREFERENCED_PARAMETER(cIORequests);
+
+    return true;
+}
+
+bool CompletionRoutineIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    UNREFERENCED_PARAMETER(pdwBytesTransferred);
+
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    BOOL rslt;
+
+    //in case of completion routines hEvent field is not used,
+    //so we can use it to pass a pointer to the engine
+    pOverlapped->hEvent = (HANDLE)this;
+
+    if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        rslt = ReadFileEx(hFile, pBuffer, cbTransfer, pOverlapped, _CompletionRoutine);
+    }
+    else
+    {
+        rslt = WriteFileEx(hFile, pBuffer, cbTransfer, pOverlapped, _CompletionRoutine);
+    }
+
+    *pfCompleted = false;
+    return (rslt) ? true : false;
+}
+
+VOID CALLBACK CompletionRoutineIoEngine::_CompletionRoutine(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED pOverlapped)
+{
+    assert(NULL != pOverlapped);
+
+    CompletionRoutineIoEngine *pEngine = (CompletionRoutineIoEngine *)pOverlapped->hEvent;
+
+    assert(NULL != pEngine);
+
+    if (0 != dwErrorCode && ERROR_SUCCESS == pEngine->_dwError)
+    {
+        pEngine->_dwError = dwErrorCode;
+    }
+
+    pOverlapped->InternalHigh = dwBytesTransferred;
+    pEngine->_completedQueue.Add(pOverlapped);
+}
+
+bool CompletionRoutineIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    *ppIORequest = nullptr;
+
+    if (_completedQueue.IsEmpty())
+    {
+        DWORD dwWaitResult = WaitForSingleObjectEx(_hEndEvent, dwMilliseconds, TRUE);
+        if (WAIT_FAILED == dwWaitResult)
+        {
+            return false;
+        }
+    }
+
+    if (ERROR_SUCCESS != _dwError)
+    {
+        SetLastError(_dwError);
+        return false;
+    }
+
+    if (!_completedQueue.IsEmpty())
+    {
+        OVERLAPPED *pOverlapped = _completedQueue.Remove();
+        *pdwBytesTransferred = (DWORD)pOverlapped->InternalHigh;
+        *ppIORequest = IORequest::OverlappedToIORequest(pOverlapped);
+    }
+
+    return true;
+}
+
+void CompletionRoutineIoEngine::Close()
+{
+}
+
+/*****************************************************************************/
+// overlapped I/O with per-request events
+//
+bool EventIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    UNREFERENCED_PARAMETER(vhFiles);
+
+    if (cIORequests > MAXIMUM_WAIT_OBJECTS)
+    {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
+
+    for (size_t i = 0; i < cIORequests; i++)
+    {
+        HANDLE hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        if (nullptr == hEvent)
+        {
+            return false;
+        }
+        _vhEvents.push_back(hEvent);
+    }
+
+    _vPending.resize(cIORequests);
+    return true;
+}
+
+bool EventIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    BOOL rslt;
+
+    assert(_cPending < _vhEvents.size());
+
+    // take the first free event; it is reset when the I/O is issued
+    pOverlapped->hEvent = _vhEvents[_cPending];
+
+    rslt = IssueIo(pIORequest, hFile, pBuffer, cbTransfer, pdwBytesTransferred, pOverlapped);
+
+    // an I/O which finishes immediately is complete inline, and its event stays free
+    if (rslt)
+    {
+        *pfCompleted = true;
+        return true;
+    }
+
+    if (GetLastError() != ERROR_IO_PENDING)
+    {
+        return false;
+    }
+
+    _vPending[_cPending].pIORequest = pIORequest;
+    _vPending[_cPending].hFile = hFile;
+    _cPending++;
+
+    *pfCompleted = false;
+    return true;
+}
+
+bool EventIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    *ppIORequest = nullptr;
+
+    if (0 == _cPending)
+    {
+        return true;
+    }
+
+    DWORD iPending = 0;
+    if (0 == dwMilliseconds)
+    {
+        // not waiting, so look at the requests themselves rather than their events
+        while (iPending < _cPending && !HasOverlappedIoCompleted(_vPending[iPending].pIORequest->GetOverlapped()))
+        {
+            iPending++;
+        }
+        if (iPending == _cPending)
+        {
+            return true;
+        }
+    }
+    else
+    {
+        DWORD dwWaitResult = WaitForMultipleObjects(_cPending, &_vhEvents[0], FALSE, dwMilliseconds);
+        if (WAIT_TIMEOUT == dwWaitResult)
+        {
+            return true;
+        }
+        if (dwWaitResult >= WAIT_OBJECT_0 + _cPending)
+        {
+            return false;
+        }
+        iPending = dwWaitResult - WAIT_OBJECT_0;
+    }
+
+    *ppIORequest = _vPending[iPending].pIORequest;
+    BOOL rslt = GetOverlappedResult(_vPending[iPending].hFile, (*ppIORequest)->GetOverlapped(), pdwBytesTransferred, FALSE);
+
+    // free the event by swapping it with the last one in flight; this also keeps the wait
+    // from always favoring the same requests
+    _cPending--;
+    std::swap(_vhEvents[iPending], _vhEvents[_cPending]);
+    _vPending[iPending] = _vPending[_cPending];
+
+    return (rslt) ? true : false;
+}
+
+void EventIoEngine::Close()
+{
+    for (auto hEvent : _vhEvents)
+    {
+        CloseHandle(hEvent);
+    }
+    _vhEvents.clear();
+    _vPending.clear();
+    _cPending = 0;
+}
+
+/*****************************************************************************/
+// polled overlapped I/O
+//
+bool PolledIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    UNREFERENCED_PARAMETER(vhFiles);
+
+    _vPending.reserve(cIORequests);
+    return true;
+}
+
+bool PolledIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    BOOL rslt;
+
+    // no event is signaled; completion is only observed through the OVERLAPPED
+    pOverlapped->hEvent = nullptr;
+
+    rslt = IssueIo(pIORequest, hFile, pBuffer, cbTransfer, pdwBytesTransferred, pOverlapped);
+
+    // without a completion port, an I/O which finishes immediately is complete inline
+    if (rslt)
+    {
+        *pfCompleted = true;
+        return true;
+    }
+
+    if (GetLastError() != ERROR_IO_PENDING)
+    {
+        return false;
+    }
+
+    _vPending.push_back({ pIORequest, hFile });
+    *pfCompleted = false;
+    return true;
+}
+
+bool PolledIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    UNREFERENCED_PARAMETER(dwMilliseconds);
+
+    *ppIORequest = nullptr;
+
+    for (size_t i = 0; i < _vPending.size(); i++)
+    {
+        OVERLAPPED *pOverlapped = _vPending[i].pIORequest->GetOverlapped();
+
+        if (HasOverlappedIoCompleted(pOverlapped))
+        {
+            *ppIORequest = _vPending[i].pIORequest;
+
+            // the I/O is done, so this does not wait; it only translates the status
+            BOOL rslt = GetOverlappedResult(_vPending[i].hFile, pOverlapped, pdwBytesTransferred, FALSE);
+
+            _vPending[i] = _vPending.back();
+            _vPending.pop_back();
+
+            return (rslt) ? true : false;
+        }
+    }
+
+    YieldProcessor();
+    return true;
+}
+
+void PolledIoEngine::Close()
+{
+    _vPending.clear();
+}
+
+/*****************************************************************************/
+// I/O rings (IoRing API)
+//
+typedef HRESULT (__stdcall *QueryIoRingCaps)(IORING_CAPABILITIES *);
+static QueryIoRingCaps g_pfnQueryIoRingCapabilities;
+
+typedef HRESULT (__stdcall *CreateIoRingFn)(IORING_VERSION, IORING_CREATE_FLAGS, UINT32, UINT32, HIORING *);
+static CreateIoRingFn g_pfnCreateIoRing;
+
+typedef HRESULT (__stdcall *BuildIoRingReadFileFn)(HIORING, IORING_HANDLE_REF, IORING_BUFFER_REF, UINT32, UINT64, UINT_PTR, IORING_SQE_FLAGS);
+static BuildIoRingReadFileFn g_pfnBuildIoRingReadFile;
+
+typedef HRESULT (__stdcall *BuildIoRingWriteFileFn)(HIORING, IORING_HANDLE_REF, IORING_BUFFER_REF, UINT32, UINT64, FILE_WRITE_FLAGS, UINT_PTR, IORING_SQE_FLAGS);
+static BuildIoRingWriteFileFn g_pfnBuildIoRingWriteFile;
+
+typedef HRESULT (__stdcall *BuildIoRingRegisterFileHandlesFn)(HIORING, UINT32, HANDLE const [], UINT_PTR);
+static BuildIoRingRegisterFileHandlesFn g_pfnBuildIoRingRegisterFileHandles;
+
+typedef HRESULT (__stdcall *BuildIoRingRegisterBuffersFn)(HIORING, UINT32, IORING_BUFFER_INFO const [], UINT_PTR);
+static BuildIoRingRegisterBuffersFn g_pfnBuildIoRingRegisterBuffers;
+
+typedef HRESULT (__stdcall *SubmitIoRingFn)(HIORING, UINT32, UINT32, UINT32 *);
+static SubmitIoRingFn g_pfnSubmitIoRing;
+
+typedef HRESULT (__stdcall *PopIoRingCompletionFn)(HIORING, IORING_CQE *);
+static PopIoRingCompletionFn g_pfnPopIoRingCompletion;
+
+typedef HRESULT (__stdcall *CloseIoRingFn)(HIORING);
+static CloseIoRingFn g_pfnCloseIoRing;
+
+typedef HRESULT (__stdcall *SetIoRingCompletionEventFn)(HIORING, HANDLE);
+static SetIoRingCompletionEventFn g_pfnSetIoRingCompletionEvent;
+
+// the IoRing API reports errors as HRESULTs; the worker loop expects a Win32 error code
+static DWORD HResultToError(HRESULT hr)
+{
+    return (HRESULT_FACILITY(hr) == FACILITY_WIN32) ? HRESULT_CODE(hr) : (DWORD)hr;
+}
+
+static void SetLastErrorFromHResult(HRESULT hr)
+{
+    SetLastError(HResultToError(hr));
+}
+
+bool LoadIoRingApi()
+{
+    HMODULE hKernelBase = GetModuleHandleW(L"kernelbase.dll");
+    if (nullptr == hKernelBase)
+    {
+        return false;
+    }
+
+    g_pfnQueryIoRingCapabilities = (QueryIoRingCaps)GetProcAddress(hKernelBase, "QueryIoRingCapabilities");
+    g_pfnCreateIoRing = (CreateIoRingFn)GetProcAddress(hKernelBase, "CreateIoRing");
+    g_pfnBuildIoRingReadFile = (BuildIoRingReadFileFn)GetProcAddress(hKernelBase, "BuildIoRingReadFile");
+    g_pfnBuildIoRingWriteFile = (BuildIoRingWriteFileFn)GetProcAddress(hKernelBase, "BuildIoRingWriteFile");
+    g_pfnBuildIoRingRegisterFileHandles = (BuildIoRingRegisterFileHandlesFn)GetProcAddress(hKernelBase, "BuildIoRingRegisterFileHandles");
+    g_pfnBuildIoRingRegisterBuffers = (BuildIoRingRegisterBuffersFn)GetProcAddress(hKernelBase, "BuildIoRingRegisterBuffers");
+    g_pfnSubmitIoRing = (SubmitIoRingFn)GetProcAddress(hKernelBase, "SubmitIoRing");
+    g_pfnPopIoRingCompletion = (PopIoRingCompletionFn)GetProcAddress(hKernelBase, "PopIoRingCompletion");
+    g_pfnCloseIoRing = (CloseIoRingFn)GetProcAddress(hKernelBase, "CloseIoRing");
+    g_pfnSetIoRingCompletionEvent = (SetIoRingCompletionEventFn)GetProcAddress(hKernelBase, "SetIoRingCompletionEvent");
+
+    if (nullptr == g_pfnQueryIoRingCapabilities ||
+        nullptr == g_pfnCreateIoRing ||
+        nullptr == g_pfnBuildIoRingReadFile ||
+        nullptr == g_pfnBuildIoRingWriteFile ||
+        nullptr == g_pfnBuildIoRingRegisterFileHandles ||
+        nullptr == g_pfnBuildIoRingRegisterBuffers ||
+        nullptr == g_pfnSubmitIoRing ||
+        nullptr == g_pfnPopIoRingCompletion ||
+        nullptr == g_pfnCloseIoRing ||
+        nullptr == g_pfnSetIoRingCompletionEvent)
+    {
+        return false;
+    }
+
+    // writes are only supported starting with IORING_VERSION_3
+    IORING_CAPABILITIES caps;
+    if (FAILED(g_pfnQueryIoRingCapabilities(&caps)) || caps.MaxVersion < IORING_VERSION_3)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+class IoRingIoEngine : public IoEngine
+{
+public:
+    IoRingIoEngine(ThreadParameters *p) :
+        _p(p),
+        _hIoRing(nullptr),
+        _fDeferSubmission(!p->pTimeSpan->GetIoRingSubmissionPoller() && p->pTimeSpan->GetBatchSize() > 1),
+        _cUnflushed(0),
+        _fSubmissionPoller(p->pTimeSpan->GetIoRingSubmissionPoller()),
+        _hCompletionEvent(nullptr),
+        _hPollerThread(nullptr),
+        _fStopPoller(false),
+        _dwPollerError(ERROR_SUCCESS)
+    {
+    }
+
+    ~IoRingIoEngine() { Close(); }
+
+    const char *GetName() const { return _fSubmissionPoller ? "I/O ring (submission poller)" : "I/O ring"; }
+    bool Open(const vector<HANDLE>& vhFiles, size_t cIORequests);
+    bool RegisterBuffers(const vector<IoEngineBuffer>& vBuffers);
+    bool Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred);
+    bool Flush(DWORD *pcSubmitted);
+    bool Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds);
+    void Close();
+
+private:
+    bool _WaitForRegistration();
+    IORING_HANDLE_REF _GetHandleRef(HANDLE hFile) const;
+    IORING_BUFFER_REF _GetBufferRef(BYTE *pBuffer) const;
+    HRESULT _BuildEntry(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer);
+
+    bool _StartPoller();
+    void _StopPoller();
+    static DWORD WINAPI _PollerThreadFunc(LPVOID pvEngine);
+    void _Poll();
+
+    ThreadParameters *_p;
+    HIORING _hIoRing;
+    vector<HANDLE> _vhFiles;                // registered handles, by index
+    vector<IoEngineBuffer> _vBuffers;       // registered buffers, by index (sorted by address)
+
+    // batched submission: entries are built by Submit and submitted together by Flush
+    bool _fDeferSubmission;
+    DWORD _cUnflushed;
+
+    // submission poller
+    bool _fSubmissionPoller;
+    HANDLE _hCompletionEvent;               // signaled when a completion is posted to the ring
+    HANDLE _hPollerThread;
+    OverlappedRing _submissionRing;         // requests handed from the worker to the poller
+    volatile bool _fStopPoller;
+    volatile DWORD _dwPollerError;          // first error seen by the poller
+};
+
+IoEngine *CreateIoRingIoEngine(ThreadParameters *p)
+{
+    return new IoRingIoEngine(p);
+}
+
+bool IoRingIoEngine::Open(const vector<HANDLE>& vhFiles, size_t cIORequests)
+{
+    IORING_CREATE_FLAGS flags;
+    flags.Required = IORING_CREATE_REQUIRED_FLAGS_NONE;
+    flags.Advisory = IORING_CREATE_ADVISORY_FLAGS_NONE;
+
+    // every request can be in flight at once, so neither queue can overflow
+    HRESULT hr = g_pfnCreateIoRing(IORING_VERSION_3, flags, (UINT32)cIORequests, (UINT32)cIORequests, &_hIoRing);
+    if (FAILED(hr))
+    {
+        _hIoRing = nullptr;
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    // register the handles so the kernel does not need to reference them on every I/O
+    hr = g_pfnBuildIoRingRegisterFileHandles(_hIoRing, (UINT32)vhFiles.size(), vhFiles.data(), 0);
+    if (FAILED(hr))
+    {
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    if (!_WaitForRegistration())
+    {
+        return false;
+    }
+
+    _vhFiles = vhFiles;
+
+    if (_fSubmissionPoller)
+    {
+        // the worker no longer enters the kernel through SubmitIoRing, so it needs another
+        // way to wait for completions
+        _hCompletionEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (nullptr == _hCompletionEvent)
+        {
+            return false;
+        }
+
+        hr = g_pfnSetIoRingCompletionEvent(_hIoRing, _hCompletionEvent);
+        if (FAILED(hr))
+        {
+            SetLastErrorFromHResult(hr);
+            return false;
+        }
+
+        _submissionRing.Initialize(cIORequests);
+    }
+
+    return true;
+}
+
+bool IoRingIoEngine::RegisterBuffers(const vector<IoEngineBuffer>& vBuffers)
+{
+    // registered buffers are locked in memory once, instead of on every I/O
+    _vBuffers = vBuffers;
+    std::sort(_vBuffers.begin(), _vBuffers.end(), [](const IoEngineBuffer& a, const IoEngineBuffer& b) { return a.pBuffer < b.pBuffer; });
+
+    vector<IORING_BUFFER_INFO> vBufferInfo(_vBuffers.size());
+    for (size_t i = 0; i < _vBuffers.size(); i++)
+    {
+        vBufferInfo[i].Address = _vBuffers[i].pBuffer;
+        vBufferInfo[i].Length = _vBuffers[i].cbBuffer;
+    }
+
+    HRESULT hr = g_pfnBuildIoRingRegisterBuffers(_hIoRing, (UINT32)vBufferInfo.size(), vBufferInfo.data(), 0);
+    if (FAILED(hr))
+    {
+        _vBuffers.clear();
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    if (!_WaitForRegistration())
+    {
+        _vBuffers.clear();
+        return false;
+    }
+
+    return true;
+}
+
+// registrations are queued like any other operation; submit them and wait for their completion
+// before any I/O is issued (their user data is zero, which never names an IORequest)
+bool IoRingIoEngine::_WaitForRegistration()
+{
+    IORING_CQE cqe;
+    HRESULT hr;
+
+    hr = g_pfnSubmitIoRing(_hIoRing, 1, INFINITE, nullptr);
+    if (SUCCEEDED(hr))
+    {
+        hr = g_pfnPopIoRingCompletion(_hIoRing, &cqe);
+        if (S_OK == hr)
+        {
+            assert(0 == cqe.UserData);
+            hr = cqe.ResultCode;
+        }
+        else if (S_FALSE == hr)
+        {
+            hr = E_UNEXPECTED;
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    return true;
+}
+
+IORING_HANDLE_REF IoRingIoEngine::_GetHandleRef(HANDLE hFile) const
+{
+    // there is one handle per unique target, so a scan is cheap
+    for (size_t i = 0; i < _vhFiles.size(); i++)
+    {
+        if (_vhFiles[i] == hFile)
+        {
+            return IoRingHandleRefFromIndex((UINT32)i);
+        }
+    }
+
+    return IoRingHandleRefFromHandle(hFile);
+}
+
+IORING_BUFFER_REF IoRingIoEngine::_GetBufferRef(BYTE *pBuffer) const
+{
+    // find the last registered buffer starting at or below pBuffer
+    auto it = std::upper_bound(_vBuffers.begin(), _vBuffers.end(), pBuffer, [](const BYTE *p, const IoEngineBuffer& b) { return p < b.pBuffer; });
+    if (it != _vBuffers.begin())
+    {
+        --it;
+        if (pBuffer < it->pBuffer + it->cbBuffer)
+        {
+            return IoRingBufferRefFromIndexAndOffset((UINT32)(it - _vBuffers.begin()), (UINT32)(pBuffer - it->pBuffer));
+        }
+    }
+
+    // not registered (e.g., a shared random data write buffer)
+    return IoRingBufferRefFromPointer(pBuffer);
+}
+
+HRESULT IoRingIoEngine::_BuildEntry(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer)
+{
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    UINT64 ullOffset = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+
+    if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        return g_pfnBuildIoRingReadFile(_hIoRing,
+                                        _GetHandleRef(hFile),
+                                        _GetBufferRef(pBuffer),
+                                        cbTransfer,
+                                        ullOffset,
+                                        (UINT_PTR)pIORequest,
+                                        IOSQE_FLAGS_NONE);
+    }
+    else
+    {
+        return g_pfnBuildIoRingWriteFile(_hIoRing,
+                                         _GetHandleRef(hFile),
+                                         _GetBufferRef(pBuffer),
+                                         cbTransfer,
+                                         ullOffset,
+                                         FILE_WRITE_FLAGS_NONE,
+                                         (UINT_PTR)pIORequest,
+                                         IOSQE_FLAGS_NONE);
+    }
+}
+
+bool IoRingIoEngine::Submit(IORequest *pIORequest, HANDLE hFile, BYTE *pBuffer, DWORD cbTransfer, bool *pfCompleted, DWORD *pdwBytesTransferred)
+{
+    UNREFERENCED_PARAMETER(pdwBytesTransferred);
+
+    HRESULT hr;
+
+    *pfCompleted = false;
+
+    if (_fSubmissionPoller)
+    {
+        // the ring isn't touched by the worker for submission, so the OVERLAPPED is free
+        // to carry the rest of the request to the poller
+        OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+        pOverlapped->hEvent = hFile;
+        pOverlapped->Internal = (ULONG_PTR)pBuffer;
+        pOverlapped->InternalHigh = cbTransfer;
+
+        if (nullptr == _hPollerThread && !_StartPoller())
+        {
+            return false;
+        }
+
+        // the ring has room for every request, so this can only fail on a logic error
+        if (!_submissionRing.Add(pOverlapped))
+        {
+            assert(false);
+            SetLastError(ERROR_INTERNAL_ERROR);
+            return false;
+        }
+
+        return true;
+    }
+
+    hr = _BuildEntry(pIORequest, hFile, pBuffer, cbTransfer);
+    if (SUCCEEDED(hr))
+    {
+        if (_fDeferSubmission)
+        {
+            _cUnflushed++;
+        }
+        else
+        {
+            hr = g_pfnSubmitIoRing(_hIoRing, 0, 0, nullptr);
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool IoRingIoEngine::Flush(DWORD *pcSubmitted)
+{
+    *pcSubmitted = 0;
+
+    if (0 == _cUnflushed)
+    {
+        return true;
+    }
+
+    HRESULT hr = g_pfnSubmitIoRing(_hIoRing, 0, 0, nullptr);
+    if (FAILED(hr))
+    {
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    *pcSubmitted = _cUnflushed;
+    _cUnflushed = 0;
+    return true;
+}
+
+bool IoRingIoEngine::Reap(IORequest **ppIORequest, DWORD *pdwBytesTransferred, DWORD dwMilliseconds)
+{
+    IORING_CQE cqe;
+    HRESULT hr;
+
+    *ppIORequest = nullptr;
+
+    if (ERROR_SUCCESS != _dwPollerError)
+    {
+        SetLastError(_dwPollerError);
+        return false;
+    }
+
+    hr = g_pfnPopIoRingCompletion(_hIoRing, &cqe);
+    if (S_FALSE == hr && 0 != dwMilliseconds)
+    {
+        // completion queue is empty; wait for the next completion (a caller polling
+        // with a zero timeout only looks at the queue, without entering the kernel)
+        if (_fSubmissionPoller)
+        {
+            if (WAIT_FAILED == WaitForSingleObject(_hCompletionEvent, dwMilliseconds))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            hr = g_pfnSubmitIoRing(_hIoRing, 1, dwMilliseconds, nullptr);
+            if (FAILED(hr) && HRESULT_FROM_WIN32(WAIT_TIMEOUT) != hr)
+            {
+                SetLastErrorFromHResult(hr);
+                return false;
+            }
+        }
+
+        hr = g_pfnPopIoRingCompletion(_hIoRing, &cqe);
+    }
+
+    if (FAILED(hr))
+    {
+        SetLastErrorFromHResult(hr);
+        return false;
+    }
+
+    if (S_OK == hr)
+    {
+        if (FAILED(cqe.ResultCode))
+        {
+            SetLastErrorFromHResult(cqe.ResultCode);
+            return false;
+        }
+
+        *pdwBytesTransferred = (DWORD)cqe.Information;
+        *ppIORequest = (IORequest *)cqe.UserData;
+    }
+
+    return true;
+}
+
+bool IoRingIoEngine::_StartPoller()
+{
+    _hPollerThread = CreateThread(NULL, 64 * 1024, _PollerThreadFunc, this, 0, NULL);
+    return (nullptr != _hPollerThread);
+}
+
+void IoRingIoEngine::_StopPoller()
+{
+    if (nullptr != _hPollerThread)
+    {
+        _fStopPoller = true;
+        WaitForSingleObject(_hPollerThread, INFINITE);
+        CloseHandle(_hPollerThread);
+        _hPollerThread = nullptr;
+    }
+}
+
+DWORD WINAPI IoRingIoEngine::_PollerThreadFunc(LPVOID pvEngine)
+{
+    ((IoRingIoEngine *)pvEngine)->_Poll();
+    return 0;
+}
+
+void IoRingIoEngine::_Poll()
+{
+    CpuTimeMeter cpuTimeMeter;
+
+    // the poller follows the worker threads in the timespan's affinity model
+    if (!_p->pTimeSpan->GetDisableAffinity())
+    {
+        GROUP_AFFINITY GroupAffinity = {};
+        GroupAffinity.Group = _p->wHelperGroupNum;
+        GroupAffinity.Mask = (KAFFINITY)1 << _p->bHelperProcNum;
+        SetThreadGroupAffinity(GetCurrentThread(), &GroupAffinity, nullptr);
+    }
+
+    // charge the poller's CPU time to the measured interval only
+    cpuTimeMeter.Start(_p->pfAccountingOn, &_p->pResults->ullHelperKernelTime, &_p->pResults->ullHelperUserTime);
+
+    while (!_fStopPoller)
+    {
+        cpuTimeMeter.Update();
+
+        OVERLAPPED *pOverlapped;
+        UINT32 cBuilt = 0;
+        HRESULT hr = S_OK;
+        while (SUCCEEDED(hr) && (pOverlapped = _submissionRing.Remove()) != nullptr)
+        {
+            hr = _BuildEntry(IORequest::OverlappedToIORequest(pOverlapped),
+                             pOverlapped->hEvent,
+                             (BYTE *)pOverlapped->Internal,
+                             (DWORD)pOverlapped->InternalHigh);
+            cBuilt++;
+        }
+
+        if (SUCCEEDED(hr) && cBuilt > 0)
+        {
+            hr = g_pfnSubmitIoRing(_hIoRing, 0, 0, nullptr);
+        }
+
+        if (FAILED(hr))
+        {
+            // let the worker report it on its next reap
+            _dwPollerError = HResultToError(hr);
+            SetEvent(_hCompletionEvent);
+            break;
+        }
+
+        if (cBuilt == 0)
+        {
+            YieldProcessor();
+        }
+    }
+
+    cpuTimeMeter.Stop();
+}
+
+void IoRingIoEngine::Close()
+{
+    _StopPoller();
+
+    if (_hIoRing != nullptr)
+    {
+        g_pfnCloseIoRing(_hIoRing);
+        _hIoRing = nullptr;
+    }
+
+    if (_hCompletionEvent != nullptr)
+    {
+        CloseHandle(_hCompletionEvent);
+        _hCompletionEvent = nullptr;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "OverlappedRing.h"
+#include <assert.h>
+
+OverlappedRing::OverlappedRing(void) :
+    _cCapacity(0),
+    _iHead(0),
+    _iTail(0)
+{
+}
+
+void OverlappedRing::Initialize(size_t cCapacity)
+{
+    assert(cCapacity > 0);
+
+    _vpSlots.assign(cCapacity, nullptr);
+    _cCapacity = cCapacity;
+    _iHead.store(0, std::memory_order_relaxed);
+    _iTail.store(0, std::memory_order_relaxed);
+}
+
+bool OverlappedRing::Add(OVERLAPPED *pOverlapped)
+{
+    size_t iTail = _iTail.load(std::memory_order_relaxed);
+
+    if (iTail - _iHead.load(std::memory_order_acquire) == _cCapacity)
+    {
+        return false;
+    }
+
+    _vpSlots[iTail % _cCapacity] = pOverlapped;
+
+    // publish the slot to the consumer
+    _iTail.store(iTail + 1, std::memory_order_release);
+    return true;
+}
+
+OVERLAPPED *OverlappedRing::Remove(void)
+{
+    size_t iHead = _iHead.load(std::memory_order_relaxed);
+
+    if (iHead == _iTail.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    OVERLAPPED *pOverlapped = _vpSlots[iHead % _cCapacity];
+
+    // hand the slot back to the producer
+    _iHead.store(iHead + 1, std::memory_order_release);
+    return pOverlapped;
+}
+
+bool OverlappedRing::IsEmpty(void) const
+{
+    return (_iHead.load(std::memory_order_acquire) == _iTail.load(std::memory_order_acquire));
+}
@@ -212,7 +212,7 @@ void ResultParser::_DisplayETW(struct ETWMask ETWMask, struct ETWEventCounters E
     }
 }
 
-void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines)
+void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines, bool fIoRing, bool fEventCompletions)
 {
     _Print("\tpath: '%s'\n", target.GetPath().c_str());
     _Print("\t\tthink time: %ums\n", target.GetThinkTime());
@@ -290,7 +290,15 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         _Print("\t\tusing parallel async I/O\n");
     }
 
-    if (target.GetWriteRatio() == 0)
+    if (target.GetTrimRatio() != 0 || target.GetWriteZeroesRatio() != 0)
+    {
+        _Print("\t\tperforming mix test (read/write/trim/write zeroes ratio: %u/%u/%u/%u)\n",
+            100 - target.GetModifyRatio(),
+            target.GetWriteRatio(),
+            target.GetTrimRatio(),
+            target.GetWriteZeroesRatio());
+    }
+    else if (target.GetWriteRatio() == 0)
     {
         _Print("\t\tperforming read test\n");
     }
@@ -302,7 +310,84 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
     {
         _Print("\t\tperforming mix test (read/write ratio: %d/%d)\n", 100 - target.GetWriteRatio(), target.GetWriteRatio());
     }
+
+    if (target.GetDurableWriteRatio() != 0)
+    {
+        _Print("\t\tdurable writes: %u%% of the writes, written through\n", target.GetDurableWriteRatio());
+    }
+
+    if (target.GetUseFlush())
+    {
+        const char *pszFlushType = target.GetFlushDataOnly() ? "data only" : "data and metadata";
+        if (target.GetFlushIoInterval() != 0)
+        {
+            _Print("\t\tflushing (%s) every %u I/Os per thread\n", pszFlushType, target.GetFlushIoInterval());
+        }
+        else if (target.GetFlushTimeIntervalInMilliseconds() != 0)
+        {
+            _Print("\t\tflushing (%s) every %ums per thread\n", pszFlushType, target.GetFlushTimeIntervalInMilliseconds());
+        }
+        else
+        {
+            _Print("\t\tflushing (%s) ahead of %u%% of the I/Os\n", pszFlushType, target.GetFlushRatio());
+        }
+    }
+
+    if (target.GetUseAppend())
+    {
+        _Print("\t\tappending at the tail of the target");
+        if (target.GetAppendPreallocationSizeInBytes() != 0)
+        {
+            _Print(", preallocating %I64u bytes at a time", target.GetAppendPreallocationSizeInBytes());
+        }
+        if (target.GetAppendSegmentSizeInBytes() != 0)
+        {
+            _Print(", new segment every %I64u bytes", target.GetAppendSegmentSizeInBytes());
+        }
+        _Print("\n");
+    }
+
+    if (target.GetUseGroupCommit())
+    {
+        _Print("\t\tgroup commit: %u committers per thread, %u byte records, flushing (%s) each group",
+            target.GetCommitterCount(),
+            target.GetCommitRecordSizeInBytes(),
+            target.GetFlushDataOnly() ? "data only" : "data and metadata");
+        if (target.GetCommitThinkTimeInMicroseconds() != 0)
+        {
+            _Print(", %uus think time", target.GetCommitThinkTimeInMicroseconds());
+        }
+        _Print("\n");
+    }
+
+    if (target.GetUseMetadata())
+    {
+        _Print("\t\tmetadata workload: fanout %u, depth %u, %u files per directory (%u files per thread)\n",
+            target.GetMetadataFanout(),
+            target.GetMetadataDepth(),
+            target.GetMetadataFilesPerDirectory(),
+            target.GetMetadataFileCount());
+        _Print("\t\tmetadata operation weights (create:open:stat:rename:unlink): %u:%u:%u:%u:%u\n",
+            target.GetMetadataWeight(MetadataOperation::Create),
+            target.GetMetadataWeight(MetadataOperation::Open),
+            target.GetMetadataWeight(MetadataOperation::Stat),
+            target.GetMetadataWeight(MetadataOperation::Rename),
+            target.GetMetadataWeight(MetadataOperation::Unlink));
+    }
     _Print("\t\tblock size: %d\n", target.GetBlockSizeInBytes());
+    for (auto ioType : { IOOperation::ReadIO, IOOperation::WriteIO })
+    {
+        const auto& vBlockSizes = target.GetBlockSizeWeights(ioType);
+        if (vBlockSizes.size() > 0)
+        {
+            _Print("\t\t%s block size distribution (size:weight):", ioType == IOOperation::ReadIO ? "read" : "write");
+            for (const auto& blockSize : vBlockSizes)
+            {
+                _Print(" %u:%u", blockSize.dwBlockSize, blockSize.ulWeight);
+            }
+            _Print("\n");
+        }
+    }
     if (target.GetUseRandomAccessPattern())
     {
         _Print("\t\tusing random I/O (alignment: ");
@@ -319,6 +404,72 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         }
     }
     _Print("%I64u)\n", target.GetBlockAlignmentInBytes());
+    if (target.GetUseSequentialStreams())
+    {
+        _Print("\t\tsequential streams per thread: %u%s\n",
+            target.GetSequentialStreamCount(),
+            target.GetUseReverseSequential() ? " (reverse)" : "");
+        if (target.GetSequentialReadRun() != 0)
+        {
+            _Print("\t\tsequential pattern: read %u strides, skip %u strides\n",
+                target.GetSequentialReadRun(),
+                target.GetSequentialSkipRun());
+        }
+    }
+    if (target.GetUseRandomPermutation())
+    {
+        _Print("\t\trandom I/O without replacement (each block once per pass)\n");
+    }
+    if (target.GetUseAccessPatternPlugin())
+    {
+        _Print("\t\taccess pattern plugin: %s", target.GetAccessPatternPlugin().c_str());
+        if (!target.GetAccessPatternParameters().empty())
+        {
+            _Print(" (parameters: %s)", target.GetAccessPatternParameters().c_str());
+        }
+        _Print("\n");
+    }
+    if (target.GetRandomRatio() != 100)
+    {
+        _Print("\t\tmixed random/sequential I/O: %u%% random, sequential runs of %u-%u I/Os\n",
+            target.GetRandomRatio(),
+            target.GetMinSequentialRun(),
+            target.GetMaxSequentialRun());
+    }
+    switch (target.GetRandomDistribution())
+    {
+    case DistributionType::Percent:
+        _Print("\t\trandom distribution (IO%%/target%%):");
+        for (const auto& range : target.GetDistributionRanges())
+        {
+            _Print(" %u/%u", range.ulIoPercent, range.ulTargetPercent);
+        }
+        _Print("\n");
+        break;
+    case DistributionType::Absolute:
+        _Print("\t\trandom distribution (IO%%/target bytes):");
+        for (const auto& range : target.GetDistributionRanges())
+        {
+            _Print(" %u/%I64u", range.ulIoPercent, range.ullTargetBytes);
+        }
+        _Print("\n");
+        break;
+    case DistributionType::Zipf:
+        _Print("\t\trandom distribution: zipf (theta: %g)\n", target.GetZipfTheta());
+        break;
+    case DistributionType::Pareto:
+        _Print("\t\trandom distribution: pareto (%u%% of I/O to %u%% of target)\n", 100 - target.GetParetoHotPercent(), target.GetParetoHotPercent());
+        break;
+    case DistributionType::Normal:
+        _Print("\t\trandom distribution: normal (center: %g%%, stddev: %g%%)\n", target.GetNormalCenterPercent(), target.GetNormalStdDevPercent());
+        break;
+    default:
+        break;
+    }
+    if (target.GetDistributionDrift() != 0)
+    {
+        _Print("\t\trandom distribution moving forward %I64u bytes/s\n", target.GetDistributionDrift());
+    }
 
     if (fUseRequestsPerFile)
     {
@@ -356,7 +507,15 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
     {
         _Print("\t\tthreads per file: %d\n", target.GetThreadsPerFile());
     }
-    if (target.GetRequestCount() > 1 && fUseThreadsPerFile)
+    if (fIoRing)
+    {
+        _Print("\t\tusing I/O rings (IoRing)\n");
+    }
+    else if (fEventCompletions)
+    {
+        _Print("\t\tusing per-I/O events\n");
+    }
+    else if (target.GetRequestCount() > 1 && fUseThreadsPerFile)
     {
         if (fCompletionRoutines)
         {
@@ -404,6 +563,30 @@ void ResultParser::_PrintTimeSpan(const TimeSpan& timeSpan)
         _Print("\tgathering IOPS at intervals of %ums\n", timeSpan.GetIoBucketDurationInMilliseconds());
     }
     _Print("\trandom seed: %u\n", timeSpan.GetRandSeed());
+    if (timeSpan.GetBatchSize() > 1)
+    {
+        _Print("\tbatching up to %u I/Os per call\n", timeSpan.GetBatchSize());
+    }
+    if (timeSpan.GetLookaheadDepth() > 0)
+    {
+        _Print("\tpregenerating %u I/Os per target per thread\n", timeSpan.GetLookaheadDepth());
+        if (!timeSpan.GetLookaheadDumpPath().empty())
+        {
+            _Print("\tdumping pregenerated I/Os to %s\n", timeSpan.GetLookaheadDumpPath().c_str());
+        }
+    }
+    switch (timeSpan.GetWaitStrategy())
+    {
+    case WaitStrategy::Block:
+        _Print("\twaiting for completions: block\n");
+        break;
+    case WaitStrategy::Poll:
+        _Print("\twaiting for completions: busy-poll\n");
+        break;
+    case WaitStrategy::SpinThenBlock:
+        _Print("\twaiting for completions: spin for up to %uus, then block\n", timeSpan.GetSpinBudgetInMicroseconds());
+        break;
+    }
 
     const auto& vAffinity = timeSpan.GetAffinityAssignments();
     if ( vAffinity.size() > 0)
@@ -427,10 +610,27 @@ void ResultParser::_PrintTimeSpan(const TimeSpan& timeSpan)
         _Print("\t           be compared to other results using the -Zr flag\n");
     }
 
+    if (timeSpan.GetPollCompletions())
+    {
+        _Print("\tpolling for I/O completions\n");
+        _Print("\t  WARNING: each thread keeps a CPU busy while it has I/O outstanding; latency\n");
+        _Print("\t           should only be compared to other results alongside its CPU cost\n");
+    }
+
+    if (timeSpan.GetSeparateReaper())
+    {
+        _Print("\treaping completions on a separate thread per worker\n");
+    }
+
+    if (timeSpan.GetCompletionPoolThreadCount() > 0)
+    {
+        _Print("\treaping completions from a shared port with a pool of %u threads\n", timeSpan.GetCompletionPoolThreadCount());
+    }
+
     vector<Target> vTargets(timeSpan.GetTargets());
     for (auto i = vTargets.begin(); i != vTargets.end(); i++)
     {
-        _PrintTarget(*i, (timeSpan.GetThreadCount() == 0), (timeSpan.GetThreadCount() == 0 || timeSpan.GetRequestCount() == 0), timeSpan.GetCompletionRoutines());
+        _PrintTarget(*i, (timeSpan.GetThreadCount() == 0), (timeSpan.GetThreadCount() == 0 || timeSpan.GetRequestCount() == 0), timeSpan.GetCompletionRoutines(), timeSpan.GetIoRing(), timeSpan.GetEventCompletions());
     }
 }
 
@@ -556,6 +756,85 @@ void ResultParser::_PrintCpuUtilization(const Results& results, const SystemInfo
     _Print("%s", szFloatBuffer);
 }
 
+void ResultParser::_PrintThreadCpuUtilization(const vector<ThreadResults>& vThreadResults, UINT64 ullTimeCount, const char *pszTitle, bool fHelper)
+{
+    // thread CPU time is in 100ns units; usage is relative to a single CPU
+    double fTime = PerfTimer::PerfTimeToSeconds(ullTimeCount) * 10000000.0;
+    double totalUserTime = 0;
+    double totalKrnlTime = 0;
+
+    char szFloatBuffer[1024];
+
+    _Print("\n%s\n", pszTitle);
+    _Print("thread |  Usage |  User  |  Kernel\n");
+    _Print("-------------------------------------\n");
+
+    for (size_t iThread = 0; iThread < vThreadResults.size(); iThread++)
+    {
+        const ThreadResults& threadResults = vThreadResults[iThread];
+        double userTime = 100.0 * (fHelper ? threadResults.ullHelperUserTime : threadResults.ullUserTime) / fTime;
+        double krnlTime = 100.0 * (fHelper ? threadResults.ullHelperKernelTime : threadResults.ullKernelTime) / fTime;
+
+        sprintf_s(szFloatBuffer, sizeof(szFloatBuffer), "%6u | %6.2lf%%| %6.2lf%%|  %6.2lf%%\n",
+            (unsigned int)iThread,
+            userTime + krnlTime,
+            userTime,
+            krnlTime);
+        _Print("%s", szFloatBuffer);
+
+        totalUserTime += userTime;
+        totalKrnlTime += krnlTime;
+    }
+
+    _Print("-------------------------------------\n");
+
+    sprintf_s(szFloatBuffer, sizeof(szFloatBuffer), "total: | %6.2lf%%| %6.2lf%%|  %6.2lf%%\n",
+        totalUserTime + totalKrnlTime,
+        totalUserTime,
+        totalKrnlTime);
+    _Print("%s", szFloatBuffer);
+}
+
+void ResultParser::_PrintBatching(const Results& results)
+{
+    char szFloatBuffer[1024];
+    UINT64 ullSubmitCalls = 0;
+    UINT64 ullSubmittedIOs = 0;
+    UINT64 ullReapCalls = 0;
+    UINT64 ullReapedIOs = 0;
+
+    _Print("\nI/O batching\n");
+    _Print("thread |   submit calls  | I/Os per submit |    reap calls   | I/Os per reap\n");
+    _Print("---------------------------------------------------------------------------\n");
+
+    for (size_t iThread = 0; iThread < results.vThreadResults.size(); iThread++)
+    {
+        const ThreadResults& threadResults = results.vThreadResults[iThread];
+
+        sprintf_s(szFloatBuffer, sizeof(szFloatBuffer), "%6u | %15I64u | %15.2lf | %15I64u | %13.2lf\n",
+            (unsigned int)iThread,
+            threadResults.ullSubmitCalls,
+            (threadResults.ullSubmitCalls > 0) ? (double)threadResults.ullSubmittedIOs / threadResults.ullSubmitCalls : 0.0,
+            threadResults.ullReapCalls,
+            (threadResults.ullReapCalls > 0) ? (double)threadResults.ullReapedIOs / threadResults.ullReapCalls : 0.0);
+        _Print("%s", szFloatBuffer);
+
+        ullSubmitCalls += threadResults.ullSubmitCalls;
+        ullSubmittedIOs += threadResults.ullSubmittedIOs;
+        ullReapCalls += threadResults.ullReapCalls;
+        ullReapedIOs += threadResults.ullReapedIOs;
+    }
+
+    _Print("---------------------------------------------------------------------------\n");
+
+    sprintf_s(szFloatBuffer, sizeof(szFloatBuffer), "total: | %15I64u | %15.2lf | %15I64u | %13.2lf\n",
+        ullSubmitCalls,
+        (ullSubmitCalls > 0) ? (double)ullSubmittedIOs / ullSubmitCalls : 0.0,
+        ullReapCalls,
+        (ullReapCalls > 0) ? (double)ullReapedIOs / ullReapCalls : 0.0);
+    _Print("%s", szFloatBuffer);
+}
+
 void ResultParser::_PrintSectionFieldNames(const TimeSpan& timeSpan)
 {
     _Print("thread |       bytes     |     I/Os     |    MiB/s   |  I/O per s %s%s%s|  file\n",
@@ -634,6 +913,61 @@ void ResultParser::_PrintSection(_SectionEnum section, const TimeSpan& timeSpan,
                 }
             }
 
+            if ((section == _SectionEnum::TRIM) || (section == _SectionEnum::TOTAL))
+            {
+                ullBytesCount += targetResults.ullTrimBytesCount;
+                ullIOCount += targetResults.ullTrimIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    latencyHistogram.Merge(targetResults.trimLatencyHistogram);
+                    totalLatencyHistogram.Merge(targetResults.trimLatencyHistogram);
+                }
+
+                if (timeSpan.GetCalculateIopsStdDev())
+                {
+                    ioBucketizer.Merge(targetResults.trimBucketizer);
+                    totalIoBucketizer.Merge(targetResults.trimBucketizer);
+                }
+            }
+
+            // durable writes are a subset of the writes, so they only have a section of their own
+            if (section == _SectionEnum::DURABLE_WRITE)
+            {
+                ullBytesCount += targetResults.ullDurableWriteBytesCount;
+                ullIOCount += targetResults.ullDurableWriteIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    latencyHistogram.Merge(targetResults.durableWriteLatencyHistogram);
+                    totalLatencyHistogram.Merge(targetResults.durableWriteLatencyHistogram);
+                }
+
+                if (timeSpan.GetCalculateIopsStdDev())
+                {
+                    ioBucketizer.Merge(targetResults.durableWriteBucketizer);
+                    totalIoBucketizer.Merge(targetResults.durableWriteBucketizer);
+                }
+            }
+
+            if ((section == _SectionEnum::WRITE_ZEROES) || (section == _SectionEnum::TOTAL))
+            {
+                ullBytesCount += targetResults.ullWriteZeroesBytesCount;
+                ullIOCount += targetResults.ullWriteZeroesIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    latencyHistogram.Merge(targetResults.writeZeroesLatencyHistogram);
+                    totalLatencyHistogram.Merge(targetResults.writeZeroesLatencyHistogram);
+                }
+
+                if (timeSpan.GetCalculateIopsStdDev())
+                {
+                    ioBucketizer.Merge(targetResults.writeZeroesBucketizer);
+                    totalIoBucketizer.Merge(targetResults.writeZeroesBucketizer);
+                }
+            }
+
             _Print("%6u | %15llu | %12llu | %10.2f | %10.2f",
                    iThread,
                    ullBytesCount,
@@ -718,6 +1052,224 @@ void ResultParser::_PrintSection(_SectionEnum section, const TimeSpan& timeSpan,
     _Print("\n");
 }
 
+void ResultParser::_PrintFlushes(const TimeSpan& timeSpan, const Results& results)
+{
+    double fTime = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+    UINT64 ullTotalFlushCount = 0;
+    Histogram<float> totalLatencyHistogram;
+
+    _Print("thread |    flushes   | flushes per s %s|  file\n",
+           timeSpan.GetMeasureLatency() ? "|  AvgLat  | LatStdDev " : "");
+    _Print("-----------------------------------%s------------\n",
+           timeSpan.GetMeasureLatency() ? "-----------------------" : "");
+
+    for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+    {
+        const ThreadResults& threadResults = results.vThreadResults[iThread];
+        for (const auto& targetResults : threadResults.vTargetResults)
+        {
+            _Print("%6u | %12llu | %13.2f",
+                   iThread,
+                   targetResults.ullFlushCount,
+                   (double)targetResults.ullFlushCount / fTime);
+
+            if (timeSpan.GetMeasureLatency())
+            {
+                if (targetResults.flushLatencyHistogram.GetSampleSize() > 0)
+                {
+                    _Print(" | %8.3f |  %8.3f",
+                           targetResults.flushLatencyHistogram.GetAvg() / 1000,
+                           targetResults.flushLatencyHistogram.GetStandardDeviation() / 1000);
+                }
+                else
+                {
+                    _Print(" |      N/A |       N/A");
+                }
+                totalLatencyHistogram.Merge(targetResults.flushLatencyHistogram);
+            }
+
+            _Print(" | %s (", targetResults.sPath.c_str());
+            _DisplayFileSize(targetResults.ullFileSize);
+            _Print(")\n");
+
+            ullTotalFlushCount += targetResults.ullFlushCount;
+        }
+    }
+
+    _Print("-----------------------------------%s------------\n",
+           timeSpan.GetMeasureLatency() ? "-----------------------" : "");
+
+    _Print("total:   %12llu | %13.2f",
+           ullTotalFlushCount,
+           (double)ullTotalFlushCount / fTime);
+
+    if (timeSpan.GetMeasureLatency())
+    {
+        if (totalLatencyHistogram.GetSampleSize() > 0)
+        {
+            _Print(" | %8.3f |  %8.3f",
+                   totalLatencyHistogram.GetAvg() / 1000,
+                   totalLatencyHistogram.GetStandardDeviation() / 1000);
+        }
+        else
+        {
+            _Print(" |      N/A |       N/A");
+        }
+    }
+
+    _Print("\n");
+}
+
+void ResultParser::_PrintCommits(const TimeSpan& timeSpan, const Results& results)
+{
+    double fTime = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+    UINT64 ullTotalCommitCount = 0;
+    UINT64 ullTotalGroupCount = 0;
+    Histogram<float> totalLatencyHistogram;
+
+    _Print("thread |    commits   | commits per s |    groups    | records per group %s|  file\n",
+           timeSpan.GetMeasureLatency() ? "|  AvgLat  | LatStdDev " : "");
+    _Print("----------------------------------------------------------------------%s------------\n",
+           timeSpan.GetMeasureLatency() ? "-----------------------" : "");
+
+    for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+    {
+        const ThreadResults& threadResults = results.vThreadResults[iThread];
+        for (const auto& targetResults : threadResults.vTargetResults)
+        {
+            _Print("%6u | %12llu | %13.2f | %12llu | %17.2f",
+                   iThread,
+                   targetResults.ullCommitCount,
+                   (double)targetResults.ullCommitCount / fTime,
+                   targetResults.ullCommitGroupCount,
+                   targetResults.ullCommitGroupCount != 0 ? (double)targetResults.ullCommitCount / targetResults.ullCommitGroupCount : 0.0);
+
+            if (timeSpan.GetMeasureLatency())
+            {
+                if (targetResults.commitLatencyHistogram.GetSampleSize() > 0)
+                {
+                    _Print(" | %8.3f |  %8.3f",
+                           targetResults.commitLatencyHistogram.GetAvg() / 1000,
+                           targetResults.commitLatencyHistogram.GetStandardDeviation() / 1000);
+                }
+                else
+                {
+                    _Print(" |      N/A |       N/A");
+                }
+                totalLatencyHistogram.Merge(targetResults.commitLatencyHistogram);
+            }
+
+            _Print(" | %s (", targetResults.sPath.c_str());
+            _DisplayFileSize(targetResults.ullFileSize);
+            _Print(")\n");
+
+            ullTotalCommitCount += targetResults.ullCommitCount;
+            ullTotalGroupCount += targetResults.ullCommitGroupCount;
+        }
+    }
+
+    _Print("----------------------------------------------------------------------%s------------\n",
+           timeSpan.GetMeasureLatency() ? "-----------------------" : "");
+
+    _Print("total:   %12llu | %13.2f | %12llu | %17.2f",
+           ullTotalCommitCount,
+           (double)ullTotalCommitCount / fTime,
+           ullTotalGroupCount,
+           ullTotalGroupCount != 0 ? (double)ullTotalCommitCount / ullTotalGroupCount : 0.0);
+
+    if (timeSpan.GetMeasureLatency())
+    {
+        if (totalLatencyHistogram.GetSampleSize() > 0)
+        {
+            _Print(" | %8.3f |  %8.3f",
+                   totalLatencyHistogram.GetAvg() / 1000,
+                   totalLatencyHistogram.GetStandardDeviation() / 1000);
+        }
+        else
+        {
+            _Print(" |      N/A |       N/A");
+        }
+    }
+
+    _Print("\n");
+}
+
+void ResultParser::_PrintMetadataOperations(const TimeSpan& timeSpan, const Results& results)
+{
+    double fTime = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+    vector<UINT64> vullTotalCounts(METADATA_OPERATION_COUNT, 0);
+    vector<Histogram<float>> vTotalLatencyHistograms(METADATA_OPERATION_COUNT);
+
+    _Print("thread | operation |  operations  | operations per s %s|  file\n",
+           timeSpan.GetMeasureLatency() ? "|  AvgLat  | LatStdDev " : "");
+    _Print("-------------------------------------------------------%s------------\n",
+           timeSpan.GetMeasureLatency() ? "-----------------------" : "");
+
+    for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+    {
+        const ThreadResults& threadResults = results.vThreadResults[iThread];
+        for (const auto& targetResults : threadResults.vTargetResults)
+        {
+            for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+            {
+                const Histogram<float>& latencyHistogram = targetResults.vMetadataLatencyHistograms[i];
+
+                _Print("%6u | %9s | %12llu | %16.2f",
+                       iThread,
+                       MetadataTree::GetOperationName(static_cast<MetadataOperation>(i)),
+                       targetResults.vullMetadataOperationCounts[i],
+                       (double)targetResults.vullMetadataOperationCounts[i] / fTime);
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    if (latencyHistogram.GetSampleSize() > 0)
+                    {
+                        _Print(" | %8.3f |  %8.3f",
+                               latencyHistogram.GetAvg() / 1000,
+                               latencyHistogram.GetStandardDeviation() / 1000);
+                    }
+                    else
+                    {
+                        _Print(" |      N/A |       N/A");
+                    }
+                    vTotalLatencyHistograms[i].Merge(latencyHistogram);
+                }
+
+                _Print(" | %s\n", targetResults.sPath.c_str());
+
+                vullTotalCounts[i] += targetResults.vullMetadataOperationCounts[i];
+            }
+        }
+    }
+
+    _Print("-------------------------------------------------------%s------------\n",
+           timeSpan.GetMeasureLatency() ? "-----------------------" : "");
+
+    for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+    {
+        _Print("total: | %9s | %12llu | %16.2f",
+               MetadataTree::GetOperationName(static_cast<MetadataOperation>(i)),
+               vullTotalCounts[i],
+               (double)vullTotalCounts[i] / fTime);
+
+        if (timeSpan.GetMeasureLatency())
+        {
+            if (vTotalLatencyHistograms[i].GetSampleSize() > 0)
+            {
+                _Print(" | %8.3f |  %8.3f",
+                       vTotalLatencyHistograms[i].GetAvg() / 1000,
+                       vTotalLatencyHistograms[i].GetStandardDeviation() / 1000);
+            }
+            else
+            {
+                _Print(" |      N/A |       N/A");
+            }
+        }
+
+        _Print("\n");
+    }
+}
+
 void ResultParser::_PrintLatencyPercentiles(const Results& results)
 {
     //Print one chart for each target IF more than one target
@@ -737,6 +1289,8 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
 
             perTargetTotalHistogram[path].Merge(target.readLatencyHistogram);
             perTargetTotalHistogram[path].Merge(target.writeLatencyHistogram);
+            perTargetTotalHistogram[path].Merge(target.trimLatencyHistogram);
+            perTargetTotalHistogram[path].Merge(target.writeZeroesLatencyHistogram);
         }
     }
 
@@ -755,6 +1309,8 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
     //Print one chart for the latencies aggregated across all targets
     Histogram<float> readLatencyHistogram;
     Histogram<float> writeLatencyHistogram;
+    Histogram<float> trimLatencyHistogram;
+    Histogram<float> writeZeroesLatencyHistogram;
     Histogram<float> totalLatencyHistogram;
 
     for (const auto& thread : results.vThreadResults)
@@ -765,23 +1321,149 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
 
             writeLatencyHistogram.Merge(target.writeLatencyHistogram);
 
+            trimLatencyHistogram.Merge(target.trimLatencyHistogram);
+
+            writeZeroesLatencyHistogram.Merge(target.writeZeroesLatencyHistogram);
+
             totalLatencyHistogram.Merge(target.writeLatencyHistogram);
             totalLatencyHistogram.Merge(target.readLatencyHistogram);
+            totalLatencyHistogram.Merge(target.trimLatencyHistogram);
+            totalLatencyHistogram.Merge(target.writeZeroesLatencyHistogram);
         }
     }
 
     _Print("\ntotal:\n");
     _PrintLatencyChart(readLatencyHistogram, writeLatencyHistogram, totalLatencyHistogram);
+
+    //Print one chart for trims and write-zeroes, which have no data to compare with reads and writes
+    if (trimLatencyHistogram.GetSampleSize() > 0 || writeZeroesLatencyHistogram.GetSampleSize() > 0)
+    {
+        Histogram<float> trimAndWriteZeroesLatencyHistogram;
+        trimAndWriteZeroesLatencyHistogram.Merge(trimLatencyHistogram);
+        trimAndWriteZeroesLatencyHistogram.Merge(writeZeroesLatencyHistogram);
+
+        _Print("\ntrim and write zeroes:\n");
+        _PrintLatencyChart(trimLatencyHistogram, writeZeroesLatencyHistogram, trimAndWriteZeroesLatencyHistogram, "Trim", "Zero");
+    }
+
+    //Print one chart for durable writes and flushes, which tell the cost of durability
+    Histogram<float> durableWriteLatencyHistogram;
+    Histogram<float> flushLatencyHistogram;
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            durableWriteLatencyHistogram.Merge(target.durableWriteLatencyHistogram);
+            flushLatencyHistogram.Merge(target.flushLatencyHistogram);
+        }
+    }
+
+    if (durableWriteLatencyHistogram.GetSampleSize() > 0 || flushLatencyHistogram.GetSampleSize() > 0)
+    {
+        Histogram<float> durabilityLatencyHistogram;
+        durabilityLatencyHistogram.Merge(durableWriteLatencyHistogram);
+        durabilityLatencyHistogram.Merge(flushLatencyHistogram);
+
+        _Print("\ndurable writes and flushes:\n");
+        _PrintLatencyChart(durableWriteLatencyHistogram, flushLatencyHistogram, durabilityLatencyHistogram, "Write", "Flush");
+    }
+
+    //Print one chart for group commits: the device latency of the group writes and their flushes,
+    //and the commit latency the committers saw, which also includes the wait in the queue
+    Histogram<float> groupWriteLatencyHistogram;
+    Histogram<float> groupFlushLatencyHistogram;
+    Histogram<float> commitLatencyHistogram;
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            if (target.commitLatencyHistogram.GetSampleSize() > 0)
+            {
+                groupWriteLatencyHistogram.Merge(target.writeLatencyHistogram);
+                groupFlushLatencyHistogram.Merge(target.flushLatencyHistogram);
+                commitLatencyHistogram.Merge(target.commitLatencyHistogram);
+            }
+        }
+    }
+
+    if (commitLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("\ngroup commits (total is the commit latency):\n");
+        _PrintLatencyChart(groupWriteLatencyHistogram, groupFlushLatencyHistogram, commitLatencyHistogram, "Write", "Flush");
+    }
+
+    //Print one chart for metadata operations, with a column per kind of operation
+    vector<Histogram<float>> vMetadataLatencyHistograms(METADATA_OPERATION_COUNT);
+    bool fMetadata = false;
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+            {
+                vMetadataLatencyHistograms[i].Merge(target.vMetadataLatencyHistograms[i]);
+                fMetadata = fMetadata || (target.vMetadataLatencyHistograms[i].GetSampleSize() > 0);
+            }
+        }
+    }
+
+    if (fMetadata)
+    {
+        _Print("\nmetadata operations:\n");
+        _PrintMetadataLatencyChart(vMetadataLatencyHistograms);
+    }
+
+    //Print one chart per block size if any target used a block size distribution
+    map<DWORD, Histogram<float>> perBlockSizeReadHistogram;
+    map<DWORD, Histogram<float>> perBlockSizeWriteHistogram;
+    map<DWORD, Histogram<float>> perBlockSizeTotalHistogram;
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            for (size_t i = 0; i < target.vBlockSizes.size(); i++)
+            {
+                DWORD dwBlockSize = target.vBlockSizes[i];
+
+                perBlockSizeReadHistogram[dwBlockSize].Merge(target.vReadBlockSizeLatencyHistograms[i]);
+
+                perBlockSizeWriteHistogram[dwBlockSize].Merge(target.vWriteBlockSizeLatencyHistograms[i]);
+
+                perBlockSizeTotalHistogram[dwBlockSize].Merge(target.vReadBlockSizeLatencyHistograms[i]);
+                perBlockSizeTotalHistogram[dwBlockSize].Merge(target.vWriteBlockSizeLatencyHistograms[i]);
+            }
+        }
+    }
+
+    for (const auto& i : perBlockSizeTotalHistogram)
+    {
+        // skip size classes which never completed an IO
+        if (i.second.GetSampleSize() == 0)
+        {
+            continue;
+        }
+
+        _Print("\nblock size %u:\n", i.first);
+        _PrintLatencyChart(perBlockSizeReadHistogram[i.first],
+            perBlockSizeWriteHistogram[i.first],
+            i.second);
+    }
 }
 
 void ResultParser::_PrintLatencyChart(const Histogram<float>& readLatencyHistogram,
     const Histogram<float>& writeLatencyHistogram,
-    const Histogram<float>& totalLatencyHistogram)
+    const Histogram<float>& totalLatencyHistogram,
+    const char *pszReadName,
+    const char *pszWriteName)
 {
     bool fHasReads = readLatencyHistogram.GetSampleSize() > 0;
     bool fHasWrites = writeLatencyHistogram.GetSampleSize() > 0;
 
-    _Print("  %%-ile |  Read (ms) | Write (ms) | Total (ms)\n");
+    _Print("  %%-ile | %5s (ms) | %5s (ms) | Total (ms)\n", pszReadName, pszWriteName);
     _Print("----------------------------------------------\n");
 
     string readMin =
@@ -841,8 +1523,56 @@ void ResultParser::_PrintLatencyChart(const Histogram<float>& readLatencyHistogr
            fHasWrites ? writeMax.c_str() : "N/A",
            totalLatencyHistogram.GetMax()/1000);
 
-    _Print("Read latency histogram bins:  %d\n", readLatencyHistogram.GetBucketCount());
-    _Print("Write latency histogram bins: %d\n", writeLatencyHistogram.GetBucketCount());
+    // pad the shorter name so that the counts line up
+    int cchReadName = (int)strlen(pszReadName);
+    int cchWriteName = (int)strlen(pszWriteName);
+    _Print("%s latency histogram bins: %*s%d\n", pszReadName, (cchWriteName > cchReadName) ? cchWriteName - cchReadName : 0, "", readLatencyHistogram.GetBucketCount());
+    _Print("%s latency histogram bins: %*s%d\n", pszWriteName, (cchReadName > cchWriteName) ? cchReadName - cchWriteName : 0, "", writeLatencyHistogram.GetBucketCount());
+}
+
+void ResultParser::_PrintMetadataLatencyChart(const vector<Histogram<float>>& vLatencyHistograms)
+{
+    _Print("  %%-ile |");
+    for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+    {
+        _Print(" %6s (ms) |", MetadataTree::GetOperationName(static_cast<MetadataOperation>(i)));
+    }
+    _Print("\n");
+    _Print("--------------------------------------------------------------------------------\n");
+
+    PercentileDescriptor percentiles[] =
+    {
+        {        0.0, "min"     },
+        {       0.25, "25th"    },
+        {       0.50, "50th"    },
+        {       0.75, "75th"    },
+        {       0.90, "90th"    },
+        {       0.95, "95th"    },
+        {       0.99, "99th"    },
+        {      0.999, "3-nines" },
+        {     0.9999, "4-nines" },
+        {    0.99999, "5-nines" },
+        {   0.999999, "6-nines" },
+        {        1.0, "max"     },
+    };
+
+    for (auto p : percentiles)
+    {
+        _Print("%7s |", p.Name.c_str());
+        for (const auto& latencyHistogram : vLatencyHistograms)
+        {
+            string sLatency = "N/A";
+            if (latencyHistogram.GetSampleSize() > 0)
+            {
+                double lfLatency = (p.Percentile == 0.0) ? latencyHistogram.GetMin() :
+                                   (p.Percentile == 1.0) ? latencyHistogram.GetMax() :
+                                   latencyHistogram.GetPercentile(p.Percentile);
+                sLatency = Util::DoubleToStringHelper(lfLatency / 1000);
+            }
+            _Print(" %11s |", sLatency.c_str());
+        }
+        _Print("\n");
+    }
 }
 
 void ResultParser::_PrintLatencyBuckets(const Results& results, ConstHistogramBucketListPtr histogramBucketList, double fTestDurationInSeconds)
@@ -864,6 +1594,8 @@ void ResultParser::_PrintLatencyBuckets(const Results& results, ConstHistogramBu
 
             perTargetTotalHistogram[path].Merge(target.readLatencyHistogram);
             perTargetTotalHistogram[path].Merge(target.writeLatencyHistogram);
+            perTargetTotalHistogram[path].Merge(target.trimLatencyHistogram);
+            perTargetTotalHistogram[path].Merge(target.writeZeroesLatencyHistogram);
         }
     }
 
@@ -895,6 +1627,8 @@ void ResultParser::_PrintLatencyBuckets(const Results& results, ConstHistogramBu
 
             totalLatencyHistogram.Merge(target.writeLatencyHistogram);
             totalLatencyHistogram.Merge(target.readLatencyHistogram);
+            totalLatencyHistogram.Merge(target.trimLatencyHistogram);
+            totalLatencyHistogram.Merge(target.writeZeroesLatencyHistogram);
         }
     }
 
@@ -987,6 +1721,32 @@ string ResultParser::ParseResults(Profile& profile, const SystemInformation& sys
             _Print("proc count:\t\t%u\n", ulProcCount);
             _PrintCpuUtilization(results, system);
 
+            if (timeSpan.GetPollCompletions() || timeSpan.GetWaitStrategy() != WaitStrategy::Undefined ||
+                timeSpan.GetSeparateReaper() || timeSpan.GetCompletionPoolThreadCount() > 0)
+            {
+                _PrintThreadCpuUtilization(results.vThreadResults, results.ullTimeCount, "worker threads", false);
+            }
+
+            if (timeSpan.GetIoRingSubmissionPoller())
+            {
+                _PrintThreadCpuUtilization(results.vThreadResults, results.ullTimeCount, "I/O ring submission pollers", true);
+            }
+
+            if (timeSpan.GetSeparateReaper())
+            {
+                _PrintThreadCpuUtilization(results.vThreadResults, results.ullTimeCount, "completion reapers", true);
+            }
+
+            if (timeSpan.GetCompletionPoolThreadCount() > 0)
+            {
+                _PrintThreadCpuUtilization(results.vCompletionPoolResults, results.ullTimeCount, "completion pool threads", false);
+            }
+
+            if (timeSpan.GetBatchSize() > 1)
+            {
+                _PrintBatching(results);
+            }
+
             _Print("\nTotal IO\n");
             _PrintSection(_SectionEnum::TOTAL, timeSpan, results);
 
@@ -996,6 +1756,60 @@ string ResultParser::ParseResults(Profile& profile, const SystemInformation& sys
             _Print("\nWrite IO\n");
             _PrintSection(_SectionEnum::WRITE, timeSpan, results);
 
+            bool fTrim = false;
+            bool fWriteZeroes = false;
+            for (const auto& target : timeSpan.GetTargets())
+            {
+                fTrim = fTrim || (target.GetTrimRatio() != 0);
+                fWriteZeroes = fWriteZeroes || (target.GetWriteZeroesRatio() != 0);
+            }
+
+            if (fTrim)
+            {
+                _Print("\nTrim IO\n");
+                _PrintSection(_SectionEnum::TRIM, timeSpan, results);
+            }
+
+            if (fWriteZeroes)
+            {
+                _Print("\nWrite Zeroes IO\n");
+                _PrintSection(_SectionEnum::WRITE_ZEROES, timeSpan, results);
+            }
+
+            bool fDurableWrites = false;
+            bool fFlushes = false;
+            bool fCommits = false;
+            for (const auto& target : timeSpan.GetTargets())
+            {
+                fDurableWrites = fDurableWrites || (target.GetDurableWriteRatio() != 0);
+                fFlushes = fFlushes || target.GetUseFlush() || target.GetUseGroupCommit();
+                fCommits = fCommits || target.GetUseGroupCommit();
+            }
+
+            if (fDurableWrites)
+            {
+                _Print("\nDurable Write IO (included in Write IO)\n");
+                _PrintSection(_SectionEnum::DURABLE_WRITE, timeSpan, results);
+            }
+
+            if (fFlushes)
+            {
+                _Print("\nFlushes\n");
+                _PrintFlushes(timeSpan, results);
+            }
+
+            if (fCommits)
+            {
+                _Print("\nCommits\n");
+                _PrintCommits(timeSpan, results);
+            }
+
+            if (timeSpan.GetTargets().size() > 0 && timeSpan.GetTargets()[0].GetUseMetadata())
+            {
+                _Print("\nMetadata Operations\n");
+                _PrintMetadataOperations(timeSpan, results);
+            }
+
             if (timeSpan.GetMeasureLatency())
             {
                 _Print("\n\n");
@@ -1030,6 +1844,10 @@ string ResultParser::ParseResults(Profile& profile, const SystemInformation& sys
         UINT64 cbTotalRead = 0;
         UINT64 cTotalWriteIO = 0;
         UINT64 cTotalReadIO = 0;
+        UINT64 cbTotalTrimmed = 0;
+        UINT64 cTotalTrimIO = 0;
+        UINT64 cbTotalZeroed = 0;
+        UINT64 cTotalWriteZeroesIO = 0;
         UINT64 cTotalTicks = 0;
         for (auto pResults = vResults.begin(); pResults != vResults.end(); pResults++)
         {
@@ -1046,6 +1864,10 @@ string ResultParser::ParseResults(Profile& profile, const SystemInformation& sys
                         cbTotalWritten += pTargetResults->ullWriteBytesCount;
                         cTotalReadIO += pTargetResults->ullReadIOCount;
                         cTotalWriteIO += pTargetResults->ullWriteIOCount;
+                        cbTotalTrimmed += pTargetResults->ullTrimBytesCount;
+                        cTotalTrimIO += pTargetResults->ullTrimIOCount;
+                        cbTotalZeroed += pTargetResults->ullWriteZeroesBytesCount;
+                        cTotalWriteZeroesIO += pTargetResults->ullWriteZeroesIOCount;
                     }
                 }
             }
@@ -1064,12 +1886,33 @@ string ResultParser::ParseResults(Profile& profile, const SystemInformation& sys
                cTotalReadIO,
                (double)cbTotalRead / 1024 / 1024 / totalTime,
                (double)cTotalReadIO / totalTime);
+
+        if (cTotalTrimIO != 0)
+        {
+            _Print("trim   | %15I64u | %12I64u | %10.2lf | %10.2lf\n",
+                   cbTotalTrimmed,
+                   cTotalTrimIO,
+                   (double)cbTotalTrimmed / 1024 / 1024 / totalTime,
+                   (double)cTotalTrimIO / totalTime);
+        }
+
+        if (cTotalWriteZeroesIO != 0)
+        {
+            _Print("zero   | %15I64u | %12I64u | %10.2lf | %10.2lf\n",
+                   cbTotalZeroed,
+                   cTotalWriteZeroesIO,
+                   (double)cbTotalZeroed / 1024 / 1024 / totalTime,
+                   (double)cTotalWriteZeroesIO / totalTime);
+        }
+
+        UINT64 cbTotal = cbTotalRead + cbTotalWritten + cbTotalTrimmed + cbTotalZeroed;
+        UINT64 cTotalIO = cTotalReadIO + cTotalWriteIO + cTotalTrimIO + cTotalWriteZeroesIO;
         _Print("-------------------------------------------------------------------------------\n");
         _Print("total  | %15I64u | %12I64u | %10.2lf | %10.2lf\n\n",
-               cbTotalRead + cbTotalWritten,
-               cTotalReadIO + cTotalWriteIO,
-               (double)(cbTotalRead + cbTotalWritten) / 1024 / 1024 / totalTime,
-               (double)(cTotalReadIO + cTotalWriteIO) / totalTime);
+               cbTotal,
+               cTotalIO,
+               (double)cbTotal / 1024 / 1024 / totalTime,
+               (double)cTotalIO / totalTime);
 
         _Print("total test time:\t%.2lfs\n", totalTime);
     }
@@ -567,6 +567,784 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
+    void CmdLineParserUnitTests::TestParseCmdLineBlockSizeDistribution()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b8K", "-bd4K:60,64K:30,1M:10", "-w30", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b8K -bd4K:60,64K:30,1M:10 -w30 testfile.dat") == 0);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            vector<Target> vTargets(vSpans[0].GetTargets());
+            VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+            Target t(vTargets[0]);
+
+            VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(8 * 1024));
+            VERIFY_ARE_EQUAL(t.GetMaxBlockSizeInBytes(), (DWORD)(1024 * 1024));
+            for (auto ioType : { IOOperation::ReadIO, IOOperation::WriteIO })
+            {
+                const auto& vBlockSizes = t.GetBlockSizeWeights(ioType);
+                VERIFY_ARE_EQUAL(vBlockSizes.size(), (size_t)3);
+                VERIFY_ARE_EQUAL(vBlockSizes[0].dwBlockSize, (DWORD)(4 * 1024));
+                VERIFY_ARE_EQUAL(vBlockSizes[0].ulWeight, (UINT32)60);
+                VERIFY_ARE_EQUAL(vBlockSizes[1].dwBlockSize, (DWORD)(64 * 1024));
+                VERIFY_ARE_EQUAL(vBlockSizes[1].ulWeight, (UINT32)30);
+                VERIFY_ARE_EQUAL(vBlockSizes[2].dwBlockSize, (DWORD)(1024 * 1024));
+                VERIFY_ARE_EQUAL(vBlockSizes[2].ulWeight, (UINT32)10);
+            }
+        }
+
+        {
+            // separate read and write distributions, sizes stated in blocks
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-bdr1b:1,2b:3", "-bdw16K:1", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+
+            VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(4 * 1024));
+            const auto& vReadBlockSizes = t.GetBlockSizeWeights(IOOperation::ReadIO);
+            VERIFY_ARE_EQUAL(vReadBlockSizes.size(), (size_t)2);
+            VERIFY_ARE_EQUAL(vReadBlockSizes[0].dwBlockSize, (DWORD)(4 * 1024));
+            VERIFY_ARE_EQUAL(vReadBlockSizes[1].dwBlockSize, (DWORD)(8 * 1024));
+            VERIFY_ARE_EQUAL(vReadBlockSizes[1].ulWeight, (UINT32)3);
+            const auto& vWriteBlockSizes = t.GetBlockSizeWeights(IOOperation::WriteIO);
+            VERIFY_ARE_EQUAL(vWriteBlockSizes.size(), (size_t)1);
+            VERIFY_ARE_EQUAL(vWriteBlockSizes[0].dwBlockSize, (DWORD)(16 * 1024));
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-bd4K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-bd4K:60,", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineRandomDistribution()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdpct90/10:5/20", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseRandomAccessPattern());
+            VERIFY_IS_TRUE(t.GetRandomDistribution() == DistributionType::Percent);
+            const auto& vRanges = t.GetDistributionRanges();
+            VERIFY_ARE_EQUAL(vRanges.size(), (size_t)2);
+            VERIFY_ARE_EQUAL(vRanges[0].ulIoPercent, (UINT32)90);
+            VERIFY_ARE_EQUAL(vRanges[0].ulTargetPercent, (UINT32)10);
+            VERIFY_ARE_EQUAL(vRanges[1].ulIoPercent, (UINT32)5);
+            VERIFY_ARE_EQUAL(vRanges[1].ulTargetPercent, (UINT32)20);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdzipf0.99", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetRandomDistribution() == DistributionType::Zipf);
+            VERIFY_ARE_EQUAL(t.GetZipfTheta(), 0.99);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdpareto20", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetRandomDistribution() == DistributionType::Pareto);
+            VERIFY_ARE_EQUAL(t.GetParetoHotPercent(), (UINT32)20);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdnormal50/2.5", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetRandomDistribution() == DistributionType::Normal);
+            VERIFY_ARE_EQUAL(t.GetNormalCenterPercent(), 50.0);
+            VERIFY_ARE_EQUAL(t.GetNormalStdDevPercent(), 2.5);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdabs90/1G:5/10G", "-rdmove64M", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetRandomDistribution() == DistributionType::Absolute);
+            const auto& vRanges = t.GetDistributionRanges();
+            VERIFY_ARE_EQUAL(vRanges.size(), (size_t)2);
+            VERIFY_ARE_EQUAL(vRanges[0].ulIoPercent, (UINT32)90);
+            VERIFY_ARE_EQUAL(vRanges[0].ullTargetBytes, (UINT64)1024 * 1024 * 1024);
+            VERIFY_ARE_EQUAL(vRanges[1].ulIoPercent, (UINT32)5);
+            VERIFY_ARE_EQUAL(vRanges[1].ullTargetBytes, (UINT64)10 * 1024 * 1024 * 1024);
+            VERIFY_ARE_EQUAL(t.GetDistributionDrift(), (UINT64)64 * 1024 * 1024);
+            VERIFY_IS_TRUE(t.GetXml().find("<Distribution>\n<Absolute>\n<Range IO=\"90\">1073741824</Range>\n"
+                                           "<Range IO=\"5\">10737418240</Range>\n</Absolute>\n"
+                                           "<Drift>67108864</Drift>\n</Distribution>\n") != string::npos);
+            VERIFY_IS_TRUE(profile.Validate(true));
+        }
+
+        {
+            // drift needs something to move
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdmove64M", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_FALSE(profile.Validate(true));
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdabs90/:10/1G", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdpct90", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rdlognormal1", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineRandomPermutation()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rp", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseRandomAccessPattern());
+            VERIFY_IS_TRUE(t.GetUseRandomPermutation());
+            VERIFY_IS_TRUE(t.GetXml().find("<RandomPermutation>true</RandomPermutation>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseRandomPermutation());
+            VERIFY_IS_TRUE(t.GetXml().find("<RandomPermutation>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-rpx", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineAccessPatternPlugin()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-Atrace.dll,replay.csv,loop", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseAccessPatternPlugin());
+            VERIFY_IS_TRUE(t.GetAccessPatternPlugin().compare("trace.dll") == 0);
+            VERIFY_IS_TRUE(t.GetAccessPatternParameters().compare("replay.csv,loop") == 0);
+            VERIFY_IS_TRUE(t.GetXml().find("<AccessPattern>\n<Plugin>trace.dll</Plugin>\n<Parameters>replay.csv,loop</Parameters>\n</AccessPattern>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-Ac:\\plugins\\hotspot.dll", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetAccessPatternPlugin().compare("c:\\plugins\\hotspot.dll") == 0);
+            VERIFY_IS_TRUE(t.GetAccessPatternParameters().empty());
+            VERIFY_IS_TRUE(t.GetXml().find("<Parameters>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseAccessPatternPlugin());
+            VERIFY_IS_TRUE(t.GetXml().find("<AccessPattern>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-A,params", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // the plugin replaces the random pattern
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-Atrace.dll", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineTrimAndWriteZeroes()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w30", "-wt20", "-wz10", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)30);
+            VERIFY_ARE_EQUAL(t.GetTrimRatio(), (UINT32)20);
+            VERIFY_ARE_EQUAL(t.GetWriteZeroesRatio(), (UINT32)10);
+            VERIFY_ARE_EQUAL(t.GetModifyRatio(), (UINT32)60);
+            VERIFY_IS_TRUE(t.GetXml().find("<WriteRatio>30</WriteRatio>\n<TrimRatio>20</TrimRatio>\n<WriteZeroesRatio>10</WriteZeroesRatio>\n") != string::npos);
+        }
+
+        {
+            // trims alone leave the write ratio alone
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-wt100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)0);
+            VERIFY_ARE_EQUAL(t.GetTrimRatio(), (UINT32)100);
+            VERIFY_ARE_EQUAL(t.GetWriteZeroesRatio(), (UINT32)0);
+            VERIFY_IS_TRUE(t.GetXml().find("<WriteZeroesRatio>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetTrimRatio(), (UINT32)0);
+            VERIFY_ARE_EQUAL(t.GetWriteZeroesRatio(), (UINT32)0);
+            VERIFY_IS_TRUE(t.GetXml().find("<TrimRatio>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-wt", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-wz101", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // together with the writes, more than all of the IO
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w60", "-wt30", "-wz20", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineFlushAndDurableWrites()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w50", "-wd10", "-wf32", "-wfd", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)50);
+            VERIFY_ARE_EQUAL(t.GetDurableWriteRatio(), (UINT32)10);
+            VERIFY_ARE_EQUAL(t.GetFlushIoInterval(), (UINT32)32);
+            VERIFY_ARE_EQUAL(t.GetFlushTimeIntervalInMilliseconds(), (UINT32)0);
+            VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)0);
+            VERIFY_IS_TRUE(t.GetFlushDataOnly());
+            VERIFY_IS_TRUE(t.GetXml().find("<DurableWriteRatio>10</DurableWriteRatio>\n<Flush>\n<IoInterval>32</IoInterval>\n<DataOnly>true</DataOnly>\n</Flush>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wft250", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetFlushTimeIntervalInMilliseconds(), (UINT32)250);
+            VERIFY_IS_FALSE(t.GetFlushDataOnly());
+            VERIFY_IS_TRUE(t.GetXml().find("<Flush>\n<TimeInterval>250</TimeInterval>\n</Flush>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w20", "-wfp5", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)5);
+            VERIFY_IS_TRUE(t.GetXml().find("<DurableWriteRatio>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseFlush());
+            VERIFY_ARE_EQUAL(t.GetDurableWriteRatio(), (UINT32)0);
+            VERIFY_IS_TRUE(t.GetXml().find("<Flush>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w10", "-wf0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w10", "-wfp101", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // only one way of scheduling the flushes
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w10", "-wf8", "-wft100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // flushes of a target which is only read
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-wf8", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineAppend()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b64K", "-w100", "-wa", "-wap1M", "-was16b", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseAppend());
+            VERIFY_ARE_EQUAL(t.GetAppendPreallocationSizeInBytes(), (UINT64)1024 * 1024);
+            VERIFY_ARE_EQUAL(t.GetAppendSegmentSizeInBytes(), (UINT64)16 * 64 * 1024);
+            VERIFY_IS_TRUE(t.GetXml().find("<Append>true</Append>\n<AppendPreallocationSize>1048576</AppendPreallocationSize>\n<AppendSegmentSize>1048576</AppendSegmentSize>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseAppend());
+            VERIFY_IS_TRUE(t.GetXml().find("<Append") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wa", "-wap", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wax", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // the tail is not a random offset
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wa", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // segment sizes without append
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-was1G", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineGroupCommit()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b64K", "-w100", "-wa", "-wg32", "-wgr512", "-wgt250", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseGroupCommit());
+            VERIFY_ARE_EQUAL(t.GetCommitterCount(), (UINT32)32);
+            VERIFY_ARE_EQUAL(t.GetCommitRecordSizeInBytes(), (DWORD)512);
+            VERIFY_ARE_EQUAL(t.GetCommitThinkTimeInMicroseconds(), (UINT32)250);
+            VERIFY_IS_TRUE(t.GetXml().find("<GroupCommit>\n<Committers>32</Committers>\n<RecordSize>512</RecordSize>\n<ThinkTime>250</ThinkTime>\n</GroupCommit>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wg4", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetCommitRecordSizeInBytes(), (DWORD)4096);
+            VERIFY_ARE_EQUAL(t.GetCommitThinkTimeInMicroseconds(), (UINT32)0);
+            VERIFY_IS_TRUE(t.GetXml().find("<ThinkTime>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseGroupCommit());
+            VERIFY_IS_TRUE(t.GetXml().find("<GroupCommit") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wg0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // a group is at most a block of records
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-w100", "-wg8", "-wgr8K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // think time without committers
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-w100", "-wgt100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineMetadata()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-M", "-Mf2", "-Md3", "-Mn10", "-Mw1:2:3:4:5", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseMetadata());
+            VERIFY_ARE_EQUAL(t.GetMetadataFanout(), (UINT32)2);
+            VERIFY_ARE_EQUAL(t.GetMetadataDepth(), (UINT32)3);
+            VERIFY_ARE_EQUAL(t.GetMetadataFilesPerDirectory(), (UINT32)10);
+            VERIFY_ARE_EQUAL(t.GetMetadataFileCount(), (UINT32)80);
+            VERIFY_ARE_EQUAL(t.GetMetadataWeight(MetadataOperation::Create), (UINT32)1);
+            VERIFY_ARE_EQUAL(t.GetMetadataWeight(MetadataOperation::Open), (UINT32)2);
+            VERIFY_ARE_EQUAL(t.GetMetadataWeight(MetadataOperation::Stat), (UINT32)3);
+            VERIFY_ARE_EQUAL(t.GetMetadataWeight(MetadataOperation::Rename), (UINT32)4);
+            VERIFY_ARE_EQUAL(t.GetMetadataWeight(MetadataOperation::Unlink), (UINT32)5);
+            VERIFY_IS_TRUE(t.GetXml().find("<Metadata>true</Metadata>\n<MetadataFanout>2</MetadataFanout>\n<MetadataDepth>3</MetadataDepth>\n<MetadataFilesPerDirectory>10</MetadataFilesPerDirectory>\n") != string::npos);
+            VERIFY_IS_TRUE(t.GetXml().find("<MetadataWeights>\n<Create>1</Create>\n<Open>2</Open>\n<Stat>3</Stat>\n<Rename>4</Rename>\n<Unlink>5</Unlink>\n</MetadataWeights>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseMetadata());
+            VERIFY_IS_TRUE(t.GetXml().find("<Metadata") == string::npos);
+        }
+
+        {
+            // all five weights are required
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-M", "-Mw1:2:3", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-M", "-Mfx", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // metadata workloads issue no data I/O
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-M", "-w50", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineRandomRatio()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b8K", "-rs30", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetUseRandomAccessPattern());
+            VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), (UINT64)8192);
+            VERIFY_ARE_EQUAL(t.GetRandomRatio(), (UINT32)30);
+            VERIFY_ARE_EQUAL(t.GetMinSequentialRun(), (UINT32)1);
+            VERIFY_ARE_EQUAL(t.GetMaxSequentialRun(), (UINT32)1);
+            VERIFY_IS_TRUE(t.GetXml().find("<RandomRatio>30</RandomRatio>\n") != string::npos);
+            VERIFY_IS_TRUE(t.GetXml().find("<SequentialRunLength>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r4K", "-rs20:8-64", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), (UINT64)4096);
+            VERIFY_ARE_EQUAL(t.GetRandomRatio(), (UINT32)20);
+            VERIFY_ARE_EQUAL(t.GetMinSequentialRun(), (UINT32)8);
+            VERIFY_ARE_EQUAL(t.GetMaxSequentialRun(), (UINT32)64);
+            VERIFY_IS_TRUE(t.GetXml().find("<SequentialRunLength>\n<Min>8</Min>\n<Max>64</Max>\n</SequentialRunLength>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-rs20:", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // out of range percentages fail validation
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-rs0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_FALSE(profile.Validate(true));
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineSequentialStreams()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-s64K", "-sn4", "-sr", "-sk4/12", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), (UINT64)64 * 1024);
+            VERIFY_IS_TRUE(t.GetUseSequentialStreams());
+            VERIFY_ARE_EQUAL(t.GetSequentialStreamCount(), (UINT32)4);
+            VERIFY_IS_TRUE(t.GetUseReverseSequential());
+            VERIFY_ARE_EQUAL(t.GetSequentialReadRun(), (UINT32)4);
+            VERIFY_ARE_EQUAL(t.GetSequentialSkipRun(), (UINT32)12);
+            VERIFY_IS_TRUE(t.GetXml().find("<SequentialStreams>4</SequentialStreams>\n"
+                                           "<ReverseSequential>true</ReverseSequential>\n"
+                                           "<SequentialSkip>\n<Read>4</Read>\n<Skip>12</Skip>\n</SequentialSkip>\n") != string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-s", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            Target t(vSpans[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetUseSequentialStreams());
+            VERIFY_IS_TRUE(t.GetXml().find("<SequentialStreams>") == string::npos);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-sn0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-sk0/4", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // stream variants are sequential only
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-r", "-sr", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_FALSE(profile.Validate(true));
+        }
+    }
+
     void CmdLineParserUnitTests::TestParseCmdLineGroupAffinity()
     {
         CmdLineParser p;
@@ -920,31 +1698,190 @@ namespace UnitTests
             VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
         }
 
-        // multiple with -Sm/-Sm
-        {
-            Profile profile;
-            const char *argv[] = { "foo", "-Sm", "-Sm", "testfile.dat" };
-            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
-        }
+        // multiple with -Sm/-Sm
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Sm", "-Sm", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
+
+        // invalid option
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Sx", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineDisableAffinity()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-n", "testfile.dat" };
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+        VERIFY_IS_TRUE(profile.GetVerbose() == false);
+        VERIFY_IS_TRUE(profile.GetProgress() == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -n testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
+        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
+        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
+        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
+        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
+        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
+
+        vector<TimeSpan> vSpans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
+        VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
+        VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
+        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == true);
+        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
+
+        const auto& vAffinity(vSpans[0].GetAffinityAssignments());
+        VERIFY_ARE_EQUAL(vAffinity.size(), (size_t)0);
+
+        vector<Target> vTargets(vSpans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t(vTargets[0]);
+
+        VERIFY_IS_TRUE(t.GetPath().compare("testfile.dat") == 0);
+        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(128 * 1024));
+        VERIFY_ARE_EQUAL(t.GetRequestCount(), (DWORD)2);
+        VERIFY_IS_TRUE(t.GetUseRandomAccessPattern() == false);
+        VERIFY_IS_TRUE(t.GetUseInterlockedSequential() == false);
+        VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
+        VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
+        VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
+        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
+        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
+        VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
+        VERIFY_IS_TRUE(t.GetCreateFile() == false);
+        VERIFY_ARE_EQUAL(t.GetFileSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetMaxFileSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (DWORD)84);
+        VERIFY_IS_TRUE(t.GetUseBurstSize() == false);
+        VERIFY_ARE_EQUAL(t.GetBurstSize(), (DWORD)0);
+        VERIFY_ARE_EQUAL(t.GetThinkTime(), (DWORD)0);
+        VERIFY_IS_TRUE(t.GetEnableThinkTime() == false);
+        VERIFY_IS_TRUE(t.GetSequentialScanHint() == false);
+        VERIFY_IS_TRUE(t.GetRandomAccessHint() == false);
+        VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
+        VERIFY_IS_TRUE(t.GetUseLargePages() == false);
+        VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineDisableAffinityConflict()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-n", "-a1,2", "testfile.dat" };
+
+        // -n cannot be used with -a
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineVerbose()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-v", "testfile.dat" };
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+        VERIFY_IS_TRUE(profile.GetVerbose() == true);
+        VERIFY_IS_TRUE(profile.GetProgress() == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -v testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
+        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
+        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
+        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
+        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
+        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
+
+        vector<TimeSpan> vSpans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
+        VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
+        VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
+        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
+
+        const auto& vAffinity(vSpans[0].GetAffinityAssignments());
+        VERIFY_ARE_EQUAL(vAffinity.size(), (size_t)0);
 
-        // invalid option
-        {
-            Profile profile;
-            const char *argv[] = { "foo", "-Sx", "testfile.dat" };
-            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
-        }
+        vector<Target> vTargets(vSpans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t(vTargets[0]);
+
+        VERIFY_IS_TRUE(t.GetPath().compare("testfile.dat") == 0);
+        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(128 * 1024));
+        VERIFY_ARE_EQUAL(t.GetRequestCount(), (DWORD)2);
+        VERIFY_IS_TRUE(t.GetUseRandomAccessPattern() == false);
+        VERIFY_IS_TRUE(t.GetUseInterlockedSequential() == false);
+        VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
+        VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
+        VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
+        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
+        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
+        VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
+        VERIFY_IS_TRUE(t.GetCreateFile() == false);
+        VERIFY_ARE_EQUAL(t.GetFileSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetMaxFileSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (DWORD)84);
+        VERIFY_IS_TRUE(t.GetUseBurstSize() == false);
+        VERIFY_ARE_EQUAL(t.GetBurstSize(), (DWORD)0);
+        VERIFY_ARE_EQUAL(t.GetThinkTime(), (DWORD)0);
+        VERIFY_IS_TRUE(t.GetEnableThinkTime() == false);
+        VERIFY_IS_TRUE(t.GetSequentialScanHint() == false);
+        VERIFY_IS_TRUE(t.GetRandomAccessHint() == false);
+        VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
+        VERIFY_IS_TRUE(t.GetUseLargePages() == false);
+        VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineDisableAffinity()
+    void CmdLineParserUnitTests::TestParseCmdLineDisableOSCache()
     {
         CmdLineParser p;
         Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-n", "testfile.dat" };
+        const char *argv[] = { "foo", "-b128K", "-w84", "-S", "testfile.dat" };
         VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
         VERIFY_IS_TRUE(profile.GetVerbose() == false);
         VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -n testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -S testfile.dat") == 0);
         VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
         VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
         VERIFY_IS_TRUE(profile.GetEtwThread() == false);
@@ -967,7 +1904,7 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
         VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
         VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
-        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == true);
+        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
         VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
         VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
         VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
@@ -987,7 +1924,7 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
         VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
         VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::DisableOSCache);
         VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
@@ -1009,27 +1946,16 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineDisableAffinityConflict()
-    {
-        CmdLineParser p;
-        Profile profile;
-        struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-n", "-a1,2", "testfile.dat" };
-
-        // -n cannot be used with -a
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
-    }
-
-    void CmdLineParserUnitTests::TestParseCmdLineVerbose()
+    void CmdLineParserUnitTests::TestParseCmdLineDisableLocalCache()
     {
         CmdLineParser p;
         Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-v", "testfile.dat" };
+        const char *argv[] = { "foo", "-b128K", "-w84", "-Sr", "testfile.dat" };
         VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-        VERIFY_IS_TRUE(profile.GetVerbose() == true);
+        VERIFY_IS_TRUE(profile.GetVerbose() == false);
         VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -v testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sr testfile.dat") == 0);
         VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
         VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
         VERIFY_IS_TRUE(profile.GetEtwThread() == false);
@@ -1072,7 +1998,7 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
         VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
         VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::DisableLocalCache);
         VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
@@ -1094,16 +2020,16 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineDisableOSCache()
+    void CmdLineParserUnitTests::TestParseCmdLineBufferedWriteThrough()
     {
         CmdLineParser p;
         Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-S", "testfile.dat" };
+        const char *argv[] = { "foo", "-b128K", "-w84", "-Sbw", "testfile.dat" };
         VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
         VERIFY_IS_TRUE(profile.GetVerbose() == false);
         VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -S testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sbw testfile.dat") == 0);
         VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
         VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
         VERIFY_IS_TRUE(profile.GetEtwThread() == false);
@@ -1146,8 +2072,8 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
         VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
         VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::DisableOSCache);
-        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::On);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
         VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
@@ -1168,16 +2094,11 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineDisableLocalCache()
+    void CmdLineParserUnitTests::VerifyParseCmdLineMappedIO(Profile &profile, MemoryMappedIoFlushMode FlushMode)
     {
-        CmdLineParser p;
-        Profile profile;
-        struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-Sr", "testfile.dat" };
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
         VERIFY_IS_TRUE(profile.GetVerbose() == false);
         VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sr testfile.dat") == 0);
+
         VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
         VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
         VERIFY_IS_TRUE(profile.GetEtwThread() == false);
@@ -1220,10 +2141,10 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
         VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
         VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::DisableLocalCache);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
         VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::On);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == FlushMode);
         VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
         VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
         VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
@@ -1242,16 +2163,59 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineBufferedWriteThrough()
+    void CmdLineParserUnitTests::TestParseCmdLineMappedIO()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm testfile.dat") == 0);
+            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::Undefined);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "-Nv", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm -Nv testfile.dat") == 0);
+            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::ViewOfFile);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "-Nn", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm -Nn testfile.dat") == 0);
+            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::NonVolatileMemory);
+        }
+        
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "-Ni", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm -Ni testfile.dat") == 0);
+            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::NonVolatileMemoryNoDrain);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineUseCompletionRoutines()
     {
         CmdLineParser p;
         Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-Sbw", "testfile.dat" };
+        const char *argv[] = { "foo", "-b128K", "-w84", "-x", "testfile.dat" };
         VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
         VERIFY_IS_TRUE(profile.GetVerbose() == false);
         VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sbw testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -x testfile.dat") == 0);
         VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
         VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
         VERIFY_IS_TRUE(profile.GetEtwThread() == false);
@@ -1275,7 +2239,7 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
         VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
         VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == true);
         VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
         VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
 
@@ -1295,7 +2259,7 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
         VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
         VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
-        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::On);
+        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
         VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
@@ -1316,190 +2280,354 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::VerifyParseCmdLineMappedIO(Profile &profile, MemoryMappedIoFlushMode FlushMode)
+    void CmdLineParserUnitTests::TestParseCmdLineUseIoRing()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-w84", "-xr", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -xr testfile.dat") == 0);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRing() == true);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRingSubmissionPoller() == false);
+            VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-t2", "-a0,1,2,3", "-xrp", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRing() == true);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRingSubmissionPoller() == true);
+            VERIFY_ARE_EQUAL(vSpans[0].GetAffinityAssignments().size(), (size_t)4);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-w84", "-xq", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineUseEventCompletions()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-o8", "-xe", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -o8 -xe testfile.dat") == 0);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_IS_TRUE(vSpans[0].GetEventCompletions() == true);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRing() == false);
+            VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b128K", "-xex", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLinePollCompletions()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-o1", "-Su", "-Q", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b4K -o1 -Su -Q testfile.dat") == 0);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_IS_TRUE(vSpans[0].GetPollCompletions() == true);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRing() == false);
+            VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-Sh", "-xr", "-Q", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_IS_TRUE(vSpans[0].GetPollCompletions() == true);
+            VERIFY_IS_TRUE(vSpans[0].GetIoRing() == true);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-Su", "-Qx", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineBatchSize()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-o32", "-xr", "-q16", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b4K -o32 -xr -q16 testfile.dat") == 0);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_ARE_EQUAL(vSpans[0].GetBatchSize(), (DWORD)16);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans[0].GetBatchSize(), (DWORD)1);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-q0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineLookahead()
     {
-        VERIFY_IS_TRUE(profile.GetVerbose() == false);
-        VERIFY_IS_TRUE(profile.GetProgress() == 0);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-r", "-k64", "-kdoffsets.csv", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b4K -r -k64 -kdoffsets.csv testfile.dat") == 0);
 
-        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
-        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
-        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
-        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
-        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
-        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_ARE_EQUAL(vSpans[0].GetLookaheadDepth(), (DWORD)64);
+            VERIFY_IS_TRUE(vSpans[0].GetLookaheadDumpPath().compare("offsets.csv") == 0);
+        }
 
-        vector<TimeSpan> vSpans(profile.GetTimeSpans());
-        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
-        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
-        VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
-        VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
-        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
 
-        const auto& vAffinity(vSpans[0].GetAffinityAssignments());
-        VERIFY_ARE_EQUAL(vAffinity.size(), (size_t)0);
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans[0].GetLookaheadDepth(), (DWORD)0);
+            VERIFY_IS_TRUE(vSpans[0].GetLookaheadDumpPath().empty());
+        }
 
-        vector<Target> vTargets(vSpans[0].GetTargets());
-        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
-        Target t(vTargets[0]);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-k0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
 
-        VERIFY_IS_TRUE(t.GetPath().compare("testfile.dat") == 0);
-        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(128 * 1024));
-        VERIFY_ARE_EQUAL(t.GetRequestCount(), (DWORD)2);
-        VERIFY_IS_TRUE(t.GetUseRandomAccessPattern() == false);
-        VERIFY_IS_TRUE(t.GetUseInterlockedSequential() == false);
-        VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
-        VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
-        VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
-        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::On);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == FlushMode);
-        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
-        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
-        VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
-        VERIFY_IS_TRUE(t.GetCreateFile() == false);
-        VERIFY_ARE_EQUAL(t.GetFileSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetMaxFileSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (DWORD)84);
-        VERIFY_IS_TRUE(t.GetUseBurstSize() == false);
-        VERIFY_ARE_EQUAL(t.GetBurstSize(), (DWORD)0);
-        VERIFY_ARE_EQUAL(t.GetThinkTime(), (DWORD)0);
-        VERIFY_IS_TRUE(t.GetEnableThinkTime() == false);
-        VERIFY_IS_TRUE(t.GetSequentialScanHint() == false);
-        VERIFY_IS_TRUE(t.GetRandomAccessHint() == false);
-        VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
-        VERIFY_IS_TRUE(t.GetUseLargePages() == false);
-        VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-k64", "-kd", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            // the dump needs a lookahead to dump
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-kdoffsets.csv", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineMappedIO()
+    void CmdLineParserUnitTests::TestParseCmdLineWaitStrategy()
     {
         {
             CmdLineParser p;
             Profile profile;
             struct Synchronization s = {};
-            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "testfile.dat" };
+            const char *argv[] = { "foo", "-b4K", "testfile.dat" };
             VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm testfile.dat") == 0);
-            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::Undefined);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_IS_TRUE(vSpans[0].GetWaitStrategy() == WaitStrategy::Undefined);
         }
 
         {
             CmdLineParser p;
             Profile profile;
             struct Synchronization s = {};
-            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "-Nv", "testfile.dat" };
+            const char *argv[] = { "foo", "-b4K", "-Yb", "testfile.dat" };
             VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm -Nv testfile.dat") == 0);
-            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::ViewOfFile);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_IS_TRUE(vSpans[0].GetWaitStrategy() == WaitStrategy::Block);
         }
 
         {
             CmdLineParser p;
             Profile profile;
             struct Synchronization s = {};
-            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "-Nn", "testfile.dat" };
+            const char *argv[] = { "foo", "-b4K", "-Yp", "testfile.dat" };
             VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm -Nn testfile.dat") == 0);
-            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::NonVolatileMemory);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_IS_TRUE(vSpans[0].GetWaitStrategy() == WaitStrategy::Poll);
         }
-        
+
         {
             CmdLineParser p;
             Profile profile;
             struct Synchronization s = {};
-            const char *argv[] = { "foo", "-b128K", "-w84", "-Sm", "-Ni", "testfile.dat" };
+            const char *argv[] = { "foo", "-b4K", "-Ys", "testfile.dat" };
             VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Sm -Ni testfile.dat") == 0);
-            VerifyParseCmdLineMappedIO(profile, MemoryMappedIoFlushMode::NonVolatileMemoryNoDrain);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_IS_TRUE(vSpans[0].GetWaitStrategy() == WaitStrategy::SpinThenBlock);
+            VERIFY_ARE_EQUAL(vSpans[0].GetSpinBudgetInMicroseconds(), (DWORD)50);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-Ys200", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_IS_TRUE(vSpans[0].GetWaitStrategy() == WaitStrategy::SpinThenBlock);
+            VERIFY_ARE_EQUAL(vSpans[0].GetSpinBudgetInMicroseconds(), (DWORD)200);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-Yx", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
         }
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineUseCompletionRoutines()
+    void CmdLineParserUnitTests::TestParseCmdLineSeparateReaper()
     {
-        CmdLineParser p;
-        Profile profile;
-        struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-x", "testfile.dat" };
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-        VERIFY_IS_TRUE(profile.GetVerbose() == false);
-        VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -x testfile.dat") == 0);
-        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
-        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
-        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
-        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
-        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
-        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-o8", "-H", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b4K -o8 -H testfile.dat") == 0);
 
-        vector<TimeSpan> vSpans(profile.GetTimeSpans());
-        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
-        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
-        VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
-        VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
-        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == true);
-        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_IS_TRUE(vSpans[0].GetSeparateReaper() == true);
+            VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        }
 
-        const auto& vAffinity(vSpans[0].GetAffinityAssignments());
-        VERIFY_ARE_EQUAL(vAffinity.size(), (size_t)0);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
 
-        vector<Target> vTargets(vSpans[0].GetTargets());
-        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
-        Target t(vTargets[0]);
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_IS_TRUE(vSpans[0].GetSeparateReaper() == false);
+        }
 
-        VERIFY_IS_TRUE(t.GetPath().compare("testfile.dat") == 0);
-        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(128 * 1024));
-        VERIFY_ARE_EQUAL(t.GetRequestCount(), (DWORD)2);
-        VERIFY_IS_TRUE(t.GetUseRandomAccessPattern() == false);
-        VERIFY_IS_TRUE(t.GetUseInterlockedSequential() == false);
-        VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
-        VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
-        VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
-        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
-        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
-        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
-        VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
-        VERIFY_IS_TRUE(t.GetCreateFile() == false);
-        VERIFY_ARE_EQUAL(t.GetFileSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetMaxFileSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (DWORD)84);
-        VERIFY_IS_TRUE(t.GetUseBurstSize() == false);
-        VERIFY_ARE_EQUAL(t.GetBurstSize(), (DWORD)0);
-        VERIFY_ARE_EQUAL(t.GetThinkTime(), (DWORD)0);
-        VERIFY_IS_TRUE(t.GetEnableThinkTime() == false);
-        VERIFY_IS_TRUE(t.GetSequentialScanHint() == false);
-        VERIFY_IS_TRUE(t.GetRandomAccessHint() == false);
-        VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
-        VERIFY_IS_TRUE(t.GetUseLargePages() == false);
-        VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-Hx", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-H", "-x", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineCompletionPool()
+    {
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-t4", "-o8", "-Hp2", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b4K -t4 -o8 -Hp2 testfile.dat") == 0);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+            VERIFY_ARE_EQUAL(vSpans[0].GetCompletionPoolThreadCount(), (DWORD)2);
+            VERIFY_IS_TRUE(vSpans[0].GetSeparateReaper() == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+            vector<TimeSpan> vSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vSpans[0].GetCompletionPoolThreadCount(), (DWORD)0);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-Hp0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        {
+            CmdLineParser p;
+            Profile profile;
+            struct Synchronization s = {};
+            const char *argv[] = { "foo", "-b4K", "-H", "-Hp2", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
     void CmdLineParserUnitTests::TestParseCmdLineRandSeed()
@@ -58,6 +58,17 @@ namespace UnitTests
         TEST_METHOD(Test_GetSizeInBytes);
         TEST_METHOD(TestParseCmdLine);
         TEST_METHOD(TestParseCmdLineBlockSize);
+        TEST_METHOD(TestParseCmdLineBlockSizeDistribution);
+        TEST_METHOD(TestParseCmdLineRandomDistribution);
+        TEST_METHOD(TestParseCmdLineRandomPermutation);
+        TEST_METHOD(TestParseCmdLineAccessPatternPlugin);
+        TEST_METHOD(TestParseCmdLineTrimAndWriteZeroes);
+        TEST_METHOD(TestParseCmdLineFlushAndDurableWrites);
+        TEST_METHOD(TestParseCmdLineAppend);
+        TEST_METHOD(TestParseCmdLineGroupCommit);
+        TEST_METHOD(TestParseCmdLineMetadata);
+        TEST_METHOD(TestParseCmdLineRandomRatio);
+        TEST_METHOD(TestParseCmdLineSequentialStreams);
         TEST_METHOD(TestParseCmdLineGroupAffinity);
         TEST_METHOD(TestParseCmdLineAssignAffinity);
         TEST_METHOD(TestParseCmdLineHintFlag);
@@ -72,6 +83,14 @@ namespace UnitTests
         TEST_METHOD(TestParseCmdLineMappedIO);
         TEST_METHOD(TestParseCmdLineConflictingCacheModes);
         TEST_METHOD(TestParseCmdLineUseCompletionRoutines);
+        TEST_METHOD(TestParseCmdLineUseIoRing);
+        TEST_METHOD(TestParseCmdLineUseEventCompletions);
+        TEST_METHOD(TestParseCmdLinePollCompletions);
+        TEST_METHOD(TestParseCmdLineBatchSize);
+        TEST_METHOD(TestParseCmdLineLookahead);
+        TEST_METHOD(TestParseCmdLineWaitStrategy);
+        TEST_METHOD(TestParseCmdLineSeparateReaper);
+        TEST_METHOD(TestParseCmdLineCompletionPool);
         TEST_METHOD(TestParseCmdLineRandSeed);
         TEST_METHOD(TestParseCmdLineRandSeedGetTickCount);
         TEST_METHOD(TestParseCmdLineWarmupAndCooldown);
@@ -412,6 +412,553 @@ namespace UnitTests
         VERIFY_IS_TRUE(profile.Validate(false));
     }
 
+    void ProfileUnitTests::Test_ValidateIoRing()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // a submission poller requires I/O rings
+        profile._vTimeSpans[0].SetIoRingSubmissionPoller(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+
+        profile._vTimeSpans[0].SetIoRing(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // I/O rings and completion routines are exclusive
+        profile._vTimeSpans[0].SetCompletionRoutines(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetCompletionRoutines(false);
+
+        // I/O rings don't apply to memory mapped I/O
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::On);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateEventCompletions()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        profile._vTimeSpans[0].SetEventCompletions(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // a thread can wait on at most MAXIMUM_WAIT_OBJECTS events
+        profile._vTimeSpans[0]._vTargets[0].SetRequestCount(MAXIMUM_WAIT_OBJECTS + 1);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetRequestCount(MAXIMUM_WAIT_OBJECTS);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // events, I/O rings and completion routines are exclusive
+        profile._vTimeSpans[0].SetIoRing(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetIoRing(false);
+
+        profile._vTimeSpans[0].SetCompletionRoutines(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidatePollCompletions()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        profile._vTimeSpans[0].SetPollCompletions(true);
+
+        // polling requires unbuffered targets
+        VERIFY_IS_FALSE(profile.Validate(true));
+
+        profile._vTimeSpans[0]._vTargets[0].SetCacheMode(TargetCacheMode::DisableOSCache);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // polling combines with I/O rings, but not completion routines
+        profile._vTimeSpans[0].SetIoRing(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0].SetIoRing(false);
+
+        profile._vTimeSpans[0].SetCompletionRoutines(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetCompletionRoutines(false);
+
+        // polled completions never wait
+        profile._vTimeSpans[0].SetWaitStrategy(WaitStrategy::Poll);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0].SetWaitStrategy(WaitStrategy::SpinThenBlock);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateBatchSize()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_ARE_EQUAL(profile._vTimeSpans[0].GetBatchSize(), (DWORD)1);
+
+        profile._vTimeSpans[0].SetBatchSize(64);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        profile._vTimeSpans[0].SetBatchSize(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateLookahead()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_ARE_EQUAL(profile._vTimeSpans[0].GetLookaheadDepth(), (DWORD)0);
+
+        profile._vTimeSpans[0].SetLookaheadDumpPath("offsets.csv");
+        VERIFY_IS_FALSE(profile.Validate(true));
+
+        profile._vTimeSpans[0].SetLookaheadDepth(128);
+        VERIFY_IS_TRUE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateSeparateReaper()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        profile._vTimeSpans[0].SetSeparateReaper(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        profile._vTimeSpans[0].SetWaitStrategy(WaitStrategy::Poll);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0].SetWaitStrategy(WaitStrategy::Undefined);
+
+        // the reaper shares an I/O completion port with the worker
+        profile._vTimeSpans[0].SetCompletionRoutines(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetCompletionRoutines(false);
+
+        profile._vTimeSpans[0].SetIoRing(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetIoRing(false);
+
+        profile._vTimeSpans[0].SetEventCompletions(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetEventCompletions(false);
+
+        profile._vTimeSpans[0]._vTargets[0].SetCacheMode(TargetCacheMode::DisableOSCache);
+        profile._vTimeSpans[0].SetPollCompletions(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetPollCompletions(false);
+        profile._vTimeSpans[0]._vTargets[0].SetCacheMode(TargetCacheMode::Cached);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::On);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateCompletionPool()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        profile._vTimeSpans[0].SetCompletionPoolThreadCount(2);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // the pool reaps a shared I/O completion port
+        profile._vTimeSpans[0].SetCompletionRoutines(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetCompletionRoutines(false);
+
+        profile._vTimeSpans[0].SetIoRing(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetIoRing(false);
+
+        // either the pool or per-thread reapers, not both
+        profile._vTimeSpans[0].SetSeparateReaper(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetSeparateReaper(false);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::On);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateBlockSizeDistribution()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.AddBlockSizeWeight(IOOperation::ReadIO, 4096, 60);
+        target.AddBlockSizeWeight(IOOperation::ReadIO, 65536, 40);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // the custom write buffer must hold the largest block size of the distribution
+        profile._vTimeSpans[0]._vTargets[0].SetRandomDataWriteBufferSize(65536);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].AddBlockSizeWeight(IOOperation::WriteIO, 1024 * 1024, 1);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetRandomDataWriteBufferSize(0);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // a distribution needs a non-zero total weight
+        Target target2;
+        target2.AddBlockSizeWeight(IOOperation::WriteIO, 4096, 0);
+        profile._vTimeSpans[0]._vTargets[0] = target2;
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateRandomDistribution()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetRandomDistribution(DistributionType::Zipf);
+        target.SetZipfTheta(0.9);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+
+        // distributions only apply to random access
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetUseRandomAccessPattern(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        profile._vTimeSpans[0]._vTargets[0].SetZipfTheta(1.0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+
+        profile._vTimeSpans[0]._vTargets[0].SetRandomDistribution(DistributionType::Pareto);
+        profile._vTimeSpans[0]._vTargets[0].SetParetoHotPercent(20);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetParetoHotPercent(50);
+        VERIFY_IS_FALSE(profile.Validate(true));
+
+        profile._vTimeSpans[0]._vTargets[0].SetRandomDistribution(DistributionType::Normal);
+        profile._vTimeSpans[0]._vTargets[0].SetNormalStdDevPercent(10);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetNormalStdDevPercent(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+
+        // ranges may leave IO for the rest of the target, but not cover the target without covering all of the IO
+        profile._vTimeSpans[0]._vTargets[0].SetRandomDistribution(DistributionType::Percent);
+        profile._vTimeSpans[0]._vTargets[0].AddDistributionRange(90, 10);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].AddDistributionRange(5, 90);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].AddDistributionRange(5, 0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateRandomPermutation()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetUseRandomPermutation(true);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+
+        // without replacement only applies to random access
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetUseRandomAccessPattern(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // and is uniform by definition
+        profile._vTimeSpans[0]._vTargets[0].SetRandomDistribution(DistributionType::Zipf);
+        profile._vTimeSpans[0]._vTargets[0].SetZipfTheta(0.9);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateAccessPatternPlugin()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetAccessPatternPlugin("hotspot.dll", "");
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // the plugin generates the offsets, so none of the built in patterns may be asked for
+        profile._vTimeSpans[0]._vTargets[0].SetUseRandomAccessPattern(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetUseRandomAccessPattern(false);
+
+        profile._vTimeSpans[0]._vTargets[0].SetUseInterlockedSequential(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetUseInterlockedSequential(false);
+
+        profile._vTimeSpans[0]._vTargets[0].SetSequentialStreamCount(2);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateTrimAndWriteZeroes()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetWriteRatio(50);
+        target.SetTrimRatio(30);
+        target.SetWriteZeroesRatio(20);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        profile._vTimeSpans[0]._vTargets[0].SetWriteZeroesRatio(21);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetWriteZeroesRatio(20);
+
+        // neither completion routines nor I/O rings can issue them
+        profile._vTimeSpans[0].SetCompletionRoutines(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetCompletionRoutines(false);
+
+        profile._vTimeSpans[0].SetIoRing(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetIoRing(false);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::On);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::Off);
+
+        profile._vTimeSpans[0]._vTargets[0].SetAccessPatternPlugin("hotspot.dll", "");
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateFlushAndDurableWrites()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetWriteRatio(30);
+        target.SetDurableWriteRatio(100);
+        target.SetFlushRatio(10);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        profile._vTimeSpans[0]._vTargets[0].SetFlushRatio(101);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetFlushRatio(10);
+
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(101);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(100);
+
+        // one flush schedule at a time
+        profile._vTimeSpans[0]._vTargets[0].SetFlushIoInterval(16);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetFlushIoInterval(0);
+
+        // both need something to make durable
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetTrimRatio(10);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(0);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetTrimRatio(0);
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(30);
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(100);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::On);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::Off);
+
+        // data-only flushes need a schedule
+        profile._vTimeSpans[0]._vTargets[0].SetFlushDataOnly(true);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetFlushRatio(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateAppend()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetWriteRatio(100);
+        target.SetUseAppend(true);
+        target.SetAppendPreallocationSizeInBytes(1024 * 1024);
+        target.SetAppendSegmentSizeInBytes(target.GetBlockSizeInBytes());
+        target.SetFlushIoInterval(8);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // writes only
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(90);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(100);
+
+        // a write must fit in a segment
+        profile._vTimeSpans[0]._vTargets[0].SetAppendSegmentSizeInBytes(target.GetBlockSizeInBytes() - 1);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetAppendSegmentSizeInBytes(0);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // the tail decides the offsets and the size
+        profile._vTimeSpans[0]._vTargets[0].SetUseRandomAccessPattern(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetUseRandomAccessPattern(false);
+
+        profile._vTimeSpans[0]._vTargets[0].SetBaseFileOffsetInBytes(4096);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetBaseFileOffsetInBytes(0);
+
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(50);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(0);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::On);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMemoryMappedIoMode(MemoryMappedIoMode::Off);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // sizes mean nothing without append
+        profile._vTimeSpans[0]._vTargets[0].SetUseAppend(false);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetAppendPreallocationSizeInBytes(0);
+        VERIFY_IS_TRUE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateGroupCommit()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetWriteRatio(100);
+        target.SetCommitterCount(16);
+        target.SetCommitRecordSizeInBytes(512);
+        target.SetCommitThinkTimeInMicroseconds(100);
+        target.SetFlushDataOnly(true);
+        target.SetUseAppend(true);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // writes only
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(90);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(100);
+
+        // a record must fit in a block
+        profile._vTimeSpans[0]._vTargets[0].SetCommitRecordSizeInBytes(target.GetBlockSizeInBytes() + 1);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetCommitRecordSizeInBytes(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetCommitRecordSizeInBytes(target.GetBlockSizeInBytes());
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // unbuffered group writes must be whole sectors
+        profile._vTimeSpans[0]._vTargets[0].SetCacheMode(TargetCacheMode::DisableOSCache);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetCommitRecordSizeInBytes(100);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetCacheMode(TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetCommitRecordSizeInBytes(target.GetBlockSizeInBytes());
+
+        // each group is flushed, so there is no room for other flushes or durable writes
+        profile._vTimeSpans[0]._vTargets[0].SetFlushIoInterval(8);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetFlushIoInterval(0);
+
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(50);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetDurableWriteRatio(0);
+
+        // committers are released by the thread which issued their group
+        profile._vTimeSpans[0].SetSeparateReaper(true);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0].SetSeparateReaper(false);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // think time and data-only flushes mean nothing without group commit
+        profile._vTimeSpans[0]._vTargets[0].SetCommitterCount(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetCommitThinkTimeInMicroseconds(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetFlushDataOnly(false);
+        VERIFY_IS_TRUE(profile.Validate(true));
+    }
+
+    void ProfileUnitTests::Test_ValidateMetadata()
+    {
+        TimeSpan timeSpan;
+        Target target;
+        target.SetUseMetadata(true);
+        target.SetMetadataFanout(4);
+        target.SetMetadataDepth(2);
+        target.SetMetadataFilesPerDirectory(16);
+        timeSpan.AddTarget(target);
+
+        Profile profile;
+        profile.AddTimeSpan(timeSpan);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // no data I/O
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(10);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetWriteRatio(0);
+
+        profile._vTimeSpans[0]._vTargets[0].SetFileSize(1024 * 1024);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetFileSize(0);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // the tree needs at least one file, and not too many
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataFanout(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataFanout(4);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataFilesPerDirectory(0);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataFilesPerDirectory(16);
+
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataDepth(32);
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataDepth(0);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // at least one operation must have weight
+        for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+        {
+            profile._vTimeSpans[0]._vTargets[0].SetMetadataWeight(static_cast<MetadataOperation>(i), 0);
+        }
+        VERIFY_IS_FALSE(profile.Validate(true));
+        profile._vTimeSpans[0]._vTargets[0].SetMetadataWeight(MetadataOperation::Stat, 1);
+        VERIFY_IS_TRUE(profile.Validate(true));
+
+        // metadata and data targets cannot share a time span
+        Target dataTarget;
+        profile._vTimeSpans[0].AddTarget(dataTarget);
+        VERIFY_IS_FALSE(profile.Validate(true));
+    }
+
     void ProfileUnitTests::Test_ValidateSystem()
     {
         // processor topology validation for affinity assignments
@@ -970,6 +1517,172 @@ namespace UnitTests
             "</Target>\n");
     }
 
+    void TargetUnitTests::Test_TargetBlockSizeDistribution()
+    {
+        Random r;
+        Target target;
+        target.SetBlockSizeInBytes(8192);
+        VERIFY_IS_FALSE(target.GetUseBlockSizeDistribution());
+        VERIFY_ARE_EQUAL(target.GetMaxBlockSizeInBytes(), (DWORD)8192);
+        VERIFY_ARE_EQUAL(target.GetBlockSizeClasses().size(), (size_t)0);
+        VERIFY_ARE_EQUAL(target.GetNextBlockSizeInBytes(IOOperation::WriteIO, &r), (DWORD)8192);
+
+        // reads use the distribution, writes keep the fixed block size
+        target.AddBlockSizeWeight(IOOperation::ReadIO, 65536, 30);
+        target.AddBlockSizeWeight(IOOperation::ReadIO, 4096, 70);
+        VERIFY_IS_TRUE(target.GetUseBlockSizeDistribution());
+        VERIFY_ARE_EQUAL(target.GetMaxBlockSizeInBytes(), (DWORD)65536);
+
+        vector<DWORD> vBlockSizes(target.GetBlockSizeClasses());
+        VERIFY_ARE_EQUAL(vBlockSizes.size(), (size_t)3);
+        VERIFY_ARE_EQUAL(vBlockSizes[0], (DWORD)4096);
+        VERIFY_ARE_EQUAL(vBlockSizes[1], (DWORD)8192);
+        VERIFY_ARE_EQUAL(vBlockSizes[2], (DWORD)65536);
+
+        for (int i = 0; i < 100; i++)
+        {
+            DWORD dwBlockSize = target.GetNextBlockSizeInBytes(IOOperation::ReadIO, &r);
+            VERIFY_IS_TRUE(dwBlockSize == 4096 || dwBlockSize == 65536);
+            VERIFY_ARE_EQUAL(target.GetNextBlockSizeInBytes(IOOperation::WriteIO, &r), (DWORD)8192);
+        }
+
+        // once both IO types have a distribution the fixed block size is no longer used
+        target.AddBlockSizeWeight(IOOperation::WriteIO, 4096, 1);
+        VERIFY_ARE_EQUAL(target.GetMaxBlockSizeInBytes(), (DWORD)65536);
+        VERIFY_ARE_EQUAL(target.GetBlockSizeClasses().size(), (size_t)2);
+        VERIFY_ARE_EQUAL(target.GetNextBlockSizeInBytes(IOOperation::WriteIO, &r), (DWORD)4096);
+
+        string sXml = target.GetXml();
+        VERIFY_IS_TRUE(sXml.find("<ReadBlockSizes>\n"
+            "<BlockSizeWeight>\n"
+            "<BlockSize>65536</BlockSize>\n"
+            "<Weight>30</Weight>\n"
+            "</BlockSizeWeight>\n"
+            "<BlockSizeWeight>\n"
+            "<BlockSize>4096</BlockSize>\n"
+            "<Weight>70</Weight>\n"
+            "</BlockSizeWeight>\n"
+            "</ReadBlockSizes>\n"
+            "<WriteBlockSizes>\n"
+            "<BlockSizeWeight>\n"
+            "<BlockSize>4096</BlockSize>\n"
+            "<Weight>1</Weight>\n"
+            "</BlockSizeWeight>\n"
+            "</WriteBlockSizes>\n"
+            "</Target>\n") != string::npos);
+    }
+
+    void TargetUnitTests::Test_TargetSelector()
+    {
+        const UINT32 cDraws = 1000000;
+        Random r;
+
+        struct
+        {
+            vector<UINT32> vulWeights;
+        } vCases[] = {
+            { { 1 } },
+            { { 1, 1, 1 } },
+            { { 1, 2, 3, 4 } },
+            { { 1000, 0, 1, 1 } },
+            { { 7, 100, 3, 90, 50, 50, 1 } },
+        };
+
+        for (const auto& c : vCases)
+        {
+            vector<Target> vTargets(c.vulWeights.size());
+            TargetSelector selector;
+            UINT64 ullTotalWeight = 0;
+            for (size_t i = 0; i < vTargets.size(); i++)
+            {
+                selector.AddTarget(&vTargets[i], c.vulWeights[i]);
+                ullTotalWeight += c.vulWeights[i];
+            }
+            selector.Initialize();
+            VERIFY_ARE_EQUAL(selector.GetTargetCount(), vTargets.size());
+
+            vector<UINT32> vcSelected(vTargets.size());
+            for (UINT32 i = 0; i < cDraws; i++)
+            {
+                Target *pTarget = selector.Select(&r);
+                VERIFY_IS_TRUE(pTarget >= &vTargets[0] && pTarget <= &vTargets.back());
+                vcSelected[pTarget - &vTargets[0]]++;
+            }
+
+            // each target within half a percent of the draws of its share
+            for (size_t i = 0; i < vTargets.size(); i++)
+            {
+                double lfExpected = static_cast<double>(c.vulWeights[i]) / ullTotalWeight;
+                double lfActual = static_cast<double>(vcSelected[i]) / cDraws;
+                VERIFY_IS_LESS_THAN(fabs(lfExpected - lfActual), 0.005);
+                if (c.vulWeights[i] == 0)
+                {
+                    VERIFY_ARE_EQUAL(vcSelected[i], (UINT32)0);
+                }
+            }
+        }
+    }
+
+    void TargetUnitTests::Test_TargetSelectorLookahead()
+    {
+        // picks drawn in batches are the same sequence as picks drawn one at a time
+        vector<Target> vTargets(4);
+        TargetSelector selector;
+        TargetSelector lookaheadSelector;
+        for (size_t i = 0; i < vTargets.size(); i++)
+        {
+            selector.AddTarget(&vTargets[i], static_cast<UINT32>(i + 1));
+            lookaheadSelector.AddTarget(&vTargets[i], static_cast<UINT32>(i + 1));
+        }
+        selector.Initialize();
+        lookaheadSelector.Initialize();
+        lookaheadSelector.SetLookaheadDepth(7);
+
+        Random r1;
+        Random r2;
+        for (UINT32 i = 0; i < 1000; i++)
+        {
+            VERIFY_ARE_EQUAL(lookaheadSelector.Next(&r2), selector.Next(&r1));
+        }
+    }
+
+    void TargetUnitTests::Test_TargetGeometryWrapToBlock()
+    {
+        // power of two alignment: 10 aligned offsets, 0 through 36K
+        {
+            Target target;
+            target.SetBlockSizeInBytes(4096);
+            target.SetBlockAlignmentInBytes(4096);
+
+            TargetGeometry geometry;
+            geometry.Initialize(target, 4096 * 10);
+            VERIFY_ARE_EQUAL(geometry.ullBlockCount, (UINT64)10);
+
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(4096 * 10), (UINT64)0);
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(4096 * 13 + 100), (UINT64)4096 * 3);
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(4096 * 9 + 1), (UINT64)4096 * 9);
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(~0ULL) % 4096, (UINT64)0);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(geometry.WrapToBlock(~0ULL), geometry.ullLastOffset);
+        }
+
+        // other alignments: 7 aligned offsets, 0 through 18000
+        {
+            Target target;
+            target.SetBlockSizeInBytes(3000);
+            target.SetBlockAlignmentInBytes(3000);
+
+            TargetGeometry geometry;
+            geometry.Initialize(target, 3000 * 7 + 500);
+            VERIFY_ARE_EQUAL(geometry.ullBlockCount, (UINT64)7);
+
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(3000 * 7), (UINT64)0);
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(3000 * 7 + 500), (UINT64)0);
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(3000 * 16 + 2999), (UINT64)3000 * 2);
+            VERIFY_ARE_EQUAL(geometry.WrapToBlock(~0ULL) % 3000, (UINT64)0);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(geometry.WrapToBlock(~0ULL), geometry.ullLastOffset);
+        }
+    }
+
     void TargetUnitTests::Test_AllocateAndFillRandomDataWriteBuffer()
     {
         Random r;
@@ -84,6 +84,22 @@ namespace UnitTests
         TEST_METHOD(Test_MarkFilesAsCreated);
         TEST_METHOD(Test_Validate);
         TEST_METHOD(Test_ValidateSystem);
+        TEST_METHOD(Test_ValidateIoRing);
+        TEST_METHOD(Test_ValidateEventCompletions);
+        TEST_METHOD(Test_ValidatePollCompletions);
+        TEST_METHOD(Test_ValidateBatchSize);
+        TEST_METHOD(Test_ValidateLookahead);
+        TEST_METHOD(Test_ValidateSeparateReaper);
+        TEST_METHOD(Test_ValidateCompletionPool);
+        TEST_METHOD(Test_ValidateBlockSizeDistribution);
+        TEST_METHOD(Test_ValidateRandomDistribution);
+        TEST_METHOD(Test_ValidateRandomPermutation);
+        TEST_METHOD(Test_ValidateAccessPatternPlugin);
+        TEST_METHOD(Test_ValidateTrimAndWriteZeroes);
+        TEST_METHOD(Test_ValidateFlushAndDurableWrites);
+        TEST_METHOD(Test_ValidateAppend);
+        TEST_METHOD(Test_ValidateGroupCommit);
+        TEST_METHOD(Test_ValidateMetadata);
     };
 
     class TargetUnitTests : public WEX::TestClass<TargetUnitTests>
@@ -107,6 +123,10 @@ namespace UnitTests
         TEST_METHOD(Test_TargetGetXmlRandomAccessHint);
         TEST_METHOD(Test_TargetGetXmlSequentialScanHint);
         TEST_METHOD(Test_TargetGetXmlCombinedAccessHint);
+        TEST_METHOD(Test_TargetBlockSizeDistribution);
+        TEST_METHOD(Test_TargetSelector);
+        TEST_METHOD(Test_TargetSelectorLookahead);
+        TEST_METHOD(Test_TargetGeometryWrapToBlock);
         TEST_METHOD(Test_AllocateAndFillRandomDataWriteBuffer);
         TEST_METHOD(Test_AllocateAndFillRandomDataWriteBufferFromFile);
     };
@@ -268,6 +268,8 @@ namespace UnitTests
 
         tp.vullPrivateSequentialOffsets.push_back(0);
         tp.vullFileSizes.push_back(3000);
+        tp.vTargetGeometry.resize(1);
+        tp.vTargetGeometry[0].Initialize(target, 3000);
 
         for( int i = 0; i < 10; ++i )
         {
@@ -278,6 +280,386 @@ namespace UnitTests
         }
     }
     
+    void IORequestGeneratorUnitTests::Test_GetNextFileOffsetRandomDistribution()
+    {
+        // 1000 aligned blocks; each distribution must stay in bounds and skew towards its hot blocks
+        struct
+        {
+            DistributionType type;
+            UINT64 ullHotFirstBlock;
+            UINT64 ullHotBlockCount;
+            UINT32 ulMinHotPercent;
+        } vCases[] = {
+            { DistributionType::Percent, 0, 100, 85 },
+            { DistributionType::Zipf, 0, 100, 60 },
+            { DistributionType::Pareto, 0, 200, 75 },
+            { DistributionType::Normal, 400, 200, 90 },
+        };
+
+        for (const auto& c : vCases)
+        {
+            Target target;
+            target.SetBlockAlignmentInBytes(4096);
+            target.SetBlockSizeInBytes(4096);
+            target.SetUseRandomAccessPattern(true);
+            target.SetRandomDistribution(c.type);
+            target.AddDistributionRange(90, 10);
+            target.SetZipfTheta(0.99);
+            target.SetParetoHotPercent(20);
+            target.SetNormalCenterPercent(50);
+            target.SetNormalStdDevPercent(5);
+
+            Random r;
+            ThreadParameters tp;
+            tp.pRand = &r;
+            tp.vTargets.push_back(target);
+
+            TimeSpan timespan;
+            tp.pTimeSpan = &timespan;
+
+            tp.vullPrivateSequentialOffsets.push_back(0);
+            tp.vullFileSizes.push_back(4096 * 1000);
+            tp.vTargetGeometry.resize(1);
+            tp.vTargetGeometry[0].Initialize(target, 4096 * 1000);
+            tp.vOffsetDistributions.resize(1);
+            tp.vOffsetDistributions[0].Initialize(target, 1000);
+
+            UINT32 cHot = 0;
+            for (int i = 0; i < 10000; ++i)
+            {
+                UINT64 nextOffset = IORequestGenerator::GetNextFileOffset(tp, 0, 0);
+                VERIFY_IS_LESS_THAN_OR_EQUAL(nextOffset, (UINT64)4096 * 999);
+                VERIFY_ARE_EQUAL(nextOffset % 4096, 0);
+
+                UINT64 ullBlock = nextOffset / 4096;
+                if (ullBlock >= c.ullHotFirstBlock && ullBlock < c.ullHotFirstBlock + c.ullHotBlockCount)
+                {
+                    cHot++;
+                }
+            }
+            VERIFY_IS_GREATER_THAN_OR_EQUAL(cHot, c.ulMinHotPercent * 100);
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_OffsetDistributionNormalEdge()
+    {
+        // centered on the first block, two thirds of an untruncated normal falls outside of the target; none of
+        // it may pile up on the edge blocks. Truncated to [0, 1000) with a stddev of 1000 blocks, the first block
+        // gets ~0.12% of the I/O and the last ~0.07%
+        Target target;
+        target.SetBlockAlignmentInBytes(4096);
+        target.SetBlockSizeInBytes(4096);
+        target.SetUseRandomAccessPattern(true);
+        target.SetRandomDistribution(DistributionType::Normal);
+        target.SetNormalCenterPercent(0);
+        target.SetNormalStdDevPercent(100);
+
+        OffsetDistribution distribution;
+        distribution.Initialize(target, 1000);
+
+        Random r;
+        UINT32 cFirst = 0;
+        UINT32 cLast = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            UINT64 ullBlock = distribution.NextBlock(&r);
+            VERIFY_IS_LESS_THAN(ullBlock, (UINT64)1000);
+
+            cFirst += (ullBlock == 0) ? 1 : 0;
+            cLast += (ullBlock == 999) ? 1 : 0;
+        }
+
+        VERIFY_IS_GREATER_THAN(cFirst, (UINT32)60);
+        VERIFY_IS_LESS_THAN(cFirst, (UINT32)240);
+        VERIFY_IS_GREATER_THAN(cLast, (UINT32)30);
+        VERIFY_IS_LESS_THAN(cLast, (UINT32)150);
+    }
+
+    void IORequestGeneratorUnitTests::Test_OffsetDistributionDrift()
+    {
+        // all of the IO to a 10 block region at the start of a 1000 block target, moving 100 blocks per second
+        Target target;
+        target.SetBlockAlignmentInBytes(4096);
+        target.SetBlockSizeInBytes(4096);
+        target.SetUseRandomAccessPattern(true);
+        target.SetRandomDistribution(DistributionType::Absolute);
+        target.AddDistributionRangeInBytes(100, 10 * 4096);
+        target.SetDistributionDrift(100 * 4096);
+
+        OffsetDistribution distribution;
+        distribution.Initialize(target, 1000);
+        VERIFY_IS_TRUE(distribution.GetUseDrift());
+
+        UINT64 ullStartTime = PerfTimer::SecondsToPerfTime(1.0);
+        distribution.StartDrift(ullStartTime);
+
+        struct
+        {
+            double lfSeconds;
+            UINT64 ullFirstBlock;
+        } vCases[] = {
+            { 0, 0 },
+            { 2.0, 200 },
+            { 9.95, 995 },      // wraps around the end of the target
+            { 12.0, 200 },
+        };
+
+        Random r;
+        for (const auto& c : vCases)
+        {
+            UINT64 ullTime = ullStartTime + PerfTimer::SecondsToPerfTime(c.lfSeconds);
+            for (int i = 0; i < 1000; i++)
+            {
+                UINT64 ullBlock = distribution.Drift(distribution.NextBlock(&r), ullTime);
+                VERIFY_IS_LESS_THAN(ullBlock, (UINT64)1000);
+                // allow the region a block of rounding either way
+                VERIFY_IS_LESS_THAN((ullBlock + 1000 + 1 - c.ullFirstBlock) % 1000, (UINT64)12);
+            }
+        }
+
+        // a static distribution does not move
+        target.SetDistributionDrift(0);
+        distribution.Initialize(target, 1000);
+        VERIFY_IS_FALSE(distribution.GetUseDrift());
+    }
+
+    void IORequestGeneratorUnitTests::Test_GetNextFileOffsetRandomPermutation()
+    {
+        // two threads sharing a target of 1000 aligned blocks between them must hit every block
+        // exactly once per pass
+        Target target;
+        target.SetBaseFileOffsetInBytes(4096);
+        target.SetBlockAlignmentInBytes(4096);
+        target.SetBlockSizeInBytes(4096);
+        target.SetUseRandomAccessPattern(true);
+        target.SetUseRandomPermutation(true);
+
+        TimeSpan timespan;
+        Random r;
+        ThreadParameters vtp[2];
+        for (UINT32 iThread = 0; iThread < 2; iThread++)
+        {
+            vtp[iThread].pRand = &r;
+            vtp[iThread].vTargets.push_back(target);
+            vtp[iThread].pTimeSpan = &timespan;
+            vtp[iThread].vullPrivateSequentialOffsets.push_back(0);
+            vtp[iThread].vullFileSizes.push_back(4096 * 1001);
+            vtp[iThread].vTargetGeometry.resize(1);
+            vtp[iThread].vTargetGeometry[0].Initialize(target, 4096 * 1001);
+            vtp[iThread].vBlockPermutations.resize(1);
+            vtp[iThread].vBlockPermutations[0].Initialize(1000, timespan.GetRandSeed(), iThread, 2);
+        }
+
+        vector<UINT64> vullFirstPass;
+        for (UINT32 iPass = 0; iPass < 2; iPass++)
+        {
+            vector<UINT32> vcHits(1000);
+            vector<UINT64> vullPass;
+            for (UINT32 i = 0; i < 1000; i++)
+            {
+                UINT64 nextOffset = IORequestGenerator::GetNextFileOffset(vtp[i % 2], 0, 0);
+                VERIFY_IS_GREATER_THAN_OR_EQUAL(nextOffset, (UINT64)4096);
+                VERIFY_ARE_EQUAL(nextOffset % 4096, 0);
+
+                UINT64 ullBlock = (nextOffset - 4096) / 4096;
+                VERIFY_IS_LESS_THAN(ullBlock, (UINT64)1000);
+                vcHits[(size_t)ullBlock]++;
+                vullPass.push_back(ullBlock);
+            }
+
+            for (UINT32 i = 0; i < 1000; i++)
+            {
+                VERIFY_ARE_EQUAL(vcHits[i], (UINT32)1);
+            }
+
+            // each pass is a new permutation
+            if (iPass == 0)
+            {
+                vullFirstPass = vullPass;
+            }
+            else
+            {
+                VERIFY_IS_TRUE(vullPass != vullFirstPass);
+            }
+        }
+
+        // the permutation only depends on the seed
+        BlockPermutation permutation;
+        permutation.Initialize(1000, timespan.GetRandSeed(), 0, 1);
+        for (UINT32 i = 0; i < 1000; i++)
+        {
+            VERIFY_ARE_EQUAL(permutation.NextBlock(), vullFirstPass[i]);
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_GetNextFileOffsetRandomRatio()
+    {
+        // the random percentage holds both for single I/O runs and for longer sequential runs
+        struct
+        {
+            UINT32 ulRandomRatio;
+            UINT32 ulMinRun;
+            UINT32 ulMaxRun;
+        } vCases[] = {
+            { 25, 1, 1 },
+            { 20, 8, 8 },
+            { 50, 2, 30 },
+        };
+
+        for (const auto& c : vCases)
+        {
+            Target target;
+            target.SetBlockAlignmentInBytes(4096);
+            target.SetBlockSizeInBytes(4096);
+            target.SetUseRandomAccessPattern(true);
+            target.SetRandomRatio(c.ulRandomRatio);
+            target.SetSequentialRunLength(c.ulMinRun, c.ulMaxRun);
+
+            Random r;
+            ThreadParameters tp;
+            tp.pRand = &r;
+            tp.vTargets.push_back(target);
+
+            TimeSpan timespan;
+            tp.pTimeSpan = &timespan;
+
+            tp.vullPrivateSequentialOffsets.push_back(0);
+            tp.vullFileSizes.push_back((UINT64)4096 * 1000000);
+            tp.vTargetGeometry.resize(1);
+            tp.vTargetGeometry[0].Initialize(target, (UINT64)4096 * 1000000);
+            tp.vulSequentialRunRemaining.push_back(0);
+
+            const UINT32 cIOs = 100000;
+            UINT32 cSequential = 0;
+            UINT64 prevOffset = 0;
+            for (UINT32 i = 0; i < cIOs; i++)
+            {
+                UINT64 nextOffset = IORequestGenerator::GetNextFileOffset(tp, 0, prevOffset);
+                VERIFY_ARE_EQUAL(nextOffset % 4096, 0);
+                VERIFY_IS_LESS_THAN(nextOffset, (UINT64)4096 * 1000000);
+
+                if (i > 0 && nextOffset == prevOffset + 4096)
+                {
+                    cSequential++;
+                }
+                prevOffset = nextOffset;
+            }
+
+            UINT32 ulRandomPercent = ((cIOs - cSequential) * 100 + cIOs / 2) / cIOs;
+            VERIFY_IS_GREATER_THAN_OR_EQUAL(ulRandomPercent, c.ulRandomRatio - 2);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(ulRandomPercent, c.ulRandomRatio + 2);
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_GetNextFileOffsetSequentialStreams()
+    {
+        // 16 block target; expected offsets are in blocks
+        struct
+        {
+            UINT32 ulStreams;
+            bool fReverse;
+            UINT32 ulReadRun;
+            UINT32 ulSkipRun;
+            UINT64 vullExpected[10];
+        } vCases[] = {
+            { 2, false, 0, 0, { 0, 8, 1, 9, 2, 10, 3, 11, 4, 12 } },
+            { 1, true, 0, 0, { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6 } },
+            { 1, false, 2, 3, { 0, 1, 5, 6, 10, 11, 15, 0, 1, 5 } },
+            { 2, true, 1, 1, { 15, 7, 13, 5, 11, 3, 9, 1, 7, 15 } },
+        };
+
+        for (const auto& c : vCases)
+        {
+            Target target;
+            target.SetBlockAlignmentInBytes(4096);
+            target.SetBlockSizeInBytes(4096);
+            target.SetSequentialStreamCount(c.ulStreams);
+            target.SetUseReverseSequential(c.fReverse);
+            target.SetSequentialSkip(c.ulReadRun, c.ulSkipRun);
+            VERIFY_IS_TRUE(target.GetUseSequentialStreams());
+
+            Random r;
+            ThreadParameters tp;
+            tp.pRand = &r;
+            tp.vTargets.push_back(target);
+
+            TimeSpan timespan;
+            tp.pTimeSpan = &timespan;
+
+            tp.vullPrivateSequentialOffsets.push_back(0);
+            tp.vullFileSizes.push_back(4096 * 16);
+            tp.vTargetGeometry.resize(1);
+            tp.vTargetGeometry[0].Initialize(target, 4096 * 16);
+            tp.vSequentialStreams.resize(1);
+            tp.vSequentialStreams[0].Initialize(target, 0, 4096 * 15);
+
+            UINT64 prevOffset = FIRST_OFFSET;
+            for (int i = 0; i < _countof(c.vullExpected); i++)
+            {
+                UINT64 nextOffset = IORequestGenerator::GetNextFileOffset(tp, 0, prevOffset);
+                VERIFY_ARE_EQUAL(nextOffset, c.vullExpected[i] * 4096);
+                prevOffset = nextOffset;
+            }
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_TargetGeometry()
+    {
+        VERIFY_ARE_EQUAL(Util::MultiplyHigh64(0xffffffffffffffffULL, 0xffffffffffffffffULL), 0xfffffffffffffffeULL);
+        VERIFY_ARE_EQUAL(Util::MultiplyHigh64(0x8000000000000000ULL, 1000), (UINT64)500);
+        VERIFY_ARE_EQUAL(Util::MultiplyHigh64(0x123456789abcdef0ULL, 0x0fedcba987654321ULL), 0x0121fa00ad77d742ULL);
+
+        // power of two alignment converts with shifts
+        {
+            Target target;
+            target.SetBaseFileOffsetInBytes(4096);
+            target.SetBlockAlignmentInBytes(4096);
+            target.SetBlockSizeInBytes(8192);
+
+            TargetGeometry geometry;
+            geometry.Initialize(target, 4096 * 100);
+            VERIFY_IS_TRUE(geometry.fPowerOfTwoAlignment);
+            VERIFY_ARE_EQUAL(geometry.ulAlignmentShift, (UINT32)12);
+            VERIFY_ARE_EQUAL(geometry.ullLastOffset, (UINT64)4096 * 97);
+            VERIFY_ARE_EQUAL(geometry.ullBlockCount, (UINT64)98);
+            VERIFY_ARE_EQUAL(geometry.ullOpenSize, (UINT64)4096 * 98);
+            VERIFY_ARE_EQUAL(geometry.ullRunStride, (UINT64)8192);
+            VERIFY_ARE_EQUAL(geometry.BlockToOffset(97), (UINT64)4096 * 97);
+        }
+
+        // others multiply, and the reciprocal wrap must agree with a division
+        {
+            Target target;
+            target.SetBlockAlignmentInBytes(1000);
+            target.SetBlockSizeInBytes(1500);
+
+            TargetGeometry geometry;
+            geometry.Initialize(target, 12345);
+            VERIFY_IS_FALSE(geometry.fPowerOfTwoAlignment);
+            VERIFY_ARE_EQUAL(geometry.ullLastOffset, (UINT64)10845);
+            VERIFY_ARE_EQUAL(geometry.ullBlockCount, (UINT64)11);
+            VERIFY_ARE_EQUAL(geometry.ullOpenSize, (UINT64)11000);
+            VERIFY_ARE_EQUAL(geometry.ullRunStride, (UINT64)2000);
+            VERIFY_ARE_EQUAL(geometry.BlockToOffset(10), (UINT64)10000);
+
+            Random r;
+            for (UINT64 ullOffset = 0; ullOffset < 1000000; ullOffset += 1000)
+            {
+                VERIFY_ARE_EQUAL(geometry.WrapOffset(ullOffset), ullOffset % 11000);
+            }
+            for (int i = 0; i < 10000; i++)
+            {
+                UINT64 ullOffset = r.Rand64();
+                VERIFY_ARE_EQUAL(geometry.WrapOffset(ullOffset), ullOffset % 11000);
+
+                UINT64 ullRandomOffset = geometry.RandomOffset(&r);
+                VERIFY_IS_LESS_THAN_OR_EQUAL(ullRandomOffset, geometry.ullLastOffset);
+                VERIFY_ARE_EQUAL(ullRandomOffset % 1000, (UINT64)0);
+            }
+            VERIFY_ARE_EQUAL(geometry.WrapOffset(0xffffffffffffffffULL), 0xffffffffffffffffULL % 11000);
+        }
+    }
+
     void IORequestGeneratorUnitTests::Test_GetNextFileOffsetSequential()
     {
         Target target; 
@@ -295,6 +677,8 @@ namespace UnitTests
 
         tp.vullPrivateSequentialOffsets.push_back(0);
         tp.vullFileSizes.push_back(3000);
+        tp.vTargetGeometry.resize(1);
+        tp.vTargetGeometry[0].Initialize(target, 3000);
 
         UINT64 nextOffset;
 
@@ -336,7 +720,11 @@ namespace UnitTests
         tp2.pTimeSpan = &timespan;
 
         tp1.vullFileSizes.push_back(3000);
+        tp1.vTargetGeometry.resize(1);
+        tp1.vTargetGeometry[0].Initialize(target, 3000);
         tp2.vullFileSizes.push_back(3000);
+        tp2.vTargetGeometry.resize(1);
+        tp2.vTargetGeometry[0].Initialize(target, 3000);
 
         UINT64 nextOffset;
 
@@ -371,6 +759,8 @@ namespace UnitTests
 
         tp.vullPrivateSequentialOffsets.push_back(0);
         tp.vullFileSizes.push_back(3000);
+        tp.vTargetGeometry.resize(1);
+        tp.vTargetGeometry[0].Initialize(target, 3000);
 
         UINT64 nextOffset;
 
@@ -566,6 +956,8 @@ namespace UnitTests
         tp.vTargets.push_back(target);
         tp.vullPrivateSequentialOffsets.push_back(0);
         tp.vullFileSizes.push_back(3000);
+        tp.vTargetGeometry.resize(1);
+        tp.vTargetGeometry[0].Initialize(target, 3000);
 
         // this is equivalent to -c2000 -T250 -s500 -b1000
 
@@ -633,6 +1025,8 @@ namespace UnitTests
         tp.vTargets.push_back(target);
         tp.vullPrivateSequentialOffsets.push_back(0);
         tp.vullFileSizes.push_back(3000);
+        tp.vTargetGeometry.resize(1);
+        tp.vTargetGeometry[0].Initialize(target, 3000);
 
         // this is equivalent to -c2000 -T250 -s500 -b1000
 
@@ -46,7 +46,14 @@ namespace UnitTests
         TEST_METHOD(Test_GetFilesToPrecreateConstantOrZeroSizes);
         TEST_METHOD(Test_GetFilesToPrecreateUseMaxSize);
         TEST_METHOD(Test_GetNextFileOffsetRandom);
+        TEST_METHOD(Test_GetNextFileOffsetRandomDistribution);
+        TEST_METHOD(Test_OffsetDistributionNormalEdge);
+        TEST_METHOD(Test_OffsetDistributionDrift);
+        TEST_METHOD(Test_GetNextFileOffsetRandomPermutation);
+        TEST_METHOD(Test_GetNextFileOffsetRandomRatio);
         TEST_METHOD(Test_GetNextFileOffsetSequential);
+        TEST_METHOD(Test_GetNextFileOffsetSequentialStreams);
+        TEST_METHOD(Test_TargetGeometry);
         TEST_METHOD(Test_GetNextFileOffsetInterlockedSequential);
         TEST_METHOD(Test_GetNextFileOffsetParallelAsyncIO);
         TEST_METHOD(Test_GetThreadBaseFileOffset);
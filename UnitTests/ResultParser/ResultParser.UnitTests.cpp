@@ -166,7 +166,7 @@ namespace UnitTests
         ResultParser parser;
         Target target;
 
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         const char *pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -182,7 +182,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetWriteRatio(30);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -199,7 +199,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetRandomDataWriteBufferSize(12341234);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -217,7 +217,7 @@ namespace UnitTests
         parser._sResult = "";
         target.SetRandomDataWriteBufferSourcePath("x:\\foo\\bar.dat");
         target.SetUseRandomAccessPattern(true);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -235,7 +235,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetCacheMode(TargetCacheMode::DisableOSCache);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -254,7 +254,7 @@ namespace UnitTests
         parser._sResult = "";
         target.SetCacheMode(TargetCacheMode::DisableOSCache);
         target.SetWriteThroughMode(WriteThroughMode::On);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -273,7 +273,7 @@ namespace UnitTests
         parser._sResult = "";
         target.SetCacheMode(TargetCacheMode::Cached);
         target.SetWriteThroughMode(WriteThroughMode::On);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -292,7 +292,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetCacheMode(TargetCacheMode::DisableLocalCache);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -311,7 +311,7 @@ namespace UnitTests
         parser._sResult = "";
         target.SetCacheMode(TargetCacheMode::Cached);
         target.SetMemoryMappedIoMode(MemoryMappedIoMode::On);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -330,7 +330,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetMemoryMappedIoFlushMode(MemoryMappedIoFlushMode::ViewOfFile);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -349,7 +349,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetMemoryMappedIoFlushMode(MemoryMappedIoFlushMode::NonVolatileMemory);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -368,7 +368,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetMemoryMappedIoFlushMode(MemoryMappedIoFlushMode::NonVolatileMemoryNoDrain);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -390,7 +390,7 @@ namespace UnitTests
         target.SetMemoryMappedIoFlushMode(MemoryMappedIoFlushMode::Undefined);
         target.SetCacheMode(TargetCacheMode::DisableLocalCache);
         target.SetTemporaryFileHint(true);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -409,7 +409,7 @@ namespace UnitTests
 
         parser._sResult = "";
         target.SetRandomAccessHint(true);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -431,7 +431,7 @@ namespace UnitTests
         target.SetRandomAccessHint(false);
         target.SetTemporaryFileHint(false);
         target.SetSequentialScanHint(true);
-        parser._PrintTarget(target, false, true, false);
+        parser._PrintTarget(target, false, true, false, false, false);
         pszExpectedResult = "\tpath: ''\n" \
             "\t\tthink time: 0ms\n"
             "\t\tburst size: 0\n"
@@ -447,5 +447,43 @@ namespace UnitTests
             "\t\tusing FILE_FLAG_SEQUENTIAL_SCAN hint\n"
             "\t\tIO priority: normal\n";
         VERIFY_IS_TRUE(parser._sResult == pszExpectedResult);
+
+        parser._sResult = "";
+        parser._PrintTarget(target, false, true, false, true, false);
+        pszExpectedResult = "\tpath: ''\n" \
+            "\t\tthink time: 0ms\n"
+            "\t\tburst size: 0\n"
+            "\t\tlocal software cache disabled, remote cache enabled\n"
+            "\t\tusing hardware write cache, writethrough off\n"
+            "\t\twrite buffer size: 12341234\n"
+            "\t\twrite buffer source: 'x:\\foo\\bar.dat'\n"
+            "\t\tperforming read test\n"
+            "\t\tblock size: 65536\n"
+            "\t\tusing random I/O (alignment: 65536)\n"
+            "\t\tnumber of outstanding I/O operations: 2\n"
+            "\t\tthread stride size: 0\n"
+            "\t\tusing FILE_FLAG_SEQUENTIAL_SCAN hint\n"
+            "\t\tusing I/O rings (IoRing)\n"
+            "\t\tIO priority: normal\n";
+        VERIFY_IS_TRUE(parser._sResult == pszExpectedResult);
+
+        parser._sResult = "";
+        parser._PrintTarget(target, false, true, false, false, true);
+        pszExpectedResult = "\tpath: ''\n" \
+            "\t\tthink time: 0ms\n"
+            "\t\tburst size: 0\n"
+            "\t\tlocal software cache disabled, remote cache enabled\n"
+            "\t\tusing hardware write cache, writethrough off\n"
+            "\t\twrite buffer size: 12341234\n"
+            "\t\twrite buffer source: 'x:\\foo\\bar.dat'\n"
+            "\t\tperforming read test\n"
+            "\t\tblock size: 65536\n"
+            "\t\tusing random I/O (alignment: 65536)\n"
+            "\t\tnumber of outstanding I/O operations: 2\n"
+            "\t\tthread stride size: 0\n"
+            "\t\tusing FILE_FLAG_SEQUENTIAL_SCAN hint\n"
+            "\t\tusing per-I/O events\n"
+            "\t\tIO priority: normal\n";
+        VERIFY_IS_TRUE(parser._sResult == pszExpectedResult);
     }
 }
@@ -854,4 +854,338 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(vTargets[1].GetWeight(), (UINT32)100);
         VERIFY_ARE_EQUAL(vTargets[1].GetThreadTargets().size(), (size_t)0);
     }
+
+    void XmlProfileParserUnitTests::Test_ParseFileIoRing()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <CompletionRoutines>false</CompletionRoutines>\n"
+                       "            <IoRing>true</IoRing>\n"
+                       "            <IoRingSubmissionPoller>true</IoRingSubmissionPoller>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        VERIFY_IS_TRUE(vTimespans[0].GetIoRing() == true);
+        VERIFY_IS_TRUE(vTimespans[0].GetIoRingSubmissionPoller() == true);
+        VERIFY_IS_TRUE(vTimespans[0].GetCompletionRoutines() == false);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFilePollCompletions()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <PollCompletions>true</PollCompletions>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                    <DisableOSCache>true</DisableOSCache>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        VERIFY_IS_TRUE(vTimespans[0].GetPollCompletions() == true);
+        VERIFY_IS_TRUE(vTimespans[0].GetIoRing() == false);
+        VERIFY_IS_TRUE(vTimespans[0].GetTargets()[0].GetCacheMode() == TargetCacheMode::DisableOSCache);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileSeparateReaper()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <SeparateReaper>true</SeparateReaper>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        VERIFY_IS_TRUE(vTimespans[0].GetSeparateReaper() == true);
+        VERIFY_IS_TRUE(vTimespans[0].GetCompletionRoutines() == false);
+        VERIFY_IS_TRUE(vTimespans[0].GetXml().find("<SeparateReaper>true</SeparateReaper>") != string::npos);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileCompletionPool()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <CompletionPoolThreads>3</CompletionPoolThreads>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vTimespans[0].GetCompletionPoolThreadCount(), (DWORD)3);
+        VERIFY_IS_TRUE(vTimespans[0].GetSeparateReaper() == false);
+        VERIFY_IS_TRUE(vTimespans[0].GetXml().find("<CompletionPoolThreads>3</CompletionPoolThreads>") != string::npos);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileBlockSizeDistribution()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                    <ReadBlockSizes>\n"
+                       "                        <BlockSizeWeight>\n"
+                       "                            <BlockSize>4096</BlockSize>\n"
+                       "                            <Weight>60</Weight>\n"
+                       "                        </BlockSizeWeight>\n"
+                       "                        <BlockSizeWeight>\n"
+                       "                            <BlockSize>1048576</BlockSize>\n"
+                       "                            <Weight>40</Weight>\n"
+                       "                        </BlockSizeWeight>\n"
+                       "                    </ReadBlockSizes>\n"
+                       "                    <WriteBlockSizes>\n"
+                       "                        <BlockSizeWeight>\n"
+                       "                            <BlockSize>65536</BlockSize>\n"
+                       "                            <Weight>1</Weight>\n"
+                       "                        </BlockSizeWeight>\n"
+                       "                    </WriteBlockSizes>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+
+        const auto& vReadBlockSizes = vTargets[0].GetBlockSizeWeights(IOOperation::ReadIO);
+        VERIFY_ARE_EQUAL(vReadBlockSizes.size(), (size_t)2);
+        VERIFY_ARE_EQUAL(vReadBlockSizes[0].dwBlockSize, (DWORD)4096);
+        VERIFY_ARE_EQUAL(vReadBlockSizes[0].ulWeight, (UINT32)60);
+        VERIFY_ARE_EQUAL(vReadBlockSizes[1].dwBlockSize, (DWORD)1048576);
+        VERIFY_ARE_EQUAL(vReadBlockSizes[1].ulWeight, (UINT32)40);
+
+        const auto& vWriteBlockSizes = vTargets[0].GetBlockSizeWeights(IOOperation::WriteIO);
+        VERIFY_ARE_EQUAL(vWriteBlockSizes.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vWriteBlockSizes[0].dwBlockSize, (DWORD)65536);
+        VERIFY_ARE_EQUAL(vTargets[0].GetMaxBlockSizeInBytes(), (DWORD)1048576);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileRandomDistribution()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile1.dat</Path>\n"
+                       "                    <Random>4096</Random>\n"
+                       "                    <Distribution>\n"
+                       "                        <Percent>\n"
+                       "                            <Range IO=\"90\">10</Range>\n"
+                       "                            <Range IO=\"5\">20</Range>\n"
+                       "                        </Percent>\n"
+                       "                    </Distribution>\n"
+                       "                </Target>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile2.dat</Path>\n"
+                       "                    <Random>4096</Random>\n"
+                       "                    <Distribution>\n"
+                       "                        <Normal>\n"
+                       "                            <Center>25</Center>\n"
+                       "                            <StdDev>2.5</StdDev>\n"
+                       "                        </Normal>\n"
+                       "                    </Distribution>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)2);
+
+        VERIFY_IS_TRUE(vTargets[0].GetRandomDistribution() == DistributionType::Percent);
+        const auto& vRanges = vTargets[0].GetDistributionRanges();
+        VERIFY_ARE_EQUAL(vRanges.size(), (size_t)2);
+        VERIFY_ARE_EQUAL(vRanges[0].ulIoPercent, (UINT32)90);
+        VERIFY_ARE_EQUAL(vRanges[0].ulTargetPercent, (UINT32)10);
+        VERIFY_ARE_EQUAL(vRanges[1].ulIoPercent, (UINT32)5);
+        VERIFY_ARE_EQUAL(vRanges[1].ulTargetPercent, (UINT32)20);
+        VERIFY_IS_TRUE(vTargets[0].GetXml().find("<Distribution>\n<Percent>\n<Range IO=\"90\">10</Range>\n<Range IO=\"5\">20</Range>\n</Percent>\n</Distribution>\n") != string::npos);
+
+        VERIFY_IS_TRUE(vTargets[1].GetRandomDistribution() == DistributionType::Normal);
+        VERIFY_ARE_EQUAL(vTargets[1].GetNormalCenterPercent(), 25.0);
+        VERIFY_ARE_EQUAL(vTargets[1].GetNormalStdDevPercent(), 2.5);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileBatchSize()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <BatchSize>8</BatchSize>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vTimespans[0].GetBatchSize(), (DWORD)8);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileLookahead()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <LookaheadDepth>256</LookaheadDepth>\n"
+                       "            <LookaheadDumpPath>offsets.csv</LookaheadDumpPath>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vTimespans[0].GetLookaheadDepth(), (DWORD)256);
+        VERIFY_IS_TRUE(vTimespans[0].GetLookaheadDumpPath().compare("offsets.csv") == 0);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileWaitStrategy()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <WaitStrategy>SpinThenBlock</WaitStrategy>\n"
+                       "            <SpinBudget>20</SpinBudget>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "        <TimeSpan>\n"
+                       "            <WaitStrategy>Poll</WaitStrategy>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path>testfile.dat</Path>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, _hModule));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)2);
+        VERIFY_IS_TRUE(vTimespans[0].GetWaitStrategy() == WaitStrategy::SpinThenBlock);
+        VERIFY_ARE_EQUAL(vTimespans[0].GetSpinBudgetInMicroseconds(), (DWORD)20);
+        VERIFY_IS_TRUE(vTimespans[1].GetWaitStrategy() == WaitStrategy::Poll);
+    }
 }
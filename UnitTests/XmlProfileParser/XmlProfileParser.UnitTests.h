@@ -64,6 +64,15 @@ namespace UnitTests
         TEST_METHOD(Test_ParseFileWriteBufferContentRandomNoFilePath);
         TEST_METHOD(Test_ParseFileWriteBufferContentRandomWithFilePath);
         TEST_METHOD(Test_ParseFileGlobalRequestCount);
+        TEST_METHOD(Test_ParseFileIoRing);
+        TEST_METHOD(Test_ParseFilePollCompletions);
+        TEST_METHOD(Test_ParseFileBatchSize);
+        TEST_METHOD(Test_ParseFileLookahead);
+        TEST_METHOD(Test_ParseFileWaitStrategy);
+        TEST_METHOD(Test_ParseFileSeparateReaper);
+        TEST_METHOD(Test_ParseFileCompletionPool);
+        TEST_METHOD(Test_ParseFileBlockSizeDistribution);
+        TEST_METHOD(Test_ParseFileRandomDistribution);
 
         // TODO: test what happens when parameters have suffixes (e.g. 1M)
     private:
@@ -514,6 +514,71 @@ HRESULT XmlProfileParser::_ParseTimeSpan(IXMLDOMNode *pXmlNode, TimeSpan *pTimeS
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulBatchSize;
+        hr = _GetUINT32(pXmlNode, "BatchSize", &ulBatchSize);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetBatchSize(ulBatchSize);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulLookaheadDepth;
+        hr = _GetUINT32(pXmlNode, "LookaheadDepth", &ulLookaheadDepth);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetLookaheadDepth(ulLookaheadDepth);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        string sLookaheadDumpPath;
+        hr = _GetString(pXmlNode, "LookaheadDumpPath", &sLookaheadDumpPath);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetLookaheadDumpPath(sLookaheadDumpPath);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        string sWaitStrategy;
+        hr = _GetString(pXmlNode, "WaitStrategy", &sWaitStrategy);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            if (sWaitStrategy == "Block")
+            {
+                pTimeSpan->SetWaitStrategy(WaitStrategy::Block);
+            }
+            else if (sWaitStrategy == "Poll")
+            {
+                pTimeSpan->SetWaitStrategy(WaitStrategy::Poll);
+            }
+            else if (sWaitStrategy == "SpinThenBlock")
+            {
+                pTimeSpan->SetWaitStrategy(WaitStrategy::SpinThenBlock);
+            }
+            else
+            {
+                hr = E_INVALIDARG;
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulSpinBudget;
+        hr = _GetUINT32(pXmlNode, "SpinBudget", &ulSpinBudget);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetSpinBudgetInMicroseconds(ulSpinBudget);
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fDisableAffinity;
@@ -534,6 +599,66 @@ HRESULT XmlProfileParser::_ParseTimeSpan(IXMLDOMNode *pXmlNode, TimeSpan *pTimeS
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        bool fIoRing;
+        hr = _GetBool(pXmlNode, "IoRing", &fIoRing);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetIoRing(fIoRing);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fIoRingSubmissionPoller;
+        hr = _GetBool(pXmlNode, "IoRingSubmissionPoller", &fIoRingSubmissionPoller);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetIoRingSubmissionPoller(fIoRingSubmissionPoller);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fEventCompletions;
+        hr = _GetBool(pXmlNode, "EventCompletions", &fEventCompletions);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetEventCompletions(fEventCompletions);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fPollCompletions;
+        hr = _GetBool(pXmlNode, "PollCompletions", &fPollCompletions);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetPollCompletions(fPollCompletions);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fSeparateReaper;
+        hr = _GetBool(pXmlNode, "SeparateReaper", &fSeparateReaper);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetSeparateReaper(fSeparateReaper);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulCompletionPoolThreads;
+        hr = _GetUINT32(pXmlNode, "CompletionPoolThreads", &ulCompletionPoolThreads);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetCompletionPoolThreadCount(ulCompletionPoolThreads);
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fMeasureLatency;
@@ -726,6 +851,41 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwStreams;
+        hr = _GetDWORD(pXmlNode, "SequentialStreams", &dwStreams);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetSequentialStreamCount(dwStreams);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fReverseSequential;
+        hr = _GetBool(pXmlNode, "ReverseSequential", &fReverseSequential);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetUseReverseSequential(fReverseSequential);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwReadRun;
+        hr = _GetDWORD(pXmlNode, "SequentialSkip/Read", &dwReadRun);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            DWORD dwSkipRun;
+            hr = _GetDWORD(pXmlNode, "SequentialSkip/Skip", &dwSkipRun);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                pTarget->SetSequentialSkip(dwReadRun, dwSkipRun);
+            }
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         UINT64 ullBaseFileOffset;
@@ -797,6 +957,41 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        bool fRandomPermutation;
+        hr = _GetBool(pXmlNode, "RandomPermutation", &fRandomPermutation);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetUseRandomPermutation(fRandomPermutation);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwRandomRatio;
+        hr = _GetDWORD(pXmlNode, "RandomRatio", &dwRandomRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetRandomRatio(dwRandomRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwMinRun;
+        hr = _GetDWORD(pXmlNode, "SequentialRunLength/Min", &dwMinRun);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            DWORD dwMaxRun;
+            hr = _GetDWORD(pXmlNode, "SequentialRunLength/Max", &dwMaxRun);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                pTarget->SetSequentialRunLength(dwMinRun, dwMaxRun);
+            }
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fBool;
@@ -941,6 +1136,21 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        string sPlugin;
+        hr = _GetString(pXmlNode, "AccessPattern/Plugin", &sPlugin);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            string sParameters;
+            hr = _GetString(pXmlNode, "AccessPattern/Parameters", &sParameters);
+            if (SUCCEEDED(hr))
+            {
+                pTarget->SetAccessPatternPlugin(sPlugin, sParameters);
+            }
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         UINT32 ulWriteRatio;
@@ -951,6 +1161,188 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulTrimRatio;
+        hr = _GetUINT32(pXmlNode, "TrimRatio", &ulTrimRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetTrimRatio(ulTrimRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulWriteZeroesRatio;
+        hr = _GetUINT32(pXmlNode, "WriteZeroesRatio", &ulWriteZeroesRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetWriteZeroesRatio(ulWriteZeroesRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulDurableWriteRatio;
+        hr = _GetUINT32(pXmlNode, "DurableWriteRatio", &ulDurableWriteRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetDurableWriteRatio(ulDurableWriteRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulFlushIoInterval;
+        hr = _GetUINT32(pXmlNode, "Flush/IoInterval", &ulFlushIoInterval);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFlushIoInterval(ulFlushIoInterval);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulFlushTimeInterval;
+        hr = _GetUINT32(pXmlNode, "Flush/TimeInterval", &ulFlushTimeInterval);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFlushTimeIntervalInMilliseconds(ulFlushTimeInterval);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulFlushRatio;
+        hr = _GetUINT32(pXmlNode, "Flush/Ratio", &ulFlushRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFlushRatio(ulFlushRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fFlushDataOnly;
+        hr = _GetBool(pXmlNode, "Flush/DataOnly", &fFlushDataOnly);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFlushDataOnly(fFlushDataOnly);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fAppend;
+        hr = _GetBool(pXmlNode, "Append", &fAppend);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetUseAppend(fAppend);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT64 ullAppendPreallocationSize;
+        hr = _GetUINT64(pXmlNode, "AppendPreallocationSize", &ullAppendPreallocationSize);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetAppendPreallocationSizeInBytes(ullAppendPreallocationSize);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT64 ullAppendSegmentSize;
+        hr = _GetUINT64(pXmlNode, "AppendSegmentSize", &ullAppendSegmentSize);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetAppendSegmentSizeInBytes(ullAppendSegmentSize);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulCommitterCount;
+        hr = _GetUINT32(pXmlNode, "GroupCommit/Committers", &ulCommitterCount);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetCommitterCount(ulCommitterCount);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwCommitRecordSize;
+        hr = _GetDWORD(pXmlNode, "GroupCommit/RecordSize", &dwCommitRecordSize);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetCommitRecordSizeInBytes(dwCommitRecordSize);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulCommitThinkTime;
+        hr = _GetUINT32(pXmlNode, "GroupCommit/ThinkTime", &ulCommitThinkTime);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetCommitThinkTimeInMicroseconds(ulCommitThinkTime);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fMetadata;
+        hr = _GetBool(pXmlNode, "Metadata", &fMetadata);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetUseMetadata(fMetadata);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulMetadataFanout;
+        hr = _GetUINT32(pXmlNode, "MetadataFanout", &ulMetadataFanout);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetMetadataFanout(ulMetadataFanout);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulMetadataDepth;
+        hr = _GetUINT32(pXmlNode, "MetadataDepth", &ulMetadataDepth);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetMetadataDepth(ulMetadataDepth);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulMetadataFiles;
+        hr = _GetUINT32(pXmlNode, "MetadataFilesPerDirectory", &ulMetadataFiles);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetMetadataFilesPerDirectory(ulMetadataFiles);
+        }
+    }
+
+    for (size_t i = 0; SUCCEEDED(hr) && i < METADATA_OPERATION_COUNT; i++)
+    {
+        MetadataOperation op = static_cast<MetadataOperation>(i);
+        string sQuery = string("MetadataWeights/") + MetadataTree::GetOperationName(op);
+        UINT32 ulWeight;
+        hr = _GetUINT32(pXmlNode, sQuery.c_str(), &ulWeight);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetMetadataWeight(op, ulWeight);
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fParallelAsyncIO;
@@ -996,6 +1388,21 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
     {
         hr = _ParseThreadTargets(pXmlNode, pTarget);
     }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseBlockSizeWeights(pXmlNode, "ReadBlockSizes/BlockSizeWeight", IOOperation::ReadIO, pTarget);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseBlockSizeWeights(pXmlNode, "WriteBlockSizes/BlockSizeWeight", IOOperation::WriteIO, pTarget);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseDistribution(pXmlNode, pTarget);
+    }
     return hr;
 }
 
@@ -1047,6 +1454,165 @@ HRESULT XmlProfileParser::_ParseThreadTarget(IXMLDOMNode *pXmlNode, ThreadTarget
     return hr;
 }
 
+HRESULT XmlProfileParser::_ParseBlockSizeWeights(IXMLDOMNode *pXmlNode, const char *pszQuery, IOOperation ioType, Target *pTarget)
+{
+    CComVariant query(pszQuery);
+    CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
+    HRESULT hr = pXmlNode->selectNodes(query.bstrVal, &spNodeList);
+    if (SUCCEEDED(hr))
+    {
+        long cNodes;
+        hr = spNodeList->get_length(&cNodes);
+        if (SUCCEEDED(hr))
+        {
+            for (int i = 0; i < cNodes; i++)
+            {
+                CComPtr<IXMLDOMNode> spNode = nullptr;
+                hr = spNodeList->get_item(i, &spNode);
+                if (SUCCEEDED(hr))
+                {
+                    DWORD dwBlockSize = 0;
+                    UINT32 ulWeight = 0;
+                    hr = _GetDWORD(spNode, "BlockSize", &dwBlockSize);
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = _GetUINT32(spNode, "Weight", &ulWeight);
+                    }
+                    if (SUCCEEDED(hr))
+                    {
+                        pTarget->AddBlockSizeWeight(ioType, dwBlockSize, ulWeight);
+                    }
+                }
+            }
+        }
+    }
+    return hr;
+}
+
+HRESULT XmlProfileParser::_ParseDistribution(IXMLDOMNode *pXmlNode, Target *pTarget)
+{
+    CComVariant query("Distribution/Percent/Range");
+    CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
+    HRESULT hr = pXmlNode->selectNodes(query.bstrVal, &spNodeList);
+    if (SUCCEEDED(hr))
+    {
+        long cNodes;
+        hr = spNodeList->get_length(&cNodes);
+        if (SUCCEEDED(hr) && cNodes > 0)
+        {
+            pTarget->SetRandomDistribution(DistributionType::Percent);
+            for (int i = 0; i < cNodes; i++)
+            {
+                CComPtr<IXMLDOMNode> spNode = nullptr;
+                hr = spNodeList->get_item(i, &spNode);
+                if (SUCCEEDED(hr))
+                {
+                    UINT32 ulIoPercent = 0;
+                    UINT32 ulTargetPercent = 0;
+                    hr = _GetUINT32Attr(spNode, "IO", &ulIoPercent);
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = _GetUINT32(spNode, ".", &ulTargetPercent);
+                    }
+                    if (SUCCEEDED(hr))
+                    {
+                        pTarget->AddDistributionRange(ulIoPercent, ulTargetPercent);
+                    }
+                }
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        CComVariant queryAbsolute("Distribution/Absolute/Range");
+        CComPtr<IXMLDOMNodeList> spAbsoluteNodeList = nullptr;
+        hr = pXmlNode->selectNodes(queryAbsolute.bstrVal, &spAbsoluteNodeList);
+        if (SUCCEEDED(hr))
+        {
+            long cNodes;
+            hr = spAbsoluteNodeList->get_length(&cNodes);
+            if (SUCCEEDED(hr) && cNodes > 0)
+            {
+                pTarget->SetRandomDistribution(DistributionType::Absolute);
+                for (int i = 0; i < cNodes; i++)
+                {
+                    CComPtr<IXMLDOMNode> spNode = nullptr;
+                    hr = spAbsoluteNodeList->get_item(i, &spNode);
+                    if (SUCCEEDED(hr))
+                    {
+                        UINT32 ulIoPercent = 0;
+                        UINT64 ullTargetBytes = 0;
+                        hr = _GetUINT32Attr(spNode, "IO", &ulIoPercent);
+                        if (SUCCEEDED(hr))
+                        {
+                            hr = _GetUINT64(spNode, ".", &ullTargetBytes);
+                        }
+                        if (SUCCEEDED(hr))
+                        {
+                            pTarget->AddDistributionRangeInBytes(ulIoPercent, ullTargetBytes);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        double lfTheta;
+        hr = _GetDouble(pXmlNode, "Distribution/Zipf", &lfTheta);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetRandomDistribution(DistributionType::Zipf);
+            pTarget->SetZipfTheta(lfTheta);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulHotPercent;
+        hr = _GetUINT32(pXmlNode, "Distribution/Pareto", &ulHotPercent);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetRandomDistribution(DistributionType::Pareto);
+            pTarget->SetParetoHotPercent(ulHotPercent);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        double lfCenter;
+        hr = _GetDouble(pXmlNode, "Distribution/Normal/Center", &lfCenter);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetRandomDistribution(DistributionType::Normal);
+            pTarget->SetNormalCenterPercent(lfCenter);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        double lfStdDev;
+        hr = _GetDouble(pXmlNode, "Distribution/Normal/StdDev", &lfStdDev);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetNormalStdDevPercent(lfStdDev);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT64 ullDrift;
+        hr = _GetUINT64(pXmlNode, "Distribution/Drift", &ullDrift);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetDistributionDrift(ullDrift);
+        }
+    }
+    return hr;
+}
+
 // Compatibility with the old, non-group aware affinity assignment. Preserved to allow downlevel XML profiles
 // to run without modification.
 // Any assignment done through this method will only assign within group 0, and is equivalent to the non-group
@@ -1193,6 +1759,24 @@ HRESULT XmlProfileParser::_GetUINT32(IXMLDOMNode *pXmlNode, const char *pszQuery
     return hr;
 }
 
+HRESULT XmlProfileParser::_GetDouble(IXMLDOMNode *pXmlNode, const char *pszQuery, double *plfValue) const
+{
+    CComPtr<IXMLDOMNode> spNode = nullptr;
+    CComVariant query(pszQuery);
+    HRESULT hr = pXmlNode->selectSingleNode(query.bstrVal, &spNode);
+    if (SUCCEEDED(hr) && (hr != S_FALSE))
+    {
+        BSTR bstrText;
+        hr = spNode->get_text(&bstrText);
+        if (SUCCEEDED(hr))
+        {
+            *plfValue = _wtof((wchar_t *)bstrText);
+            SysFreeString(bstrText);
+        }
+    }
+    return hr;
+}
+
 HRESULT XmlProfileParser::_GetUINT32Attr(IXMLDOMNode *pXmlNode, const char *pszAttr, UINT32 *pulValue) const
 {
     CComPtr<IXMLDOMNamedNodeMap> spNamedNodeMap = nullptr;
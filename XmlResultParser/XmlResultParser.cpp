@@ -127,6 +127,38 @@ void XmlResultParser::_OutputTargetResults(const TargetResults& results,
     _OutputValue("ReadCount", results.ullReadIOCount);
     _OutputValue("WriteBytes", results.ullWriteBytesCount);
     _OutputValue("WriteCount", results.ullWriteIOCount);
+    if (results.ullTrimIOCount != 0)
+    {
+        _OutputValue("TrimBytes", results.ullTrimBytesCount);
+        _OutputValue("TrimCount", results.ullTrimIOCount);
+    }
+    if (results.ullWriteZeroesIOCount != 0)
+    {
+        _OutputValue("WriteZeroesBytes", results.ullWriteZeroesBytesCount);
+        _OutputValue("WriteZeroesCount", results.ullWriteZeroesIOCount);
+    }
+    if (results.ullDurableWriteIOCount != 0)
+    {
+        _OutputValue("DurableWriteBytes", results.ullDurableWriteBytesCount);
+        _OutputValue("DurableWriteCount", results.ullDurableWriteIOCount);
+    }
+    if (results.ullFlushCount != 0)
+    {
+        _OutputValue("FlushCount", results.ullFlushCount);
+    }
+    if (results.ullCommitCount != 0)
+    {
+        _OutputValue("CommitCount", results.ullCommitCount);
+        _OutputValue("CommitGroupCount", results.ullCommitGroupCount);
+    }
+    for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+    {
+        if (results.vullMetadataOperationCounts[i] != 0)
+        {
+            _OutputValue(string(MetadataTree::GetOperationName(static_cast<MetadataOperation>(i))) + "Count",
+                         results.vullMetadataOperationCounts[i]);
+        }
+    }
     if (fMeasureLatency)
     {
         /************************************************************************************************************************
@@ -135,13 +167,69 @@ void XmlResultParser::_OutputTargetResults(const TargetResults& results,
         Histogram<float> totalLatencyHistogram;
         totalLatencyHistogram.Merge(results.writeLatencyHistogram);
         totalLatencyHistogram.Merge(results.readLatencyHistogram);
+        totalLatencyHistogram.Merge(results.trimLatencyHistogram);
+        totalLatencyHistogram.Merge(results.writeZeroesLatencyHistogram);
 
         _OutputLatencySummary(results.readLatencyHistogram, results.writeLatencyHistogram, totalLatencyHistogram, histogramBucketList, fTestDurationInSeconds);
+
+        // trims and write-zeroes only get their summaries; the percentiles keep to reads and writes
+        if (results.trimLatencyHistogram.GetSampleSize() > 0)
+        {
+            _OutputLatencySummary(results.trimLatencyHistogram, "Trim");
+        }
+
+        if (results.writeZeroesLatencyHistogram.GetSampleSize() > 0)
+        {
+            _OutputLatencySummary(results.writeZeroesLatencyHistogram, "WriteZeroes");
+        }
+
+        // durable writes are also in the write summary; flushes are not I/O and are in no other summary
+        if (results.durableWriteLatencyHistogram.GetSampleSize() > 0)
+        {
+            _OutputLatencySummary(results.durableWriteLatencyHistogram, "DurableWrite");
+        }
+
+        if (results.flushLatencyHistogram.GetSampleSize() > 0)
+        {
+            _OutputLatencySummary(results.flushLatencyHistogram, "Flush");
+        }
+
+        // commit latency is as the committers see it, from queueing the record to its release
+        if (results.commitLatencyHistogram.GetSampleSize() > 0)
+        {
+            _OutputLatencySummary(results.commitLatencyHistogram, "Commit");
+        }
+
+        for (size_t i = 0; i < METADATA_OPERATION_COUNT; i++)
+        {
+            if (results.vMetadataLatencyHistograms[i].GetSampleSize() > 0)
+            {
+                _OutputLatencySummary(results.vMetadataLatencyHistograms[i],
+                                      MetadataTree::GetOperationName(static_cast<MetadataOperation>(i)));
+            }
+        }
+
+        for (size_t i = 0; i < results.vBlockSizes.size(); i++)
+        {
+            const Histogram<float>& readLatencyHistogram = results.vReadBlockSizeLatencyHistograms[i];
+            const Histogram<float>& writeLatencyHistogram = results.vWriteBlockSizeLatencyHistograms[i];
+
+            Histogram<float> blockSizeLatencyHistogram;
+            blockSizeLatencyHistogram.Merge(writeLatencyHistogram);
+            blockSizeLatencyHistogram.Merge(readLatencyHistogram);
+
+            _Output("<BlockSizeLatency>\n");
+            _OutputValue("BlockSize", results.vBlockSizes[i]);
+            _OutputValue("ReadCount", readLatencyHistogram.GetSampleSize());
+            _OutputValue("WriteCount", writeLatencyHistogram.GetSampleSize());
+            _OutputLatencySummary(readLatencyHistogram, writeLatencyHistogram, blockSizeLatencyHistogram, nullptr, fTestDurationInSeconds);
+            _Output("</BlockSizeLatency>\n");
+        }
     }
 
     if (fCalculateIopsStdDev)
     {
-        _OutputTargetIops(results.readBucketizer, results.writeBucketizer, _ulIoBucketDurationInMilliseconds);
+        _OutputTargetIops(results.readBucketizer, results.writeBucketizer, results.trimBucketizer, results.writeZeroesBucketizer, _ulIoBucketDurationInMilliseconds);
     }
 }
 
@@ -186,6 +274,8 @@ void XmlResultParser::_OutputLatencySummary(const Histogram<float>& latencyHisto
 
 void XmlResultParser::_OutputTargetIops(const IoBucketizer& readBucketizer,
                                         const IoBucketizer& writeBucketizer,
+                                        const IoBucketizer& trimBucketizer,
+                                        const IoBucketizer& writeZeroesBucketizer,
                                         UINT32 bucketTimeInMs)
 {
     _Output("<Iops>\n");
@@ -193,6 +283,8 @@ void XmlResultParser::_OutputTargetIops(const IoBucketizer& readBucketizer,
     IoBucketizer totalIoBucketizer;
     totalIoBucketizer.Merge(readBucketizer);
     totalIoBucketizer.Merge(writeBucketizer);
+    totalIoBucketizer.Merge(trimBucketizer);
+    totalIoBucketizer.Merge(writeZeroesBucketizer);
 
     if (readBucketizer.GetNumberOfValidBuckets() > 0)
     {
@@ -202,6 +294,14 @@ void XmlResultParser::_OutputTargetIops(const IoBucketizer& readBucketizer,
     {
         _OutputValueMilliseconds("WriteIopsStdDev", writeBucketizer.GetStandardDeviationIOPS() / (bucketTimeInMs / 1000.0));
     }
+    if (trimBucketizer.GetNumberOfValidBuckets() > 0)
+    {
+        _OutputValueMilliseconds("TrimIopsStdDev", trimBucketizer.GetStandardDeviationIOPS() / (bucketTimeInMs / 1000.0));
+    }
+    if (writeZeroesBucketizer.GetNumberOfValidBuckets() > 0)
+    {
+        _OutputValueMilliseconds("WriteZeroesIopsStdDev", writeZeroesBucketizer.GetStandardDeviationIOPS() / (bucketTimeInMs / 1000.0));
+    }
     if (totalIoBucketizer.GetNumberOfValidBuckets() > 0)
     {
         _OutputValueMilliseconds("IopsStdDev", totalIoBucketizer.GetStandardDeviationIOPS() / (bucketTimeInMs / 1000.0));
@@ -380,6 +480,29 @@ void XmlResultParser::_OutputCpuUtilization(const Results& results,
     _Output("</CpuUtilization>\n");
 }
 
+void XmlResultParser::_OutputThreadCpuUtilization(const char *pszElement, UINT64 ullUserTime, UINT64 ullKernelTime, double fTime)
+{
+    // thread CPU time is in 100ns units; usage is relative to a single CPU
+    double userTime = 100.0 * ullUserTime / (fTime * 10000000.0);
+    double krnlTime = 100.0 * ullKernelTime / (fTime * 10000000.0);
+
+    _Output("<%s>\n", pszElement);
+    _OutputValueInPercent("Usage", userTime + krnlTime);
+    _OutputValueInPercent("User", userTime);
+    _OutputValueInPercent("Kernel", krnlTime);
+    _Output("</%s>\n", pszElement);
+}
+
+void XmlResultParser::_OutputBatching(const ThreadResults& threadResults)
+{
+    _Output("<Batching>\n");
+    _OutputValue("SubmitCalls", threadResults.ullSubmitCalls);
+    _OutputValue("AverageSubmitBatch", (threadResults.ullSubmitCalls > 0) ? (double)threadResults.ullSubmittedIOs / threadResults.ullSubmitCalls : 0.0, "%.2f");
+    _OutputValue("ReapCalls", threadResults.ullReapCalls);
+    _OutputValue("AverageReapBatch", (threadResults.ullReapCalls > 0) ? (double)threadResults.ullReapedIOs / threadResults.ullReapCalls : 0.0, "%.2f");
+    _Output("</Batching>\n");
+}
+
 // emit the iops time series (this obviates needing perfmon counters, in common cases, and provides file level data)
 void XmlResultParser::_OutputIops(const IoBucketizer& readBucketizer,
                                   const IoBucketizer& writeBucketizer,
@@ -437,6 +560,8 @@ void XmlResultParser::_OutputOverallIops(const Results& results,
 {
     IoBucketizer readBucketizer;
     IoBucketizer writeBucketizer;
+    IoBucketizer trimBucketizer;
+    IoBucketizer writeZeroesBucketizer;
 
     for (const auto& thread : results.vThreadResults)
     {
@@ -444,10 +569,12 @@ void XmlResultParser::_OutputOverallIops(const Results& results,
         {
             readBucketizer.Merge(target.readBucketizer);
             writeBucketizer.Merge(target.writeBucketizer);
+            trimBucketizer.Merge(target.trimBucketizer);
+            writeZeroesBucketizer.Merge(target.writeZeroesBucketizer);
         }
     }
 
-    _OutputTargetIops(readBucketizer, writeBucketizer, bucketTimeInMs);
+    _OutputTargetIops(readBucketizer, writeBucketizer, trimBucketizer, writeZeroesBucketizer, bucketTimeInMs);
 }
 
 void XmlResultParser::_OutputLatencyPercentiles(const Histogram<float>& readLatencyHistogram,
@@ -700,6 +827,27 @@ string XmlResultParser::ParseResults(Profile& profile,
                 _Output("<Thread>\n");
                 _OutputValue("Id", iThread);
 
+                if (timeSpan.GetPollCompletions() || timeSpan.GetWaitStrategy() != WaitStrategy::Undefined ||
+                    timeSpan.GetSeparateReaper() || timeSpan.GetCompletionPoolThreadCount() > 0)
+                {
+                    _OutputThreadCpuUtilization("Worker", threadResults.ullUserTime, threadResults.ullKernelTime, fTime);
+                }
+
+                if (timeSpan.GetIoRingSubmissionPoller())
+                {
+                    _OutputThreadCpuUtilization("SubmissionPoller", threadResults.ullHelperUserTime, threadResults.ullHelperKernelTime, fTime);
+                }
+
+                if (timeSpan.GetSeparateReaper())
+                {
+                    _OutputThreadCpuUtilization("Reaper", threadResults.ullHelperUserTime, threadResults.ullHelperKernelTime, fTime);
+                }
+
+                if (timeSpan.GetBatchSize() > 1)
+                {
+                    _OutputBatching(threadResults);
+                }
+
                 for (const auto& targetResults : threadResults.vTargetResults)
                 {
                     _Output("<Target>\n");
@@ -709,6 +857,18 @@ string XmlResultParser::ParseResults(Profile& profile,
                 }
                 _Output("</Thread>\n");
             }
+
+            for (size_t iThread = 0; iThread < results.vCompletionPoolResults.size(); iThread++)
+            {
+                const ThreadResults& threadResults = results.vCompletionPoolResults[iThread];
+
+                _Output("<CompletionPoolThread>\n");
+                _OutputValue("Id", iThread);
+                _OutputThreadCpuUtilization("CPU", threadResults.ullUserTime, threadResults.ullKernelTime, fTime);
+                _OutputValue("ReapCalls", threadResults.ullReapCalls);
+                _OutputValue("ReapedIOs", threadResults.ullReapedIOs);
+                _Output("</CompletionPoolThread>\n");
+            }
         }
         else
         {